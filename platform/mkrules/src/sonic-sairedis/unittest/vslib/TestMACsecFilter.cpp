@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MACsecFilter.h"
+
+#include <gtest/gtest.h>
+
+#include <linux/if_ether.h>
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+using namespace saivpp;
+
+class MACsecDeviceFilter:
+    public MACsecFilter
+{
+    public:
+
+        MACsecDeviceFilter():
+            MACsecFilter("macsec_eth0"),
+            m_deviceAlive(false),
+            m_forwarded(0),
+            m_forwardedToRemoved(0)
+        {
+        }
+
+        std::atomic<bool> m_deviceAlive;
+
+        std::atomic<uint64_t> m_forwarded;
+
+        std::atomic<uint64_t> m_forwardedToRemoved;
+
+    protected:
+
+        virtual FilterStatus forward(
+                _In_ const void *buffer,
+                _In_ size_t length) override
+        {
+            // forwarding to a removed MACsec device fails the packet thread
+
+            if (!m_deviceAlive.load(std::memory_order_relaxed))
+            {
+                m_forwardedToRemoved.fetch_add(1, std::memory_order_relaxed);
+
+                return TrafficFilter::ERROR;
+            }
+
+            m_forwarded.fetch_add(1, std::memory_order_relaxed);
+
+            return TrafficFilter::TERMINATE;
+        }
+};
+
+TEST(MACsecFilter, execute)
+{
+    MACsecDeviceFilter filter;
+
+    uint8_t packet[64] = {};
+    size_t length = sizeof(packet);
+
+    auto hdr = reinterpret_cast<ethhdr*>(packet);
+
+    hdr->h_proto = htons(0x888e);
+
+    EXPECT_EQ(filter.execute(packet, length), TrafficFilter::CONTINUE);
+
+    hdr->h_proto = htons(ETH_P_IP);
+
+    EXPECT_EQ(filter.execute(packet, length), TrafficFilter::TERMINATE);
+    EXPECT_EQ(filter.m_forwarded.load(), 0);
+
+    filter.m_deviceAlive = true;
+    filter.enable_macsec_device(true);
+
+    EXPECT_EQ(filter.execute(packet, length), TrafficFilter::TERMINATE);
+    EXPECT_EQ(filter.m_forwarded.load(), 1);
+
+    // failures of an enabled device are still reported
+
+    filter.m_deviceAlive = false;
+
+    EXPECT_EQ(filter.execute(packet, length), TrafficFilter::ERROR);
+    EXPECT_EQ(filter.m_forwardedToRemoved.load(), 1);
+}
+
+TEST(MACsecFilter, toggle_under_load)
+{
+    MACsecDeviceFilter filter;
+
+    std::atomic<bool> run(true);
+    std::atomic<uint64_t> errors(0);
+    std::atomic<uint64_t> packets(0);
+
+    std::thread packet_thread([&]()
+    {
+        uint8_t packet[64] = {};
+        size_t length = sizeof(packet);
+
+        reinterpret_cast<ethhdr*>(packet)->h_proto = htons(ETH_P_IP);
+
+        while (run.load(std::memory_order_relaxed))
+        {
+            if (filter.execute(packet, length) == TrafficFilter::ERROR)
+            {
+                errors++;
+            }
+
+            packets.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (int i = 0; i < 20000; i++)
+    {
+        filter.m_deviceAlive = true;
+        filter.enable_macsec_device(true);
+
+        // once disabled no packet thread is still forwarding, so the device
+        // can be removed
+
+        filter.enable_macsec_device(false);
+        filter.m_deviceAlive = false;
+    }
+
+    run = false;
+
+    packet_thread.join();
+
+    EXPECT_EQ(filter.m_forwardedToRemoved.load(), 0);
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_GT(packets.load(), 0);
+    EXPECT_GT(filter.m_forwarded.load(), 0);
+}
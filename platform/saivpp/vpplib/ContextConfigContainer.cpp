@@ -128,6 +128,21 @@ std::shared_ptr<ContextConfigContainer> ContextConfigContainer::loadFromFile(
 
                 auto sc = std::make_shared<SwitchConfig>(switchIndex, hwinfo);
 
+                if (sw.find("vpp_api_socket") != sw.end())
+                {
+                    sc->m_vppApiSocket = sw["vpp_api_socket"];
+                }
+
+                if (sw.find("vpp_stats_socket") != sw.end())
+                {
+                    sc->m_vppStatsSocket = sw["vpp_stats_socket"];
+                }
+
+                if (sw.find("vpp_punt_socket") != sw.end())
+                {
+                    sc->m_vppPuntSocket = sw["vpp_punt_socket"];
+                }
+
                 cc->insert(sc);
 
                 SWSS_LOG_NOTICE("insert into context '%s' config for hwinfo '%s'", cc->m_name.c_str(), hwinfo.c_str());
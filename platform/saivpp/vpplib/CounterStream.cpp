@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CounterStream.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <inttypes.h>
+#include <unordered_set>
+
+// shortest interval accepted, streaming below this costs more than it shows
+#define SAI_VPP_COUNTER_STREAM_MIN_INTERVAL_MS 100
+
+#define SAI_VPP_COUNTER_STREAM_DEFAULT_CPU_BUDGET 10
+
+// commands buffered before the pipeline is flushed to redis
+#define SAI_VPP_COUNTER_STREAM_BATCH 128
+
+#define SAI_VPP_COUNTERS_TABLE "COUNTERS"
+
+using namespace saivpp;
+
+CounterStream::CounterStream(
+        _In_ uint32_t intervalMs,
+        _In_ uint32_t maxObjectsPerSec,
+        _In_ uint32_t cpuBudgetPercent):
+    m_intervalMs(std::max(intervalMs, (uint32_t)SAI_VPP_COUNTER_STREAM_MIN_INTERVAL_MS)),
+    m_maxObjectsPerSec(maxObjectsPerSec),
+    m_cpuBudgetPercent(std::min(std::max(cpuBudgetPercent, 1u), 100u)),
+    m_next(0),
+    m_tokens(maxObjectsPerSec),
+    m_refillTime(std::chrono::steady_clock::now()),
+    m_throttled(false)
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("counter streaming every %u ms, %u objects/s (0 is unlimited), cpu budget %u%%",
+            m_intervalMs,
+            m_maxObjectsPerSec,
+            m_cpuBudgetPercent);
+}
+
+uint32_t CounterStream::parse(
+        _In_ const char *name,
+        _In_ const char *value,
+        _In_ uint32_t defaultValue)
+{
+    SWSS_LOG_ENTER();
+
+    if (value == nullptr)
+    {
+        return defaultValue;
+    }
+
+    uint32_t result;
+
+    if (sscanf(value, "%u", &result) != 1)
+    {
+        SWSS_LOG_WARN("failed to parse %s '%s' as uint32, using %u", name, value, defaultValue);
+
+        return defaultValue;
+    }
+
+    return result;
+}
+
+std::shared_ptr<CounterStream> CounterStream::create(
+        _In_ const char *interval,
+        _In_ const char *rateLimit,
+        _In_ const char *cpuBudget)
+{
+    SWSS_LOG_ENTER();
+
+    uint32_t intervalMs = parse("interval", interval, 0);
+
+    if (intervalMs == 0)
+    {
+        return nullptr;
+    }
+
+    return std::make_shared<CounterStream>(
+            intervalMs,
+            parse("rate limit", rateLimit, 0),
+            parse("cpu budget", cpuBudget, SAI_VPP_COUNTER_STREAM_DEFAULT_CPU_BUDGET));
+}
+
+uint32_t CounterStream::getInterval() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_intervalMs;
+}
+
+bool CounterStream::connect()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_table)
+    {
+        return true;
+    }
+
+    try
+    {
+        m_db = std::make_shared<swss::DBConnector>("COUNTERS_DB", 0);
+
+        m_pipeline = std::make_shared<swss::RedisPipeline>(m_db.get(), SAI_VPP_COUNTER_STREAM_BATCH);
+
+        m_table = std::make_shared<swss::Table>(m_pipeline.get(), SAI_VPP_COUNTERS_TABLE, true);
+    }
+    catch (const std::exception& e)
+    {
+        SWSS_LOG_ERROR("failed to connect to COUNTERS_DB: %s", e.what());
+
+        m_table = nullptr;
+        m_pipeline = nullptr;
+        m_db = nullptr;
+
+        return false;
+    }
+
+    return true;
+}
+
+void CounterStream::refill()
+{
+    SWSS_LOG_ENTER();
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed = now - m_refillTime;
+
+    m_refillTime = now;
+
+    // at most one second worth of burst
+
+    m_tokens = std::min((double)m_maxObjectsPerSec, m_tokens + elapsed.count() * m_maxObjectsPerSec);
+}
+
+size_t CounterStream::publish(
+        _In_ const std::vector<ObjectCounters>& counters)
+{
+    SWSS_LOG_ENTER();
+
+    if (counters.empty() || !connect())
+    {
+        return 0;
+    }
+
+    if (m_maxObjectsPerSec)
+    {
+        refill();
+    }
+
+    size_t written = 0;
+    size_t limited = 0;
+
+    if (m_next >= counters.size())
+    {
+        m_next = 0;
+    }
+
+    // a full pipeline flushes on set, so writes throw from the loop as well
+
+    try
+    {
+        for (size_t n = 0; n < counters.size(); n++)
+        {
+            size_t idx = (m_next + n) % counters.size();
+
+            auto& oc = counters[idx];
+
+            auto& last = m_written[oc.m_oid];
+
+            std::vector<swss::FieldValueTuple> fvs;
+
+            for (auto& c: oc.m_counters)
+            {
+                auto it = last.find(c.first);
+
+                if (it == last.end() || it->second != c.second)
+                {
+                    fvs.emplace_back(c.first, std::to_string(c.second));
+                }
+            }
+
+            if (fvs.empty())
+            {
+                continue;
+            }
+
+            if (m_maxObjectsPerSec && m_tokens < 1.0)
+            {
+                if (limited++ == 0)
+                {
+                    // start next cycle with the first object left out
+
+                    m_next = idx;
+                }
+
+                continue;
+            }
+
+            m_tokens -= 1.0;
+
+            for (auto& c: oc.m_counters)
+            {
+                last[c.first] = c.second;
+            }
+
+            m_table->set(sai_serialize_object_id(oc.m_oid), fvs);
+
+            written++;
+        }
+
+        m_table->flush();
+    }
+    catch (const std::exception& e)
+    {
+        SWSS_LOG_ERROR("failed to write counters to COUNTERS_DB: %s", e.what());
+
+        // reconnect and write everything again next cycle
+
+        m_table = nullptr;
+        m_pipeline = nullptr;
+        m_db = nullptr;
+
+        reset();
+
+        return 0;
+    }
+
+    if (limited == 0)
+    {
+        m_next = 0;
+    }
+
+    if ((limited != 0) != m_throttled)
+    {
+        m_throttled = (limited != 0);
+
+        SWSS_LOG_NOTICE("counter streaming %s rate limit of %u objects/s",
+                m_throttled ? "reached" : "back under",
+                m_maxObjectsPerSec);
+    }
+
+    // objects removed since, are not in counters anymore
+
+    std::unordered_set<sai_object_id_t> current;
+
+    for (auto& oc: counters)
+    {
+        current.insert(oc.m_oid);
+    }
+
+    for (auto it = m_written.begin(); it != m_written.end(); )
+    {
+        if (current.find(it->first) == current.end())
+        {
+            it = m_written.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return written;
+}
+
+uint32_t CounterStream::nextWaitMs(
+        _In_ std::chrono::nanoseconds wall,
+        _In_ std::chrono::nanoseconds cpu)
+{
+    SWSS_LOG_ENTER();
+
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(wall).count();
+    auto cpuMs = std::chrono::duration_cast<std::chrono::milliseconds>(cpu).count();
+
+    // a cycle must take at least cpu * 100 / budget wall time
+
+    int64_t period = std::max((int64_t)m_intervalMs, cpuMs * 100 / m_cpuBudgetPercent);
+
+    if (period > (int64_t)m_intervalMs)
+    {
+        SWSS_LOG_INFO("counter streaming cycle used %" PRId64 " ms cpu, over %u%% budget, next in %" PRId64 " ms",
+                cpuMs,
+                m_cpuBudgetPercent,
+                period);
+    }
+
+    return (uint32_t)std::max((int64_t)0, period - wallMs);
+}
+
+void CounterStream::reset()
+{
+    SWSS_LOG_ENTER();
+
+    m_written.clear();
+
+    m_next = 0;
+}
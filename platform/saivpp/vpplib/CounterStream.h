@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+extern "C" {
+#include "sai.h"
+}
+
+#include "swss/sal.h"
+#include "swss/dbconnector.h"
+#include "swss/redispipeline.h"
+#include "swss/table.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace saivpp
+{
+    /*
+     * Streaming mode for port counters. Counters collected from a stats
+     * snapshot are compared to the values last written, and only changed
+     * fields are written to COUNTERS_DB, in pipelined batches. Written
+     * objects per second and the CPU share of the collector thread are
+     * limited, when over budget the next cycle is delayed.
+     */
+    class CounterStream
+    {
+        public:
+
+            typedef struct _ObjectCounters
+            {
+                sai_object_id_t m_oid;
+
+                // serialized stat name, value
+                std::vector<std::pair<std::string, uint64_t>> m_counters;
+
+            } ObjectCounters;
+
+        public:
+
+            CounterStream(
+                    _In_ uint32_t intervalMs,
+                    _In_ uint32_t maxObjectsPerSec,
+                    _In_ uint32_t cpuBudgetPercent);
+
+            virtual ~CounterStream() = default;
+
+        public:
+
+            /*
+             * Returns nullptr if the interval key is not set or is 0,
+             * streaming is disabled then.
+             */
+            static std::shared_ptr<CounterStream> create(
+                    _In_ const char *interval,
+                    _In_ const char *rateLimit,
+                    _In_ const char *cpuBudget);
+
+            uint32_t getInterval() const;
+
+            /*
+             * Writes changed counters, returns number of objects written.
+             * Objects over the rate limit keep their changes for the next
+             * cycle, which starts after them.
+             */
+            size_t publish(
+                    _In_ const std::vector<ObjectCounters>& counters);
+
+            /*
+             * Time to wait before the next cycle, given wall and thread CPU
+             * time spent in the one that just ended.
+             */
+            uint32_t nextWaitMs(
+                    _In_ std::chrono::nanoseconds wall,
+                    _In_ std::chrono::nanoseconds cpu);
+
+            // forget written values, everything is written on the next cycle
+            void reset();
+
+        private:
+
+            static uint32_t parse(
+                    _In_ const char *name,
+                    _In_ const char *value,
+                    _In_ uint32_t defaultValue);
+
+            bool connect();
+
+            void refill();
+
+        private:
+
+            uint32_t m_intervalMs;
+
+            uint32_t m_maxObjectsPerSec;
+
+            uint32_t m_cpuBudgetPercent;
+
+            // values last written by object
+            std::unordered_map<sai_object_id_t, std::map<std::string, uint64_t>> m_written;
+
+            // first object of the next cycle, for fairness under the rate limit
+            size_t m_next;
+
+            double m_tokens;
+
+            std::chrono::steady_clock::time_point m_refillTime;
+
+            bool m_throttled;
+
+            std::shared_ptr<swss::DBConnector> m_db;
+
+            std::shared_ptr<swss::RedisPipeline> m_pipeline;
+
+            std::shared_ptr<swss::Table> m_table;
+    };
+}
@@ -33,6 +33,8 @@ namespace saivpp
 
         EVENT_TYPE_NOTIFICATION,
 
+        EVENT_TYPE_NET_LINK_MSG_BATCH,
+
     } EventType;
 
     class Event
@@ -24,12 +24,14 @@ EventPayloadNetLinkMsg::EventPayloadNetLinkMsg(
         _In_ int nlmsgType,
         _In_ int ifIndex,
         _In_ unsigned int ifFlags,
-        _In_ const std::string& ifName):
+        _In_ const std::string& ifName,
+        _In_ const std::string& ipAddress):
     m_switchId(switchId),
     m_nlmsgType(nlmsgType),
     m_ifIndex(ifIndex),
     m_ifFlags(ifFlags),
-    m_ifName(ifName)
+    m_ifName(ifName),
+    m_ipAddress(ipAddress)
 {
     SWSS_LOG_ENTER();
 
@@ -70,3 +72,10 @@ const std::string& EventPayloadNetLinkMsg::getIfName() const
 
     return m_ifName;
 }
+
+const std::string& EventPayloadNetLinkMsg::getIpAddress() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_ipAddress;
+}
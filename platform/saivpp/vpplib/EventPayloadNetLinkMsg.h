@@ -37,7 +37,8 @@ namespace saivpp
                     _In_ int nlmsgType,
                     _In_ int ifIndex,
                     _In_ unsigned int ifFlags,
-                    _In_ const std::string& ifName);
+                    _In_ const std::string& ifName,
+                    _In_ const std::string& ipAddress = std::string());
 
             virtual ~EventPayloadNetLinkMsg() = default;
 
@@ -53,6 +54,11 @@ namespace saivpp
 
             const std::string& getIfName() const;
 
+            /*
+             * Local address of RTM_NEWADDR messages, empty otherwise.
+             */
+            const std::string& getIpAddress() const;
+
         private:
 
             sai_object_id_t m_switchId;
@@ -64,5 +70,7 @@ namespace saivpp
             unsigned int m_ifFlags;
 
             std::string m_ifName;
+
+            std::string m_ipAddress;
     };
 }
@@ -1,6 +1,5 @@
 /*
- * Copyright 2016 Microsoft, Inc.
- * Modifications copyright (c) 2023 Cisco and/or its affiliates.
+ * Copyright (c) 2023 Cisco and/or its affiliates.
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at:
@@ -13,26 +12,24 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "MACsecFilterStateGuard.h"
+#include "EventPayloadNetLinkMsgBatch.h"
 
-#include <swss/logger.h>
+#include "swss/logger.h"
 
 using namespace saivpp;
 
-MACsecFilterStateGuard::MACsecFilterStateGuard(
-    _Inout_ MACsecFilter::MACsecFilterState &guarded_state,
-    _In_ MACsecFilter::MACsecFilterState target_state):
-    m_guarded_state(guarded_state)
+EventPayloadNetLinkMsgBatch::EventPayloadNetLinkMsgBatch(
+        _In_ const std::vector<std::shared_ptr<EventPayloadNetLinkMsg>>& msgs):
+    m_msgs(msgs)
 {
     SWSS_LOG_ENTER();
 
-    m_old_state = m_guarded_state;
-    m_guarded_state = target_state;
+    // empty
 }
 
-MACsecFilterStateGuard::~MACsecFilterStateGuard()
+const std::vector<std::shared_ptr<EventPayloadNetLinkMsg>>& EventPayloadNetLinkMsgBatch::getMessages() const
 {
     SWSS_LOG_ENTER();
 
-    m_guarded_state = m_old_state;
+    return m_msgs;
 }
@@ -1,6 +1,5 @@
 /*
- * Copyright 2016 Microsoft, Inc.
- * Modifications copyright (c) 2023 Cisco and/or its affiliates.
+ * Copyright (c) 2023 Cisco and/or its affiliates.
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at:
@@ -15,23 +14,29 @@
  */
 #pragma once
 
-#include "MACsecFilter.h"
+#include "EventPayloadNetLinkMsg.h"
+
+#include <memory>
+#include <vector>
 
 namespace saivpp
 {
-    class MACsecFilterStateGuard
+    class EventPayloadNetLinkMsgBatch:
+        public EventPayload
     {
         public:
 
-            MACsecFilterStateGuard(
-                    _Inout_ MACsecFilter::MACsecFilterState &guarded_state,
-                    _In_ MACsecFilter::MACsecFilterState target_state);
+            EventPayloadNetLinkMsgBatch(
+                    _In_ const std::vector<std::shared_ptr<EventPayloadNetLinkMsg>>& msgs);
+
+            virtual ~EventPayloadNetLinkMsgBatch() = default;
+
+        public:
 
-            ~MACsecFilterStateGuard();
+            const std::vector<std::shared_ptr<EventPayloadNetLinkMsg>>& getMessages() const;
 
         private:
 
-            MACsecFilter::MACsecFilterState m_old_state;
-            MACsecFilter::MACsecFilterState &m_guarded_state;
+            std::vector<std::shared_ptr<EventPayloadNetLinkMsg>> m_msgs;
     };
 }
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "GenetlinkChannel.h"
+
+#include "swss/logger.h"
+
+#include <netlink/netlink.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include <linux/psample.h>
+
+#include <sys/socket.h>
+#include <string.h>
+
+using namespace saivpp;
+
+#define SAI_VPP_GENETLINK_VERSION 1
+
+// stays below the default rmem of the listeners
+#define SAI_VPP_GENETLINK_BATCH_BYTES (64 * 1024)
+
+// multicast groups are addressed by bitmask in sockaddr_nl
+#define SAI_VPP_GENETLINK_MAX_GROUP 32
+
+static void put_attr(
+        _Inout_ std::vector<uint8_t>& buf,
+        _In_ uint16_t type,
+        _In_ const void *data,
+        _In_ size_t len)
+{
+    SWSS_LOG_ENTER();
+
+    size_t off = buf.size();
+
+    buf.resize(off + NLA_ALIGN(NLA_HDRLEN + len), 0);
+
+    auto nla = reinterpret_cast<struct nlattr*>(&buf[off]);
+
+    nla->nla_type = type;
+    nla->nla_len = (uint16_t)(NLA_HDRLEN + len);
+
+    memcpy(&buf[off + NLA_HDRLEN], data, len);
+}
+
+GenetlinkChannel::GenetlinkChannel(
+        _In_ const std::string& family,
+        _In_ const std::string& mcgrp):
+    m_family(family),
+    m_mcgrp(mcgrp),
+    m_sock(nullptr),
+    m_familyId(-1),
+    m_batchCount(0),
+    m_seq(0)
+{
+    SWSS_LOG_ENTER();
+
+    m_batch.reserve(SAI_VPP_GENETLINK_BATCH_BYTES);
+}
+
+GenetlinkChannel::~GenetlinkChannel()
+{
+    SWSS_LOG_ENTER();
+
+    close();
+}
+
+bool GenetlinkChannel::open()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_sock)
+    {
+        return true;
+    }
+
+    m_sock = nl_socket_alloc();
+
+    if (m_sock == nullptr)
+    {
+        SWSS_LOG_ERROR("failed to allocate netlink socket");
+        return false;
+    }
+
+    if (genl_connect(m_sock) < 0)
+    {
+        SWSS_LOG_ERROR("failed to connect generic netlink socket");
+
+        close();
+        return false;
+    }
+
+    m_familyId = genl_ctrl_resolve(m_sock, m_family.c_str());
+
+    if (m_familyId < 0)
+    {
+        SWSS_LOG_ERROR("generic netlink family %s not available", m_family.c_str());
+
+        close();
+        return false;
+    }
+
+    int group = genl_ctrl_resolve_grp(m_sock, m_family.c_str(), m_mcgrp.c_str());
+
+    if (group <= 0 || group > SAI_VPP_GENETLINK_MAX_GROUP)
+    {
+        SWSS_LOG_ERROR("multicast group %s of %s not available: %d", m_mcgrp.c_str(), m_family.c_str(), group);
+
+        close();
+        return false;
+    }
+
+    nl_socket_set_peer_groups(m_sock, 1U << (group - 1));
+
+    nl_socket_set_nonblocking(m_sock);
+
+    // a datagram can't be larger than the send buffer
+
+    nl_socket_set_buffer_size(m_sock, 0, 2 * SAI_VPP_GENETLINK_BATCH_BYTES);
+
+    int one = 1;
+
+    // error answers only carry the header of the message
+
+    setsockopt(nl_socket_get_fd(m_sock), SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one));
+
+    SWSS_LOG_NOTICE("trapped packets go to %s/%s (family %d, group %d)",
+            m_family.c_str(), m_mcgrp.c_str(), m_familyId, group);
+
+    return true;
+}
+
+void GenetlinkChannel::close()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_sock)
+    {
+        nl_socket_free(m_sock);
+        m_sock = nullptr;
+    }
+
+    m_familyId = -1;
+}
+
+void GenetlinkChannel::add(
+        _In_ const PacketMetadata& meta,
+        _In_ const uint8_t *data,
+        _In_ size_t size)
+{
+    SWSS_LOG_ENTER();
+
+    if (m_sock == nullptr)
+    {
+        return;
+    }
+
+    size_t need = NLMSG_HDRLEN + GENL_HDRLEN + 6 * NLA_ALIGN(NLA_HDRLEN + sizeof(uint32_t)) + NLA_ALIGN(NLA_HDRLEN + size);
+
+    if (m_batch.size() + need > SAI_VPP_GENETLINK_BATCH_BYTES)
+    {
+        flush();
+    }
+
+    size_t off = m_batch.size();
+
+    m_batch.resize(off + NLMSG_HDRLEN + GENL_HDRLEN, 0);
+
+    auto nlh = reinterpret_cast<struct nlmsghdr*>(&m_batch[off]);
+
+    nlh->nlmsg_type = (uint16_t)m_familyId;
+    nlh->nlmsg_seq = ++m_seq;
+
+    auto gnlh = reinterpret_cast<struct genlmsghdr*>(&m_batch[off + NLMSG_HDRLEN]);
+
+    gnlh->cmd = PSAMPLE_CMD_SAMPLE;
+    gnlh->version = SAI_VPP_GENETLINK_VERSION;
+
+    uint16_t iif = (uint16_t)meta.m_ingressIfindex;
+    uint32_t seq = ++m_groupSeq[meta.m_trapType];
+    uint32_t rate = 1;
+
+    put_attr(m_batch, PSAMPLE_ATTR_IIFINDEX, &iif, sizeof(iif));
+    put_attr(m_batch, PSAMPLE_ATTR_ORIGSIZE, &meta.m_origSize, sizeof(meta.m_origSize));
+    put_attr(m_batch, PSAMPLE_ATTR_SAMPLE_GROUP, &meta.m_trapType, sizeof(meta.m_trapType));
+    put_attr(m_batch, PSAMPLE_ATTR_GROUP_SEQ, &seq, sizeof(seq));
+    put_attr(m_batch, PSAMPLE_ATTR_SAMPLE_RATE, &rate, sizeof(rate));
+    put_attr(m_batch, PSAMPLE_ATTR_DATA, data, size);
+
+    // put_attr may have reallocated the batch
+
+    nlh = reinterpret_cast<struct nlmsghdr*>(&m_batch[off]);
+
+    nlh->nlmsg_len = (uint32_t)(m_batch.size() - off);
+
+    m_batchCount++;
+}
+
+size_t GenetlinkChannel::flush()
+{
+    SWSS_LOG_ENTER();
+
+    size_t count = m_batchCount;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    int err = nl_sendto(m_sock, m_batch.data(), m_batch.size());
+
+    if (err < 0)
+    {
+        SWSS_LOG_WARN("failed to send %zu packets to %s/%s: %s",
+                count, m_family.c_str(), m_mcgrp.c_str(), nl_geterror(err));
+
+        count = 0;
+    }
+
+    m_batch.clear();
+    m_batchCount = 0;
+
+    drain();
+
+    return count;
+}
+
+void GenetlinkChannel::drain()
+{
+    SWSS_LOG_ENTER();
+
+    /*
+     * Besides the multicast, the kernel side of the family gets the batch
+     * too and answers every message with an error, as the family has no
+     * handler for samples sent by user space.
+     */
+
+    char buf[4096];
+
+    int fd = nl_socket_get_fd(m_sock);
+
+    while (recv(fd, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+    {
+        // discard
+    }
+}
+
+const std::string& GenetlinkChannel::getFamily() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_family;
+}
+
+const std::string& GenetlinkChannel::getMcgrp() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_mcgrp;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "swss/sal.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct nl_sock;
+
+namespace saivpp
+{
+    /*
+     * Multicasts trapped packets on the group of a generic netlink family
+     * owned by the kernel, psample by default, in the psample message format.
+     * Packets are batched, several netlink messages per datagram.
+     */
+    class GenetlinkChannel
+    {
+        public:
+
+            typedef struct _PacketMetadata
+            {
+                // SAI trap type, sent as the sample group
+                uint32_t m_trapType;
+
+                // host netdev of the ingress port, 0 when unknown
+                uint32_t m_ingressIfindex;
+
+                uint32_t m_origSize;
+
+            } PacketMetadata;
+
+        private:
+
+            GenetlinkChannel(const GenetlinkChannel&) = delete;
+            GenetlinkChannel& operator=(const GenetlinkChannel&) = delete;
+
+        public:
+
+            GenetlinkChannel(
+                    _In_ const std::string& family,
+                    _In_ const std::string& mcgrp);
+
+            virtual ~GenetlinkChannel();
+
+        public:
+
+            /*
+             * Resolves the family and multicast group, which must already be
+             * registered by the kernel (modprobe psample).
+             */
+            bool open();
+
+            void add(
+                    _In_ const PacketMetadata& meta,
+                    _In_ const uint8_t *data,
+                    _In_ size_t size);
+
+            /*
+             * Sends the pending batch, returns the number of packets sent.
+             */
+            size_t flush();
+
+            const std::string& getFamily() const;
+
+            const std::string& getMcgrp() const;
+
+        private:
+
+            void close();
+
+            void drain();
+
+        private:
+
+            std::string m_family;
+
+            std::string m_mcgrp;
+
+            struct nl_sock *m_sock;
+
+            int m_familyId;
+
+            std::vector<uint8_t> m_batch;
+
+            size_t m_batchCount;
+
+            uint32_t m_seq;
+
+            // sequence number by trap type
+            std::map<uint32_t, uint32_t> m_groupSeq;
+    };
+}
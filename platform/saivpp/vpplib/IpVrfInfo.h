@@ -19,6 +19,9 @@ extern "C" {
 #include "sai.h"
 }
 
+#include <set>
+#include <string>
+
 namespace saivpp
 {
     class IpVrfInfo
@@ -27,15 +30,22 @@ namespace saivpp
 	    IpVrfInfo(
 		      _In_ sai_object_id_t obj_id,
 		      _In_ uint32_t vrf_id,
-		      _In_ std::string &vrf_name,
-		      bool is_ipv6);
+		      _In_ std::string &vrf_name);
 
 	    virtual ~IpVrfInfo();
 
         public:
 	    sai_object_id_t m_obj_id;
+
+	    /* VPP table id of both address families, the linux vrf table id */
 	    uint32_t m_vrf_id;
 	    std::string m_vrf_name;
-	    bool m_is_ipv6;
+
+	    /*
+	     * Users (router interfaces by VPP interface name, routes by
+	     * serialized route entry) of the ipv4 [0] and ipv6 [1] tables.
+	     * A table exists in VPP while it has users.
+	     */
+	    std::set<std::string> m_users[2];
     };
 }
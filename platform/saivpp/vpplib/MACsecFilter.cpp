@@ -14,7 +14,6 @@
  * limitations under the License.
  */
 #include "MACsecFilter.h"
-#include "MACsecFilterStateGuard.h"
 
 #include "swss/logger.h"
 #include "swss/select.h"
@@ -25,16 +24,23 @@
 #include <arpa/inet.h>
 #include <net/if.h>
 
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
 using namespace saivpp;
 
 #define EAPOL_ETHER_TYPE (0x888e)
 
+#define MACSEC_FILTER_QUIESCENCE_SPINS (64)
+#define MACSEC_FILTER_QUIESCENCE_MAX_SLEEP_US (1000)
+
 MACsecFilter::MACsecFilter(
         _In_ const std::string &macsecInterfaceName):
     m_macsecDeviceEnable(false),
     m_macsecfd(0),
     m_macsecInterfaceName(macsecInterfaceName),
-    m_state(MACsecFilter::MACsecFilterState::MACSEC_FILTER_STATE_IDLE)
+    m_epoch(0)
 {
     SWSS_LOG_ENTER();
 
@@ -46,17 +52,44 @@ void MACsecFilter::enable_macsec_device(
 {
     SWSS_LOG_ENTER();
 
-    m_macsecDeviceEnable = enable;
+    m_macsecDeviceEnable.store(enable);
+
+    // The function, execute(), may be running in another thread with the
+    // old enable state. If the macsec device was deleted meanwhile, the
+    // error value of function, forward, would be returned to the caller of
+    // execute() and the caller thread would exit. So wait until the packet
+    // thread is out of any execute() which could still see the old state.
+    wait_for_quiescence();
+}
+
+void MACsecFilter::wait_for_quiescence()
+{
+    SWSS_LOG_ENTER();
+
+    // pairs with the fence in execute(), either packet thread sees the new
+    // enable state or we see it inside execute()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+
+    if ((epoch & 1) == 0)
+    {
+        return;
+    }
+
+    uint32_t sleep_us = 1;
 
-    // The function, execute(), may be running in another thread,
-    // the macsec device enable state cannot be changed in the busy state.
-    // Because if the macsec device was deleted in the busy state,
-    // the error value of function, forward, will be returned
-    // to the caller of execute()
-    // and the caller thread will exit due to the error return value.
-    while(get_state() == MACsecFilter::MACsecFilterState::MACSEC_FILTER_STATE_BUSY)
+    for (uint32_t i = 0; m_epoch.load(std::memory_order_acquire) == epoch; i++)
     {
-        // Waiting the MACsec filter exit from the BUSY state
+        if (i < MACSEC_FILTER_QUIESCENCE_SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+
+        sleep_us = std::min(sleep_us * 2, (uint32_t)MACSEC_FILTER_QUIESCENCE_MAX_SLEEP_US);
     }
 }
 
@@ -68,20 +101,31 @@ void MACsecFilter::set_macsec_fd(
     m_macsecfd = macsecfd;
 }
 
-MACsecFilter::MACsecFilterState MACsecFilter::get_state() const
+TrafficFilter::FilterStatus MACsecFilter::execute(
+        _Inout_ void *buffer,
+        _Inout_ size_t &length)
 {
     SWSS_LOG_ENTER();
 
-    return m_state;
+    uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+
+    m_epoch.store(epoch + 1, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto status = filter(buffer, length);
+
+    m_epoch.store(epoch + 2, std::memory_order_release);
+
+    return status;
 }
 
-TrafficFilter::FilterStatus MACsecFilter::execute(
+TrafficFilter::FilterStatus MACsecFilter::filter(
         _Inout_ void *buffer,
         _Inout_ size_t &length)
 {
     SWSS_LOG_ENTER();
 
-    MACsecFilterStateGuard state_guard(m_state, MACsecFilter::MACsecFilterState::MACSEC_FILTER_STATE_BUSY);
     auto mac_hdr = static_cast<const ethhdr *>(buffer);
 
     if (ntohs(mac_hdr->h_proto) == EAPOL_ETHER_TYPE)
@@ -90,7 +134,7 @@ TrafficFilter::FilterStatus MACsecFilter::execute(
         return TrafficFilter::CONTINUE;
     }
 
-    if (m_macsecDeviceEnable)
+    if (m_macsecDeviceEnable.load(std::memory_order_acquire))
     {
         return forward(buffer, length);
     }
@@ -18,6 +18,8 @@
 #include "TrafficFilter.h"
 
 #include <string>
+#include <atomic>
+#include <cstdint>
 
 namespace saivpp
 {
@@ -26,14 +28,6 @@ namespace saivpp
     {
         public:
 
-            typedef enum _MACsecFilterState
-            {
-                MACSEC_FILTER_STATE_IDLE,
-
-                MACSEC_FILTER_STATE_BUSY,
-
-            } MACsecFilterState;
-
             MACsecFilter(
                     _In_ const std::string &macsecInterfaceName);
 
@@ -49,20 +43,35 @@ namespace saivpp
             void set_macsec_fd(
                     _In_ int macsecfd);
 
-            MACsecFilterState get_state() const;
-
         protected:
 
             virtual FilterStatus forward(
                     _In_ const void *buffer,
                     _In_ size_t length) = 0;
 
-            volatile bool m_macsecDeviceEnable;
+        private:
+
+            FilterStatus filter(
+                    _Inout_ void *buffer,
+                    _Inout_ size_t &length);
+
+            void wait_for_quiescence();
+
+        protected:
+
+            std::atomic<bool> m_macsecDeviceEnable;
 
             int m_macsecfd;
 
             const std::string m_macsecInterfaceName;
 
-            MACsecFilterState m_state;
+        private:
+
+            /*
+             * Written only by the packet thread, odd while it is inside
+             * execute(). Control path only reads it, so per packet there
+             * is no write to state shared with other threads.
+             */
+            alignas(64) std::atomic<uint64_t> m_epoch;
     };
 }
@@ -67,6 +67,8 @@ bool MACsecManager::create_macsec_sc(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     if (is_macsec_sc_existing( attr.m_macsecName, attr.m_direction, attr.m_sci))
     {
         SWSS_LOG_WARN(
@@ -111,6 +113,8 @@ bool MACsecManager::create_macsec_sa(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     if (is_macsec_sa_existing( attr.m_macsecName, attr.m_direction, attr.m_sci, attr.m_an))
     {
         SWSS_LOG_WARN(
@@ -172,6 +176,8 @@ bool MACsecManager::delete_macsec_port(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     // Linux MACsec driver would not differentiate the Ingress and Egress port,
     // We just need to delete the Linux MACsec device when the egress port was deleted
     // And we assume that deleting the ingress port is always success.
@@ -188,6 +194,8 @@ bool MACsecManager::delete_macsec_sc(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     if (!is_macsec_sc_existing( attr.m_macsecName, attr.m_direction, attr.m_sci))
     {
         SWSS_LOG_WARN(
@@ -231,6 +239,8 @@ bool MACsecManager::delete_macsec_sa(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     if (!is_macsec_sa_existing( attr.m_macsecName, attr.m_direction, attr.m_sci, attr.m_an))
     {
         SWSS_LOG_WARN(
@@ -313,6 +323,8 @@ bool MACsecManager::update_macsec_sa_pn(
 {
     SWSS_LOG_ENTER();
 
+    m_statsCollector.invalidate();
+
     std::ostringstream ostream;
     ostream
         << "/sbin/ip macsec set "
@@ -348,6 +360,28 @@ bool MACsecManager::get_macsec_sa_pn(
     SWSS_LOG_ENTER();
 
     pn = 1;
+
+    if (m_statsCollector.refresh())
+    {
+        MACsecStatsCollector::SAStats stats;
+
+        if (!m_statsCollector.get_sa_stats(attr, stats))
+        {
+            SWSS_LOG_WARN(
+                    "The MACsec SA %s:%u isn't in the MACsec statistics of the device %s.",
+                    attr.m_sci.c_str(),
+                    static_cast<std::uint32_t>(attr.m_an),
+                    attr.m_macsecName.c_str());
+
+            return false;
+        }
+
+        pn = stats.m_pn;
+        return true;
+    }
+
+    // netlink dump not available, fall back to ip command
+
     std::string macsecSaInfo;
 
     if (!get_macsec_sa_info( attr.m_macsecName, attr.m_direction, attr.m_sci, attr.m_an, macsecSaInfo))
@@ -392,6 +426,24 @@ bool MACsecManager::get_macsec_sa_pn(
 
 }
 
+bool MACsecManager::get_macsec_sa_stats(
+        _In_ const MACsecAttr &attr,
+        _Out_ MACsecStatsCollector::SAStats &stats) const
+{
+    SWSS_LOG_ENTER();
+
+    return m_statsCollector.get_sa_stats(attr, stats);
+}
+
+bool MACsecManager::get_macsec_sc_stats(
+        _In_ const MACsecAttr &attr,
+        _Out_ MACsecStatsCollector::SCStats &stats) const
+{
+    SWSS_LOG_ENTER();
+
+    return m_statsCollector.get_sc_stats(attr, stats);
+}
+
 // Create MACsec Egress SC
 // $ ip link add link <VETH_NAME> name <MACSEC_NAME> type macsec sci <SCI>
 // $ ip link set dev <MACSEC_NAME> up
@@ -533,8 +585,9 @@ bool MACsecManager::delete_macsec_egress_sc(
 
     SWSS_LOG_NOTICE("%s", ostream.str().c_str());
 
-    result &= delete_macsec_forwarder(attr.m_macsecName);
+    // no packet may be inside the filters once the forwarder goes away
     result &= enable_macsec_filter(attr.m_macsecName, false);
+    result &= delete_macsec_forwarder(attr.m_macsecName);
     result &= exec(ostream.str());
 
     return result;
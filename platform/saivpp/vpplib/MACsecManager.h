@@ -18,6 +18,7 @@
 #include "MACsecAttr.h"
 #include "MACsecFilter.h"
 #include "MACsecForwarder.h"
+#include "MACsecStatsCollector.h"
 
 namespace saivpp
 {
@@ -59,6 +60,14 @@ namespace saivpp
                     _In_ const MACsecAttr &attr,
                     _Out_ sai_uint64_t &pn) const;
 
+            bool get_macsec_sa_stats(
+                    _In_ const MACsecAttr &attr,
+                    _Out_ MACsecStatsCollector::SAStats &stats) const;
+
+            bool get_macsec_sc_stats(
+                    _In_ const MACsecAttr &attr,
+                    _Out_ MACsecStatsCollector::SCStats &stats) const;
+
             void cleanup_macsec_device() const;
 
         protected:
@@ -158,5 +167,7 @@ namespace saivpp
             };
 
             std::map<std::string, MACsecTrafficManager> m_macsecTrafficManagers;
+
+            mutable MACsecStatsCollector m_statsCollector;
     };
 }
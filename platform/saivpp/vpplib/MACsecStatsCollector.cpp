@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MACsecStatsCollector.h"
+
+#include "swss/logger.h"
+
+#include <netlink/netlink.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include <net/if.h>
+#include <endian.h>
+#include <inttypes.h>
+
+using namespace saivpp;
+
+/*
+ * Flex counter polls every SA of every port in a row, one dump serves the
+ * whole poll.
+ */
+#define SAI_VPP_MACSEC_STATS_REFRESH_MS 1000
+
+static void parse_stats(
+        _In_ struct nlattr *nest,
+        _In_ int maxtype,
+        _Out_ std::vector<uint64_t> &stats)
+{
+    SWSS_LOG_ENTER();
+
+    stats.assign(maxtype + 1, 0);
+
+    if (nest == nullptr)
+    {
+        return;
+    }
+
+    std::vector<struct nlattr*> tb(maxtype + 1, nullptr);
+
+    if (nla_parse_nested(tb.data(), maxtype, nest, nullptr) < 0)
+    {
+        return;
+    }
+
+    for (int i = 1; i <= maxtype; i++)
+    {
+        if (tb[i] && nla_len(tb[i]) >= (int)sizeof(uint64_t))
+        {
+            stats[i] = nla_get_u64(tb[i]);
+        }
+    }
+}
+
+static macsec_sci_t sci_to_string(
+        _In_ struct nlattr *attr)
+{
+    SWSS_LOG_ENTER();
+
+    // SCI is carried in network order, same format as "ip macsec show"
+
+    char buf[sizeof(uint64_t) * 2 + 1];
+
+    snprintf(buf, sizeof(buf), "%016" PRIx64, (uint64_t)be64toh(nla_get_u64(attr)));
+
+    return buf;
+}
+
+MACsecStatsCollector::MACsecStatsCollector():
+    m_cacheValid(false),
+    m_sock(nullptr),
+    m_family(-1)
+{
+    SWSS_LOG_ENTER();
+
+    // empty
+}
+
+MACsecStatsCollector::~MACsecStatsCollector()
+{
+    SWSS_LOG_ENTER();
+
+    disconnect();
+}
+
+bool MACsecStatsCollector::connect()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_sock)
+    {
+        return true;
+    }
+
+    m_sock = nl_socket_alloc();
+
+    if (m_sock == nullptr)
+    {
+        SWSS_LOG_ERROR("failed to allocate netlink socket");
+        return false;
+    }
+
+    if (genl_connect(m_sock) < 0)
+    {
+        SWSS_LOG_ERROR("failed to connect generic netlink socket");
+
+        disconnect();
+        return false;
+    }
+
+    m_family = genl_ctrl_resolve(m_sock, MACSEC_GENL_NAME);
+
+    if (m_family < 0)
+    {
+        SWSS_LOG_WARN("generic netlink family %s not available", MACSEC_GENL_NAME);
+
+        disconnect();
+        return false;
+    }
+
+    nl_socket_modify_cb(m_sock, NL_CB_VALID, NL_CB_CUSTOM, MACsecStatsCollector::on_dump, this);
+
+    return true;
+}
+
+void MACsecStatsCollector::disconnect()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_sock)
+    {
+        nl_socket_free(m_sock);
+    }
+
+    m_sock = nullptr;
+    m_family = -1;
+}
+
+void MACsecStatsCollector::invalidate()
+{
+    SWSS_LOG_ENTER();
+
+    m_cacheValid = false;
+}
+
+bool MACsecStatsCollector::refresh()
+{
+    SWSS_LOG_ENTER();
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (m_cacheValid && now - m_cacheTime < std::chrono::milliseconds(SAI_VPP_MACSEC_STATS_REFRESH_MS))
+    {
+        return true;
+    }
+
+    m_cache.clear();
+    m_cacheValid = false;
+
+    if (!connect())
+    {
+        return false;
+    }
+
+    struct nl_msg *msg = nlmsg_alloc();
+
+    if (msg == nullptr)
+    {
+        return false;
+    }
+
+    genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, m_family, 0, NLM_F_DUMP, MACSEC_CMD_GET_TXSC, MACSEC_GENL_VERSION);
+
+    int err = nl_send_auto(m_sock, msg);
+
+    nlmsg_free(msg);
+
+    if (err >= 0)
+    {
+        err = nl_recvmsgs_default(m_sock);
+    }
+
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("MACsec statistics dump failed: %s", nl_geterror(err));
+
+        // socket may be out of sync with kernel, reopen on next poll
+
+        disconnect();
+        return false;
+    }
+
+    m_cacheTime = now;
+    m_cacheValid = true;
+
+    SWSS_LOG_INFO("MACsec statistics dump returned %zu SCs", m_cache.size());
+
+    return true;
+}
+
+int MACsecStatsCollector::on_dump(
+        _In_ struct nl_msg *msg,
+        _In_ void *arg)
+{
+    SWSS_LOG_ENTER();
+
+    static_cast<MACsecStatsCollector*>(arg)->parse_device(msg);
+
+    return NL_OK;
+}
+
+void MACsecStatsCollector::parse_sa_list(
+        _In_ struct nlattr *list,
+        _Inout_ SCStats &sc)
+{
+    SWSS_LOG_ENTER();
+
+    if (list == nullptr)
+    {
+        return;
+    }
+
+    struct nlattr *nest;
+    int rem;
+
+    nla_for_each_nested(nest, list, rem)
+    {
+        struct nlattr *tb[MACSEC_SA_ATTR_MAX + 1];
+
+        if (nla_parse_nested(tb, MACSEC_SA_ATTR_MAX, nest, nullptr) < 0 || !tb[MACSEC_SA_ATTR_AN])
+        {
+            continue;
+        }
+
+        auto& sa = sc.m_sas[nla_get_u8(tb[MACSEC_SA_ATTR_AN])];
+
+        sa.m_pn = 0;
+
+        if (tb[MACSEC_SA_ATTR_PN])
+        {
+            // PN is u64 for XPN ciphers, u32 otherwise
+
+            sa.m_pn = (nla_len(tb[MACSEC_SA_ATTR_PN]) >= (int)sizeof(uint64_t)) ?
+                nla_get_u64(tb[MACSEC_SA_ATTR_PN]) :
+                nla_get_u32(tb[MACSEC_SA_ATTR_PN]);
+        }
+
+        parse_stats(tb[MACSEC_SA_ATTR_STATS], MACSEC_SA_STATS_ATTR_MAX, sa.m_stats);
+    }
+}
+
+void MACsecStatsCollector::parse_device(
+        _In_ struct nl_msg *msg)
+{
+    SWSS_LOG_ENTER();
+
+    struct nlattr *tb[MACSEC_ATTR_MAX + 1];
+
+    if (genlmsg_parse(nlmsg_hdr(msg), 0, tb, MACSEC_ATTR_MAX, nullptr) < 0 ||
+            !tb[MACSEC_ATTR_IFINDEX] || !tb[MACSEC_ATTR_SECY])
+    {
+        return;
+    }
+
+    char ifname[IF_NAMESIZE];
+
+    if (if_indextoname(nla_get_u32(tb[MACSEC_ATTR_IFINDEX]), ifname) == nullptr)
+    {
+        return;
+    }
+
+    struct nlattr *secy[MACSEC_SECY_ATTR_MAX + 1];
+
+    if (nla_parse_nested(secy, MACSEC_SECY_ATTR_MAX, tb[MACSEC_ATTR_SECY], nullptr) < 0 ||
+            !secy[MACSEC_SECY_ATTR_SCI])
+    {
+        return;
+    }
+
+    auto& txsc = m_cache[SCKey(ifname, SAI_MACSEC_DIRECTION_EGRESS, sci_to_string(secy[MACSEC_SECY_ATTR_SCI]))];
+
+    parse_stats(tb[MACSEC_ATTR_TXSC_STATS], MACSEC_TXSC_STATS_ATTR_MAX, txsc.m_stats);
+    parse_sa_list(tb[MACSEC_ATTR_TXSA_LIST], txsc);
+
+    if (tb[MACSEC_ATTR_RXSC_LIST] == nullptr)
+    {
+        return;
+    }
+
+    struct nlattr *nest;
+    int rem;
+
+    nla_for_each_nested(nest, tb[MACSEC_ATTR_RXSC_LIST], rem)
+    {
+        struct nlattr *rx[MACSEC_RXSC_ATTR_MAX + 1];
+
+        if (nla_parse_nested(rx, MACSEC_RXSC_ATTR_MAX, nest, nullptr) < 0 || !rx[MACSEC_RXSC_ATTR_SCI])
+        {
+            continue;
+        }
+
+        auto& rxsc = m_cache[SCKey(ifname, SAI_MACSEC_DIRECTION_INGRESS, sci_to_string(rx[MACSEC_RXSC_ATTR_SCI]))];
+
+        parse_stats(rx[MACSEC_RXSC_ATTR_STATS], MACSEC_RXSC_STATS_ATTR_MAX, rxsc.m_stats);
+        parse_sa_list(rx[MACSEC_RXSC_ATTR_SA_LIST], rxsc);
+    }
+}
+
+bool MACsecStatsCollector::get_sc_stats(
+        _In_ const MACsecAttr &attr,
+        _Out_ SCStats &stats)
+{
+    SWSS_LOG_ENTER();
+
+    if (!refresh())
+    {
+        return false;
+    }
+
+    auto it = m_cache.find(SCKey(attr.m_macsecName, attr.m_direction, attr.m_sci));
+
+    if (it == m_cache.end())
+    {
+        return false;
+    }
+
+    stats = it->second;
+
+    return true;
+}
+
+bool MACsecStatsCollector::get_sa_stats(
+        _In_ const MACsecAttr &attr,
+        _Out_ SAStats &stats)
+{
+    SWSS_LOG_ENTER();
+
+    if (!refresh())
+    {
+        return false;
+    }
+
+    auto it = m_cache.find(SCKey(attr.m_macsecName, attr.m_direction, attr.m_sci));
+
+    if (it == m_cache.end())
+    {
+        return false;
+    }
+
+    auto sa = it->second.m_sas.find(attr.m_an);
+
+    if (sa == it->second.m_sas.end())
+    {
+        return false;
+    }
+
+    stats = sa->second;
+
+    return true;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "MACsecAttr.h"
+
+#include "swss/sal.h"
+
+#include <linux/if_macsec.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct nl_sock;
+struct nl_msg;
+struct nlattr;
+
+namespace saivpp
+{
+    /*
+     * Reads statistics of all MACsec devices with a single generic netlink
+     * dump and serves SA and SC lookups from the cached result.
+     */
+    class MACsecStatsCollector
+    {
+        public:
+
+            struct SAStats
+            {
+                macsec_pn_t m_pn;
+
+                // indexed by macsec_sa_stats_attr
+                std::vector<uint64_t> m_stats;
+            };
+
+            struct SCStats
+            {
+                // indexed by macsec_rxsc_stats_attr or macsec_txsc_stats_attr
+                std::vector<uint64_t> m_stats;
+
+                std::map<macsec_an_t, SAStats> m_sas;
+            };
+
+        public:
+
+            MACsecStatsCollector();
+
+            virtual ~MACsecStatsCollector();
+
+        public:
+
+            bool get_sa_stats(
+                    _In_ const MACsecAttr &attr,
+                    _Out_ SAStats &stats);
+
+            bool get_sc_stats(
+                    _In_ const MACsecAttr &attr,
+                    _Out_ SCStats &stats);
+
+            bool refresh();
+
+            void invalidate();
+
+        private:
+
+            bool connect();
+
+            void disconnect();
+
+            static int on_dump(
+                    _In_ struct nl_msg *msg,
+                    _In_ void *arg);
+
+            void parse_device(
+                    _In_ struct nl_msg *msg);
+
+            void parse_sa_list(
+                    _In_ struct nlattr *list,
+                    _Inout_ SCStats &sc);
+
+        private:
+
+            typedef std::tuple<std::string, sai_int32_t, macsec_sci_t> SCKey;
+
+            std::map<SCKey, SCStats> m_cache;
+
+            std::chrono::steady_clock::time_point m_cacheTime;
+
+            bool m_cacheValid;
+
+            struct nl_sock *m_sock;
+
+            int m_family;
+    };
+}
@@ -20,10 +20,21 @@
 #include "swss/netlink.h"
 #include "swss/select.h"
 
+#include <netlink/route/link.h>
+#include <netlink/route/addr.h>
+
+#include <arpa/inet.h>
+
 using namespace saivpp;
 
 #define MUTEX std::lock_guard<std::mutex> _lock(m_mutex);
 
+/*
+ * Link messages for the same interface arriving within this window are
+ * coalesced to the latest state and delivered to callbacks as one batch.
+ */
+#define SAI_VPP_LINK_MSG_COALESCE_MS 50
+
 NetMsgRegistrar::NetMsgRegistrar():
     m_index(0)
 {
@@ -90,6 +101,22 @@ void NetMsgRegistrar::unregisterCallback(
     {
         m_map.erase(it);
     }
+
+    for (auto oit = m_ifIndexOwners.begin(); oit != m_ifIndexOwners.end(); )
+    {
+        oit->second.erase(index);
+
+        if (oit->second.empty())
+        {
+            m_pending.erase(oit->first);
+
+            oit = m_ifIndexOwners.erase(oit);
+        }
+        else
+        {
+            ++oit;
+        }
+    }
 }
 
 void NetMsgRegistrar::unregisterAll()
@@ -99,6 +126,48 @@ void NetMsgRegistrar::unregisterAll()
     MUTEX;
 
     m_map.clear();
+
+    m_ifIndexOwners.clear();
+
+    m_pending.clear();
+
+    m_pendingAddrs.clear();
+}
+
+void NetMsgRegistrar::addIfIndex(
+        _In_ uint64_t index,
+        _In_ int ifindex)
+{
+    SWSS_LOG_ENTER();
+
+    MUTEX;
+
+    m_ifIndexOwners[ifindex].insert(index);
+}
+
+void NetMsgRegistrar::removeIfIndex(
+        _In_ uint64_t index,
+        _In_ int ifindex)
+{
+    SWSS_LOG_ENTER();
+
+    MUTEX;
+
+    auto it = m_ifIndexOwners.find(ifindex);
+
+    if (it == m_ifIndexOwners.end())
+    {
+        return;
+    }
+
+    it->second.erase(index);
+
+    if (it->second.empty())
+    {
+        m_ifIndexOwners.erase(it);
+
+        m_pending.erase(ifindex);
+    }
 }
 
 void NetMsgRegistrar::resetIndex()
@@ -116,6 +185,7 @@ void NetMsgRegistrar::run()
 
     swss::NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, this);
     swss::NetDispatcher::getInstance().registerMessageHandler(RTM_DELLINK, this);
+    swss::NetDispatcher::getInstance().registerMessageHandler(RTM_NEWADDR, this);
 
     SWSS_LOG_NOTICE("netlink msg listener started");
 
@@ -128,6 +198,8 @@ void NetMsgRegistrar::run()
             swss::Select s;
 
             netlink.registerGroup(RTNLGRP_LINK);
+            netlink.registerGroup(RTNLGRP_IPV4_IFADDR);
+            netlink.registerGroup(RTNLGRP_IPV6_IFADDR);
             netlink.dumpRequest(RTM_GETLINK);
 
             s.addSelectable(&netlink);
@@ -137,9 +209,11 @@ void NetMsgRegistrar::run()
             {
                 swss::Selectable *sel = NULL;
 
-                int result = s.select(&sel);
+                int result = s.select(&sel, getSelectTimeout());
 
                 SWSS_LOG_INFO("select ended: %d", result);
+
+                flushPending();
             }
         }
         catch (const std::exception& e)
@@ -152,6 +226,81 @@ void NetMsgRegistrar::run()
     SWSS_LOG_NOTICE("netlink msg listener ended");
 }
 
+int NetMsgRegistrar::getSelectTimeout()
+{
+    SWSS_LOG_ENTER();
+
+    MUTEX;
+
+    if (m_pending.empty() && m_pendingAddrs.empty())
+    {
+        return -1;
+    }
+
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_pendingDeadline - std::chrono::steady_clock::now()).count();
+
+    return left > 0 ? (int)left : 0;
+}
+
+void NetMsgRegistrar::flushPending()
+{
+    SWSS_LOG_ENTER();
+
+    MUTEX;
+
+    if ((m_pending.empty() && m_pendingAddrs.empty()) ||
+            std::chrono::steady_clock::now() < m_pendingDeadline)
+    {
+        return;
+    }
+
+    std::map<uint64_t, std::vector<LinkState>> batches;
+
+    for (auto& kvp: m_pending)
+    {
+        auto it = m_ifIndexOwners.find(kvp.first);
+
+        if (it == m_ifIndexOwners.end())
+        {
+            continue;
+        }
+
+        for (auto index: it->second)
+        {
+            batches[index].push_back(kvp.second);
+        }
+    }
+
+    for (auto& kvp: m_pendingAddrs)
+    {
+        for (auto& cb: m_map)
+        {
+            batches[cb.first].push_back(kvp.second);
+        }
+    }
+
+    SWSS_LOG_INFO("flushing %zu coalesced link messages, %zu addresses",
+            m_pending.size(),
+            m_pendingAddrs.size());
+
+    m_pending.clear();
+
+    m_pendingAddrs.clear();
+
+    // execute callbacks under mutex, each one once per batch
+
+    for (auto& kvp: batches)
+    {
+        auto it = m_map.find(kvp.first);
+
+        if (it != m_map.end())
+        {
+            it->second(kvp.second);
+        }
+    }
+}
+
 void NetMsgRegistrar::onMsg(
         _In_ int nlmsg_type,
         _In_ struct nl_object *obj)
@@ -172,10 +321,63 @@ void NetMsgRegistrar::onMsg(
     // destructor was called and thread already joined, so we place MUTEX in
     // destructor ending to make sure that m_run is false if this happens
 
-    // execute all callbacks under mutex
+    if (nlmsg_type == RTM_NEWADDR)
+    {
+        onAddrMsg(nlmsg_type, obj);
+        return;
+    }
 
-    for (auto& kvp: m_map)
+    struct rtnl_link *link = (struct rtnl_link *)obj;
+
+    int if_index = rtnl_link_get_ifindex(link);
+
+    if (m_ifIndexOwners.find(if_index) == m_ifIndexOwners.end())
+    {
+        // not owned by any switch, drop before it reaches event queue
+
+        return;
+    }
+
+    const char* if_name = rtnl_link_get_name(link);
+
+    if (m_pending.empty() && m_pendingAddrs.empty())
     {
-        kvp.second(nlmsg_type, obj);
+        m_pendingDeadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(SAI_VPP_LINK_MSG_COALESCE_MS);
     }
+
+    // newer message for the same interface replaces the pending one
+
+    m_pending[if_index] = { nlmsg_type, if_index, rtnl_link_get_flags(link), if_name ? if_name : "" };
+}
+
+void NetMsgRegistrar::onAddrMsg(
+        _In_ int nlmsg_type,
+        _In_ struct nl_object *obj)
+{
+    SWSS_LOG_ENTER();
+
+    // called under mutex from onMsg
+
+    struct rtnl_addr *addr = (struct rtnl_addr *)obj;
+
+    struct nl_addr *local = rtnl_addr_get_local(addr);
+
+    char buf[INET6_ADDRSTRLEN];
+
+    if (local == NULL ||
+            inet_ntop(nl_addr_get_family(local), nl_addr_get_binary_addr(local), buf, sizeof(buf)) == NULL)
+    {
+        return;
+    }
+
+    if (m_pending.empty() && m_pendingAddrs.empty())
+    {
+        m_pendingDeadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(SAI_VPP_LINK_MSG_COALESCE_MS);
+    }
+
+    int if_index = rtnl_addr_get_ifindex(addr);
+
+    m_pendingAddrs[buf] = { nlmsg_type, if_index, 0, "", buf };
 }
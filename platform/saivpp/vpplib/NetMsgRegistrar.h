@@ -24,6 +24,10 @@
 #include <mutex>
 #include <memory>
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <chrono>
 
 namespace saivpp
 {
@@ -51,7 +55,25 @@ namespace saivpp
 
         public:
 
-            typedef std::function<void(int, struct nl_object*)> Callback;
+            struct LinkState
+            {
+                int m_nlmsgType;
+
+                int m_ifIndex;
+
+                unsigned int m_ifFlags;
+
+                std::string m_ifName;
+
+                std::string m_ipAddress; // RTM_NEWADDR only
+            };
+
+            /*
+             * Callback receives latest state of each owned interface that
+             * changed during coalescing window, as one batch. New addresses
+             * are not owned by a switch and are delivered to every callback.
+             */
+            typedef std::function<void(const std::vector<LinkState>&)> Callback;
 
         public:
 
@@ -65,6 +87,14 @@ namespace saivpp
 
             void unregisterAll();
 
+            void addIfIndex(
+                    _In_ uint64_t index,
+                    _In_ int ifindex);
+
+            void removeIfIndex(
+                    _In_ uint64_t index,
+                    _In_ int ifindex);
+
             void resetIndex();
 
         public:
@@ -76,6 +106,14 @@ namespace saivpp
 
             void run();
 
+            int getSelectTimeout();
+
+            void flushPending();
+
+            void onAddrMsg(
+                    _In_ int nlmsg_type,
+                    _In_ struct nl_object *obj);
+
         private:
 
             std::shared_ptr<std::thread> m_thread;
@@ -89,5 +127,13 @@ namespace saivpp
             uint64_t m_index;
 
             std::map<uint64_t, Callback> m_map;
+
+            std::map<int, std::set<uint64_t>> m_ifIndexOwners;
+
+            std::map<int, LinkState> m_pending;
+
+            std::map<std::string, LinkState> m_pendingAddrs;
+
+            std::chrono::steady_clock::time_point m_pendingDeadline;
     };
 }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ObjectListIndex.h"
+
+#include "swss/logger.h"
+
+#include <algorithm>
+
+using namespace saivpp;
+
+void ObjectListIndex::insert(
+        _In_ sai_object_id_t owner,
+        _In_ sai_object_id_t member,
+        _In_ uint64_t order)
+{
+    SWSS_LOG_ENTER();
+
+    if (m_members.find(member) != m_members.end())
+    {
+        erase(member);
+    }
+
+    auto& list = m_lists[owner];
+
+    Entry entry(order, member);
+
+    list.m_members.insert(std::lower_bound(list.m_members.begin(), list.m_members.end(), entry), entry);
+    list.m_generation++;
+
+    m_members[member] = std::make_pair(owner, order);
+}
+
+void ObjectListIndex::erase(
+        _In_ sai_object_id_t member)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_members.find(member);
+
+    if (it == m_members.end())
+    {
+        return;
+    }
+
+    auto lit = m_lists.find(it->second.first);
+
+    if (lit != m_lists.end())
+    {
+        auto& members = lit->second.m_members;
+
+        Entry entry(it->second.second, member);
+
+        auto eit = std::lower_bound(members.begin(), members.end(), entry);
+
+        if (eit != members.end() && *eit == entry)
+        {
+            members.erase(eit);
+            lit->second.m_generation++;
+        }
+    }
+
+    m_members.erase(it);
+}
+
+void ObjectListIndex::eraseOwner(
+        _In_ sai_object_id_t owner)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_lists.find(owner);
+
+    if (it == m_lists.end())
+    {
+        return;
+    }
+
+    for (auto& entry: it->second.m_members)
+    {
+        m_members.erase(entry.second);
+    }
+
+    m_lists.erase(it);
+}
+
+bool ObjectListIndex::fetchChanged(
+        _In_ sai_object_id_t owner,
+        _Out_ std::vector<sai_object_id_t>& members)
+{
+    SWSS_LOG_ENTER();
+
+    auto& list = m_lists[owner];
+
+    if (list.m_fetched == list.m_generation)
+    {
+        return false;
+    }
+
+    list.m_fetched = list.m_generation;
+
+    members.clear();
+    members.reserve(list.m_members.size());
+
+    for (auto& entry: list.m_members)
+    {
+        members.push_back(entry.second);
+    }
+
+    return true;
+}
+
+uint64_t ObjectListIndex::getGeneration(
+        _In_ sai_object_id_t owner) const
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_lists.find(owner);
+
+    return (it == m_lists.end()) ? 0 : it->second.m_generation;
+}
+
+void ObjectListIndex::clear()
+{
+    SWSS_LOG_ENTER();
+
+    m_lists.clear();
+    m_members.clear();
+}
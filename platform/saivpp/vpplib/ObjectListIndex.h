@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+extern "C" {
+#include "sai.h"
+}
+
+#include "swss/sal.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace saivpp
+{
+    /*
+     * Membership of objects in an owner's list attribute (ports of the
+     * switch, members of a VLAN, ports of a bridge), kept up to date on
+     * member create and remove. Each owner's list has a generation that is
+     * bumped on change, so a read only list is only written back to the
+     * owner's attribute when it changed since the last read.
+     */
+    class ObjectListIndex
+    {
+        public:
+
+            ObjectListIndex() = default;
+
+            virtual ~ObjectListIndex() = default;
+
+        public:
+
+            /*
+             * Members are kept sorted by order, then by member id.
+             */
+            void insert(
+                    _In_ sai_object_id_t owner,
+                    _In_ sai_object_id_t member,
+                    _In_ uint64_t order);
+
+            void erase(
+                    _In_ sai_object_id_t member);
+
+            void eraseOwner(
+                    _In_ sai_object_id_t owner);
+
+            /*
+             * Returns true and the current list if it changed since the last
+             * call for this owner, or if it was never fetched.
+             */
+            bool fetchChanged(
+                    _In_ sai_object_id_t owner,
+                    _Out_ std::vector<sai_object_id_t>& members);
+
+            uint64_t getGeneration(
+                    _In_ sai_object_id_t owner) const;
+
+            void clear();
+
+        private:
+
+            typedef std::pair<uint64_t, sai_object_id_t> Entry;
+
+            typedef struct _MemberList
+            {
+                std::vector<Entry> m_members;
+
+                uint64_t m_generation = 1;
+
+                // generation of the last fetch
+                uint64_t m_fetched = 0;
+
+            } MemberList;
+
+            std::unordered_map<sai_object_id_t, MemberList> m_lists;
+
+            // owner and order of each member
+            std::unordered_map<sai_object_id_t, std::pair<sai_object_id_t, uint64_t>> m_members;
+    };
+}
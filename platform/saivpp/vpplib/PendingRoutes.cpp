@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PendingRoutes.h"
+
+#include "swss/logger.h"
+#include "meta/sai_serialize.h"
+
+#include <arpa/inet.h>
+
+#include <vector>
+
+using namespace saivpp;
+
+static uint32_t prefix_length(
+        _In_ const sai_ip_prefix_t& prefix)
+{
+    SWSS_LOG_ENTER();
+
+    if (prefix.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        return __builtin_popcount(prefix.mask.ip4);
+    }
+
+    uint32_t len = 0;
+
+    for (size_t i = 0; i < sizeof(prefix.mask.ip6); i++)
+    {
+        len += __builtin_popcount(prefix.mask.ip6[i]);
+    }
+
+    return len;
+}
+
+static sai_ip_prefix_t make_prefix(
+        _In_ sai_ip_addr_family_t family,
+        _In_ const sai_ip_addr_t& addr,
+        _In_ uint32_t len)
+{
+    SWSS_LOG_ENTER();
+
+    sai_ip_prefix_t prefix = {};
+
+    prefix.addr_family = family;
+
+    if (family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        prefix.mask.ip4 = htonl(len == 0 ? 0 : 0xffffffffu << (32 - len));
+        prefix.addr.ip4 = addr.ip4 & prefix.mask.ip4;
+
+        return prefix;
+    }
+
+    for (size_t i = 0; i < sizeof(prefix.mask.ip6); i++)
+    {
+        uint32_t bits = len > 8 * i ? len - 8 * (uint32_t)i : 0;
+
+        prefix.mask.ip6[i] = (uint8_t)(bits >= 8 ? 0xff : (0xff << (8 - bits)));
+        prefix.addr.ip6[i] = addr.ip6[i] & prefix.mask.ip6[i];
+    }
+
+    return prefix;
+}
+
+const char *PendingRoutes::depName(
+        _In_ route_dep_t dep)
+{
+    SWSS_LOG_ENTER();
+
+    switch (dep)
+    {
+        case ROUTE_DEP_VRF:
+            return "virtual router";
+
+        case ROUTE_DEP_RIF:
+            return "router interface";
+
+        case ROUTE_DEP_NEXT_HOP:
+            return "next hop";
+
+        case ROUTE_DEP_ADDRESS:
+            return "host interface address";
+
+        default:
+            return "none";
+    }
+}
+
+void PendingRoutes::defer(
+        _In_ const std::string& serializedRouteEntry,
+        _In_ route_dep_t dep,
+        _In_ sai_object_id_t depId)
+{
+    SWSS_LOG_ENTER();
+
+    cancel(serializedRouteEntry);
+
+    auto key = std::make_tuple(dep, depId, std::string());
+
+    m_routes[key].insert(serializedRouteEntry);
+    m_routeDeps[serializedRouteEntry] = key;
+}
+
+void PendingRoutes::deferAddress(
+        _In_ const std::string& serializedRouteEntry,
+        _In_ const sai_ip_prefix_t& destination)
+{
+    SWSS_LOG_ENTER();
+
+    cancel(serializedRouteEntry);
+
+    uint32_t len = prefix_length(destination);
+
+    auto prefix = make_prefix(destination.addr_family, destination.addr, len);
+
+    auto key = std::make_tuple(ROUTE_DEP_ADDRESS, SAI_NULL_OBJECT_ID, sai_serialize_ip_prefix(prefix));
+
+    auto& routes = m_routes[key];
+
+    if (routes.empty())
+    {
+        m_addressPrefixLengths[std::make_pair(destination.addr_family, len)]++;
+    }
+
+    routes.insert(serializedRouteEntry);
+    m_routeDeps[serializedRouteEntry] = key;
+}
+
+void PendingRoutes::erase(
+        _In_ RouteMap::iterator it)
+{
+    SWSS_LOG_ENTER();
+
+    if (std::get<0>(it->first) == ROUTE_DEP_ADDRESS)
+    {
+        sai_ip_prefix_t prefix;
+
+        sai_deserialize_ip_prefix(std::get<2>(it->first), prefix);
+
+        auto lit = m_addressPrefixLengths.find(std::make_pair(prefix.addr_family, prefix_length(prefix)));
+
+        if (lit != m_addressPrefixLengths.end() && --lit->second == 0)
+        {
+            m_addressPrefixLengths.erase(lit);
+        }
+    }
+
+    m_routes.erase(it);
+}
+
+bool PendingRoutes::cancel(
+        _In_ const std::string& serializedRouteEntry)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_routeDeps.find(serializedRouteEntry);
+
+    if (it == m_routeDeps.end())
+    {
+        return false;
+    }
+
+    auto routes = m_routes.find(it->second);
+
+    if (routes != m_routes.end())
+    {
+        routes->second.erase(serializedRouteEntry);
+
+        if (routes->second.empty())
+        {
+            erase(routes);
+        }
+    }
+
+    m_routeDeps.erase(it);
+
+    return true;
+}
+
+bool PendingRoutes::isPending(
+        _In_ const std::string& serializedRouteEntry) const
+{
+    SWSS_LOG_ENTER();
+
+    return m_routeDeps.find(serializedRouteEntry) != m_routeDeps.end();
+}
+
+std::set<std::string> PendingRoutes::take(
+        _In_ route_dep_t dep,
+        _In_ sai_object_id_t depId)
+{
+    SWSS_LOG_ENTER();
+
+    std::set<std::string> routes;
+
+    auto it = m_routes.find(std::make_tuple(dep, depId, std::string()));
+
+    if (it == m_routes.end())
+    {
+        return routes;
+    }
+
+    routes = std::move(it->second);
+
+    erase(it);
+
+    for (auto& route: routes)
+    {
+        m_routeDeps.erase(route);
+    }
+
+    return routes;
+}
+
+std::set<std::string> PendingRoutes::takeForAddress(
+        _In_ const sai_ip_address_t& ip)
+{
+    SWSS_LOG_ENTER();
+
+    std::set<std::string> routes;
+
+    std::vector<uint32_t> lengths;
+
+    for (auto& kvp: m_addressPrefixLengths)
+    {
+        if (kvp.first.first == ip.addr_family)
+        {
+            lengths.push_back(kvp.first.second);
+        }
+    }
+
+    for (auto len: lengths)
+    {
+        auto prefix = make_prefix(ip.addr_family, ip.addr, len);
+
+        auto it = m_routes.find(std::make_tuple(ROUTE_DEP_ADDRESS, SAI_NULL_OBJECT_ID, sai_serialize_ip_prefix(prefix)));
+
+        if (it == m_routes.end())
+        {
+            continue;
+        }
+
+        for (auto& route: it->second)
+        {
+            m_routeDeps.erase(route);
+
+            routes.insert(route);
+        }
+
+        erase(it);
+    }
+
+    return routes;
+}
+
+bool PendingRoutes::hasAddressRoutes() const
+{
+    SWSS_LOG_ENTER();
+
+    return !m_addressPrefixLengths.empty();
+}
+
+size_t PendingRoutes::size() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_routeDeps.size();
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+extern "C" {
+#include "sai.h"
+}
+
+#include "swss/sal.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace saivpp
+{
+    /*
+     * Routes which can't be programmed in VPP yet, keyed by the missing
+     * dependency, so they are only retried once the event resolving it
+     * happens.
+     */
+    class PendingRoutes
+    {
+        public:
+
+            typedef enum _route_dep_t
+            {
+                ROUTE_DEP_NONE,
+
+                ROUTE_DEP_VRF, // VPP table of the virtual router
+
+                ROUTE_DEP_RIF, // router interface of the next hop
+
+                ROUTE_DEP_NEXT_HOP, // next hop or group VPP can't resolve yet
+
+                ROUTE_DEP_ADDRESS, // host interface address in the route prefix
+
+            } route_dep_t;
+
+            static const char *depName(
+                    _In_ route_dep_t dep);
+
+        public:
+
+            PendingRoutes() = default;
+
+            virtual ~PendingRoutes() = default;
+
+        public:
+
+            /*
+             * A route already pending is moved to the new dependency.
+             */
+            void defer(
+                    _In_ const std::string& serializedRouteEntry,
+                    _In_ route_dep_t dep,
+                    _In_ sai_object_id_t depId);
+
+            /*
+             * Defers the route on ROUTE_DEP_ADDRESS, indexed by its
+             * destination prefix.
+             */
+            void deferAddress(
+                    _In_ const std::string& serializedRouteEntry,
+                    _In_ const sai_ip_prefix_t& destination);
+
+            bool cancel(
+                    _In_ const std::string& serializedRouteEntry);
+
+            bool isPending(
+                    _In_ const std::string& serializedRouteEntry) const;
+
+            /*
+             * Removes and returns the routes waiting for the dependency.
+             */
+            std::set<std::string> take(
+                    _In_ route_dep_t dep,
+                    _In_ sai_object_id_t depId);
+
+            /*
+             * Removes and returns the routes waiting for an address whose
+             * prefix contains ip, only the prefix lengths with pending routes
+             * are looked up.
+             */
+            std::set<std::string> takeForAddress(
+                    _In_ const sai_ip_address_t& ip);
+
+            bool hasAddressRoutes() const;
+
+            size_t size() const;
+
+        private:
+
+            /*
+             * Prefix is the serialized destination for ROUTE_DEP_ADDRESS and
+             * empty for the other dependencies.
+             */
+            typedef std::tuple<route_dep_t, sai_object_id_t, std::string> Dependency;
+
+            typedef std::map<Dependency, std::set<std::string>> RouteMap;
+
+            void erase(
+                    _In_ RouteMap::iterator it);
+
+            RouteMap m_routes;
+
+            std::unordered_map<std::string, Dependency> m_routeDeps;
+
+            /*
+             * Number of ROUTE_DEP_ADDRESS prefixes per family and prefix
+             * length.
+             */
+            std::map<std::pair<sai_ip_addr_family_t, uint32_t>, size_t> m_addressPrefixLengths;
+    };
+}
@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PuntSocket.h"
+#include "SelectableFd.h"
+
+#include "swss/logger.h"
+#include "swss/select.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <net/ethernet.h>
+#include <linux/if_ether.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+#include <inttypes.h>
+
+using namespace saivpp;
+
+// packets read with one recvmmsg
+#define SAI_VPP_PUNT_BATCH 32
+
+#define SAI_VPP_PUNT_BUFFER_SIZE (sizeof(vpp_punt_desc_t) + 9216 + ETH_HLEN)
+
+#define SAI_VPP_PUNT_RCVBUF (4 * 1024 * 1024)
+
+#define SAI_VPP_PUNT_STATS_INTERVAL std::chrono::seconds(10)
+
+PuntSocket::PuntSocket(
+        _In_ const std::string& clientPath,
+        _In_ const std::string& serverPath):
+    m_clientPath(clientPath),
+    m_serverPath(serverPath),
+    m_fd(-1),
+    m_runThread(false),
+    m_rxPackets(0),
+    m_rxBatches(0),
+    m_rxDelivered(0),
+    m_rxUnmatched(0),
+    m_txPackets(0),
+    m_txErrors(0),
+    m_lastRxPackets(0)
+{
+    SWSS_LOG_ENTER();
+
+    m_lastStatsTime = std::chrono::steady_clock::now();
+}
+
+PuntSocket::~PuntSocket()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_runThread)
+    {
+        m_runThread = false;
+
+        m_threadEvent.notify();
+
+        m_thread->join();
+    }
+
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+
+        unlink(m_clientPath.c_str());
+    }
+
+    SWSS_LOG_NOTICE("punt socket %s closed, rx %" PRIu64 " (delivered %" PRIu64 ", unmatched %" PRIu64 "), tx %" PRIu64 " (errors %" PRIu64 ")",
+            m_clientPath.c_str(), m_rxPackets, m_rxDelivered, m_rxUnmatched, m_txPackets.load(), m_txErrors.load());
+}
+
+bool PuntSocket::open()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_fd >= 0)
+    {
+        return true;
+    }
+
+    struct sockaddr_un addr;
+
+    if (m_clientPath.size() >= sizeof(addr.sun_path))
+    {
+        SWSS_LOG_ERROR("punt socket path too long: %s", m_clientPath.c_str());
+        return false;
+    }
+
+    m_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (m_fd < 0)
+    {
+        SWSS_LOG_ERROR("failed to create punt socket: %s", strerror(errno));
+        return false;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sun_family = AF_UNIX;
+
+    strncpy(addr.sun_path, m_clientPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    unlink(m_clientPath.c_str());
+
+    if (bind(m_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        SWSS_LOG_ERROR("failed to bind punt socket %s: %s", m_clientPath.c_str(), strerror(errno));
+
+        close(m_fd);
+        m_fd = -1;
+
+        return false;
+    }
+
+    int rcvbuf = SAI_VPP_PUNT_RCVBUF;
+
+    // absorbs bursts while a batch is delivered
+
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    m_runThread = true;
+
+    m_thread = std::make_shared<std::thread>(&PuntSocket::rxThreadProc, this);
+
+    SWSS_LOG_NOTICE("punt socket %s open, vpp side %s", m_clientPath.c_str(), m_serverPath.c_str());
+
+    return true;
+}
+
+const std::string& PuntSocket::getClientPath() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_clientPath;
+}
+
+void PuntSocket::setServerPath(
+        _In_ const std::string& serverPath)
+{
+    SWSS_LOG_ENTER();
+
+    m_serverPath = serverPath;
+}
+
+bool PuntSocket::inject(
+        _In_ uint32_t swIfIndex,
+        _In_ uint32_t action,
+        _In_ const uint8_t *data,
+        _In_ size_t size)
+{
+    SWSS_LOG_ENTER();
+
+    if (!open())
+    {
+        return false;
+    }
+
+    struct sockaddr_un addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sun_family = AF_UNIX;
+
+    strncpy(addr.sun_path, m_serverPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    vpp_punt_desc_t desc;
+
+    desc.sw_if_index = swIfIndex;
+    desc.action = action;
+
+    struct iovec iov[2];
+
+    iov[0].iov_base = &desc;
+    iov[0].iov_len = sizeof(desc);
+    iov[1].iov_base = const_cast<uint8_t*>(data);
+    iov[1].iov_len = size;
+
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    if (sendmsg(m_fd, &msg, 0) < 0)
+    {
+        m_txErrors++;
+
+        SWSS_LOG_ERROR("failed to inject %zu bytes on sw_if_index %u through %s: %s",
+                size, swIfIndex, m_serverPath.c_str(), strerror(errno));
+
+        return false;
+    }
+
+    m_txPackets++;
+
+    return true;
+}
+
+std::shared_ptr<GenetlinkChannel> PuntSocket::getChannel(
+        _In_ const std::string& family,
+        _In_ const std::string& mcgrp)
+{
+    SWSS_LOG_ENTER();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto key = std::make_pair(family, mcgrp);
+
+    auto it = m_channels.find(key);
+
+    if (it != m_channels.end())
+    {
+        return it->second;
+    }
+
+    auto channel = std::make_shared<GenetlinkChannel>(family, mcgrp);
+
+    if (!channel->open())
+    {
+        return nullptr;
+    }
+
+    m_channels[key] = channel;
+
+    return channel;
+}
+
+bool PuntSocket::addTrap(
+        _In_ const vpp_punt_t& punt,
+        _In_ uint32_t trapType,
+        _In_ std::shared_ptr<GenetlinkChannel> channel)
+{
+    SWSS_LOG_ENTER();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_traps.find(PuntKey(punt.is_ipv6, punt.protocol, punt.port));
+
+    if (it != m_traps.end())
+    {
+        it->second.m_trapType = trapType;
+        it->second.m_channel = channel;
+        it->second.m_refCount++;
+
+        return false;
+    }
+
+    Trap trap;
+
+    trap.m_trapType = trapType;
+    trap.m_channel = channel;
+    trap.m_refCount = 1;
+
+    m_traps[PuntKey(punt.is_ipv6, punt.protocol, punt.port)] = trap;
+
+    return true;
+}
+
+bool PuntSocket::removeTrap(
+        _In_ const vpp_punt_t& punt)
+{
+    SWSS_LOG_ENTER();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_traps.find(PuntKey(punt.is_ipv6, punt.protocol, punt.port));
+
+    if (it == m_traps.end())
+    {
+        return false;
+    }
+
+    if (--it->second.m_refCount)
+    {
+        return false;
+    }
+
+    m_traps.erase(it);
+
+    return true;
+}
+
+void PuntSocket::setInterface(
+        _In_ uint32_t swIfIndex,
+        _In_ uint32_t ifindex)
+{
+    SWSS_LOG_ENTER();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_ifindex[swIfIndex] = ifindex;
+}
+
+void PuntSocket::rxThreadProc()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("begin");
+
+    std::vector<uint8_t> buffers(SAI_VPP_PUNT_BATCH * SAI_VPP_PUNT_BUFFER_SIZE);
+
+    struct mmsghdr msgs[SAI_VPP_PUNT_BATCH];
+    struct iovec iovs[SAI_VPP_PUNT_BATCH];
+
+    swss::Select s;
+    SelectableFd fd(m_fd);
+
+    s.addSelectable(&m_threadEvent);
+    s.addSelectable(&fd);
+
+    while (m_runThread)
+    {
+        swss::Selectable *sel = nullptr;
+
+        int result = s.select(&sel, 1000);
+
+        if (result == swss::Select::TIMEOUT)
+        {
+            logStats();
+            continue;
+        }
+
+        if (result != swss::Select::OBJECT)
+        {
+            SWSS_LOG_ERROR("selectable failed: %d, ending thread for %s", result, m_clientPath.c_str());
+            break;
+        }
+
+        if (sel == &m_threadEvent) // thread end event
+            break;
+
+        memset(msgs, 0, sizeof(msgs));
+
+        for (int i = 0; i < SAI_VPP_PUNT_BATCH; i++)
+        {
+            iovs[i].iov_base = &buffers[i * SAI_VPP_PUNT_BUFFER_SIZE];
+            iovs[i].iov_len = SAI_VPP_PUNT_BUFFER_SIZE;
+
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int count = recvmmsg(m_fd, msgs, SAI_VPP_PUNT_BATCH, MSG_DONTWAIT, NULL);
+
+        if (count <= 0)
+        {
+            if (count < 0 && errno != EAGAIN && errno != EINTR)
+            {
+                SWSS_LOG_ERROR("failed to read from punt socket %s: %s", m_clientPath.c_str(), strerror(errno));
+            }
+
+            continue;
+        }
+
+        m_rxBatches++;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (int i = 0; i < count; i++)
+        {
+            processPacket(&buffers[i * SAI_VPP_PUNT_BUFFER_SIZE], msgs[i].msg_len);
+        }
+
+        for (auto& kvp: m_channels)
+        {
+            m_rxDelivered += kvp.second->flush();
+        }
+
+        logStats();
+    }
+
+    SWSS_LOG_NOTICE("end");
+}
+
+void PuntSocket::processPacket(
+        _In_ const uint8_t *data,
+        _In_ size_t size)
+{
+    SWSS_LOG_ENTER();
+
+    m_rxPackets++;
+
+    if (size < sizeof(vpp_punt_desc_t) + 1)
+    {
+        m_rxUnmatched++;
+        return;
+    }
+
+    vpp_punt_desc_t desc;
+
+    memcpy(&desc, data, sizeof(desc));
+
+    const uint8_t *pkt = data + sizeof(desc);
+    const uint8_t *end = data + size;
+
+    /*
+     * VPP punts the packets of an UDP port or IP protocol from the IP
+     * header, frames with an ethernet header are accepted as well.
+     */
+
+    const uint8_t *ip = pkt;
+
+    uint8_t version = ip[0] >> 4;
+
+    if (version != 4 && version != 6)
+    {
+        if (end - pkt < ETH_HLEN)
+        {
+            m_rxUnmatched++;
+            return;
+        }
+
+        ip = pkt + ETH_HLEN;
+
+        uint16_t ethertype = (uint16_t)((pkt[12] << 8) | pkt[13]);
+
+        while (ethertype == ETHERTYPE_VLAN && end - ip >= 4)
+        {
+            ethertype = (uint16_t)((ip[2] << 8) | ip[3]);
+            ip += 4;
+        }
+
+        if (ip >= end)
+        {
+            m_rxUnmatched++;
+            return;
+        }
+
+        version = ip[0] >> 4;
+    }
+
+    uint8_t protocol;
+    const uint8_t *l4;
+
+    if (version == 4 && end - ip >= 20)
+    {
+        protocol = ip[9];
+        l4 = ip + (ip[0] & 0xf) * 4;
+    }
+    else if (version == 6 && end - ip >= 40)
+    {
+        protocol = ip[6];
+        l4 = ip + 40;
+    }
+    else
+    {
+        m_rxUnmatched++;
+        return;
+    }
+
+    bool isIpv6 = (version == 6);
+
+    uint16_t port = 0;
+
+    if (protocol == IPPROTO_UDP && end - l4 >= 4)
+    {
+        port = (uint16_t)((l4[2] << 8) | l4[3]);
+    }
+
+    auto it = m_traps.find(PuntKey(isIpv6, protocol, port));
+
+    if (it == m_traps.end())
+    {
+        it = m_traps.find(PuntKey(isIpv6, protocol, 0));
+    }
+
+    if (it == m_traps.end() || it->second.m_channel == nullptr)
+    {
+        m_rxUnmatched++;
+        return;
+    }
+
+    GenetlinkChannel::PacketMetadata meta;
+
+    meta.m_trapType = it->second.m_trapType;
+
+    auto iit = m_ifindex.find(desc.sw_if_index);
+
+    meta.m_ingressIfindex = (iit == m_ifindex.end()) ? 0 : iit->second;
+
+    if (ip != pkt)
+    {
+        meta.m_origSize = (uint32_t)(end - pkt);
+
+        it->second.m_channel->add(meta, pkt, end - pkt);
+        return;
+    }
+
+    // genetlink listeners expect an ethernet frame
+
+    uint8_t frame[SAI_VPP_PUNT_BUFFER_SIZE];
+
+    memset(frame, 0, ETH_HLEN);
+
+    frame[12] = isIpv6 ? (ETHERTYPE_IPV6 >> 8) : (ETHERTYPE_IP >> 8);
+    frame[13] = isIpv6 ? (ETHERTYPE_IPV6 & 0xff) : (ETHERTYPE_IP & 0xff);
+
+    memcpy(frame + ETH_HLEN, pkt, end - pkt);
+
+    meta.m_origSize = (uint32_t)(ETH_HLEN + (end - pkt));
+
+    it->second.m_channel->add(meta, frame, meta.m_origSize);
+}
+
+void PuntSocket::logStats()
+{
+    SWSS_LOG_ENTER();
+
+    auto now = std::chrono::steady_clock::now();
+
+    auto elapsed = now - m_lastStatsTime;
+
+    if (elapsed < SAI_VPP_PUNT_STATS_INTERVAL)
+    {
+        return;
+    }
+
+    if (m_rxPackets != m_lastRxPackets)
+    {
+        double secs = std::chrono::duration<double>(elapsed).count();
+
+        SWSS_LOG_INFO("punt rx %.0f pps, %" PRIu64 " packets in %" PRIu64 " batches, delivered %" PRIu64 ", unmatched %" PRIu64 ", tx %" PRIu64 " (errors %" PRIu64 ")",
+                (double)(m_rxPackets - m_lastRxPackets) / secs,
+                m_rxPackets, m_rxBatches, m_rxDelivered, m_rxUnmatched, m_txPackets.load(), m_txErrors.load());
+    }
+
+    m_lastRxPackets = m_rxPackets;
+    m_lastStatsTime = now;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "GenetlinkChannel.h"
+#include "vppxlate/SaiVppXlate.h"
+
+#include "swss/sal.h"
+#include "swss/selectableevent.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+namespace saivpp
+{
+    /*
+     * Client side of the VPP punt socket. Packets punted by VPP for a
+     * registered trap are read in batches by a thread and delivered on the
+     * genetlink channel of the trap, packets sent by SAI are injected into
+     * VPP through the same socket.
+     */
+    class PuntSocket
+    {
+        private:
+
+            PuntSocket(const PuntSocket&) = delete;
+            PuntSocket& operator=(const PuntSocket&) = delete;
+
+        public:
+
+            PuntSocket(
+                    _In_ const std::string& clientPath,
+                    _In_ const std::string& serverPath);
+
+            virtual ~PuntSocket();
+
+        public:
+
+            /*
+             * Binds the client socket and starts the receive thread.
+             */
+            bool open();
+
+            const std::string& getClientPath() const;
+
+            void setServerPath(
+                    _In_ const std::string& serverPath);
+
+            bool inject(
+                    _In_ uint32_t swIfIndex,
+                    _In_ uint32_t action,
+                    _In_ const uint8_t *data,
+                    _In_ size_t size);
+
+            std::shared_ptr<GenetlinkChannel> getChannel(
+                    _In_ const std::string& family,
+                    _In_ const std::string& mcgrp);
+
+            /*
+             * Table entries can punt the same (af, proto, port), so traps
+             * are refcounted. Returns true for the first reference, which
+             * needs the VPP registration.
+             */
+            bool addTrap(
+                    _In_ const vpp_punt_t& punt,
+                    _In_ uint32_t trapType,
+                    _In_ std::shared_ptr<GenetlinkChannel> channel);
+
+            /*
+             * Returns true when the last reference was removed, the VPP
+             * registration can be dropped then.
+             */
+            bool removeTrap(
+                    _In_ const vpp_punt_t& punt);
+
+            void setInterface(
+                    _In_ uint32_t swIfIndex,
+                    _In_ uint32_t ifindex);
+
+        private:
+
+            void rxThreadProc();
+
+            void processPacket(
+                    _In_ const uint8_t *data,
+                    _In_ size_t size);
+
+            void logStats();
+
+        private:
+
+            typedef std::tuple<bool, uint8_t, uint16_t> PuntKey;
+
+            typedef struct _Trap
+            {
+                uint32_t m_trapType;
+
+                std::shared_ptr<GenetlinkChannel> m_channel;
+
+                uint32_t m_refCount;
+
+            } Trap;
+
+            std::string m_clientPath;
+
+            std::string m_serverPath;
+
+            int m_fd;
+
+            std::mutex m_mutex;
+
+            std::map<PuntKey, Trap> m_traps;
+
+            std::map<std::pair<std::string, std::string>, std::shared_ptr<GenetlinkChannel>> m_channels;
+
+            // host netdev by VPP rx interface
+            std::unordered_map<uint32_t, uint32_t> m_ifindex;
+
+            bool m_runThread;
+
+            swss::SelectableEvent m_threadEvent;
+
+            std::shared_ptr<std::thread> m_thread;
+
+        private: // counters, rx ones are only updated by the thread
+
+            uint64_t m_rxPackets;
+
+            uint64_t m_rxBatches;
+
+            uint64_t m_rxDelivered;
+
+            uint64_t m_rxUnmatched;
+
+            // tx ones are updated by the api threads sending packets
+
+            std::atomic<uint64_t> m_txPackets;
+
+            std::atomic<uint64_t> m_txErrors;
+
+            uint64_t m_lastRxPackets;
+
+            std::chrono::steady_clock::time_point m_lastStatsTime;
+    };
+}
@@ -255,6 +255,62 @@ sai_object_id_t RealObjectIdManager::allocateNewObjectId(
     return objectId;
 }
 
+std::vector<sai_object_id_t> RealObjectIdManager::allocateNewObjectIds(
+        _In_ sai_object_type_t objectType,
+        _In_ sai_object_id_t switchId,
+        _In_ size_t count)
+{
+    SWSS_LOG_ENTER();
+
+    if ((objectType <= SAI_OBJECT_TYPE_NULL) || (objectType >= SAI_OBJECT_TYPE_EXTENSIONS_MAX))
+    {
+        SWSS_LOG_THROW("invalid objct type: %d", objectType);
+    }
+
+    if (objectType == SAI_OBJECT_TYPE_SWITCH)
+    {
+        SWSS_LOG_THROW("this function can't be used to allocate switch id");
+    }
+
+    sai_object_type_t switchObjectType = saiObjectTypeQuery(switchId);
+
+    if (switchObjectType != SAI_OBJECT_TYPE_SWITCH)
+    {
+        SWSS_LOG_THROW("object type of switch %s is %s, should be SWITCH",
+                sai_serialize_object_id(switchId).c_str(),
+                sai_serialize_object_type(switchObjectType).c_str());
+    }
+
+    uint32_t switchIndex = (uint32_t)SAI_VPP_GET_SWITCH_INDEX(switchId);
+
+    uint64_t firstIndex = m_indexer[objectType];
+
+    if (count && (firstIndex + count - 1) > SAI_VPP_OBJECT_INDEX_MAX)
+    {
+        SWSS_LOG_THROW("no more object indexes available, requested 0x%lx from 0x%lx but limit is 0x%llx",
+                (uint64_t)count,
+                firstIndex,
+                SAI_VPP_OBJECT_INDEX_MAX);
+    }
+
+    m_indexer[objectType] += count; // allocation !
+
+    std::vector<sai_object_id_t> objectIds;
+
+    objectIds.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        objectIds.push_back(constructObjectId(objectType, switchIndex, firstIndex + i, m_globalContext));
+    }
+
+    SWSS_LOG_DEBUG("created %zu RIDs of type %s",
+            count,
+            sai_serialize_object_type(objectType).c_str());
+
+    return objectIds;
+}
+
 sai_object_id_t RealObjectIdManager::allocateNewSwitchObjectId(
         _In_ const std::string& hardwareInfo)
 {
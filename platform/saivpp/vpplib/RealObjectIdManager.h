@@ -23,6 +23,7 @@ extern "C" {
 
 #include <set>
 #include <map>
+#include <vector>
 
 namespace saivpp
 {
@@ -79,6 +80,17 @@ namespace saivpp
                     _In_ sai_object_type_t objectType,
                     _In_ sai_object_id_t switchId);
 
+            /**
+             * @brief Allocate range of new object ids on a given switch.
+             *
+             * All object indexes are reserved in one step. Same restrictions
+             * apply as for allocateNewObjectId.
+             */
+            std::vector<sai_object_id_t> allocateNewObjectIds(
+                    _In_ sai_object_type_t objectType,
+                    _In_ sai_object_id_t switchId,
+                    _In_ size_t count);
+
             /**
              * @brief Allocate new switch object id.
              */
@@ -72,4 +72,80 @@ void ResourceLimiter::clearLimits()
     SWSS_LOG_ENTER();
 
     m_objectTypeLimits.clear();
+
+    m_resourceLimits.clear();
+}
+
+size_t ResourceLimiter::getResourceLimit(
+        _In_ resource_t resource) const
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_resourceLimits.find(resource);
+
+    if (it != m_resourceLimits.end())
+    {
+        return it->second;
+    }
+
+    // default limit is maximum
+
+    return SIZE_MAX;
+}
+
+void ResourceLimiter::setResourceLimit(
+        _In_ resource_t resource,
+        _In_ size_t limit)
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("setting %s limit to %zu",
+            serializeResource(resource).c_str(),
+            limit);
+
+    m_resourceLimits[resource] = limit;
+}
+
+static const std::map<std::string, ResourceLimiter::resource_t> g_resourceNames = {
+    { "VPP_IPV4_ROUTE_ENTRY",               ResourceLimiter::RESOURCE_IPV4_ROUTE_ENTRY },
+    { "VPP_IPV6_ROUTE_ENTRY",               ResourceLimiter::RESOURCE_IPV6_ROUTE_ENTRY },
+    { "VPP_VRF_ROUTE_ENTRY",                ResourceLimiter::RESOURCE_VRF_ROUTE_ENTRY },
+    { "VPP_IPV4_NEIGHBOR_ENTRY",            ResourceLimiter::RESOURCE_IPV4_NEIGHBOR_ENTRY },
+    { "VPP_IPV6_NEIGHBOR_ENTRY",            ResourceLimiter::RESOURCE_IPV6_NEIGHBOR_ENTRY },
+    { "VPP_SUB_PORT_ROUTER_INTERFACE",      ResourceLimiter::RESOURCE_SUB_PORT_ROUTER_INTERFACE },
+    { "VPP_HEAP_USAGE_PERCENT",             ResourceLimiter::RESOURCE_VPP_HEAP_USAGE_PERCENT },
+};
+
+bool ResourceLimiter::deserializeResource(
+        _In_ const std::string& name,
+        _Out_ resource_t& resource)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = g_resourceNames.find(name);
+
+    if (it == g_resourceNames.end())
+    {
+        return false;
+    }
+
+    resource = it->second;
+
+    return true;
+}
+
+std::string ResourceLimiter::serializeResource(
+        _In_ resource_t resource)
+{
+    SWSS_LOG_ENTER();
+
+    for (auto& kvp: g_resourceNames)
+    {
+        if (kvp.second == resource)
+        {
+            return kvp.first;
+        }
+    }
+
+    return std::to_string(resource);
 }
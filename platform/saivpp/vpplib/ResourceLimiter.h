@@ -20,6 +20,7 @@ extern "C" {
 }
 
 #include <map>
+#include <string>
 
 namespace saivpp
 {
@@ -29,6 +30,28 @@ namespace saivpp
 
             constexpr static uint32_t DEFAULT_SWITCH_INDEX = 0;
 
+            /*
+             * Capacity of VPP side resources, which are not bounded by the
+             * number of objects of a single object type.
+             */
+            typedef enum _resource_t
+            {
+                RESOURCE_IPV4_ROUTE_ENTRY,
+
+                RESOURCE_IPV6_ROUTE_ENTRY,
+
+                RESOURCE_VRF_ROUTE_ENTRY, // routes in each virtual router
+
+                RESOURCE_IPV4_NEIGHBOR_ENTRY,
+
+                RESOURCE_IPV6_NEIGHBOR_ENTRY,
+
+                RESOURCE_SUB_PORT_ROUTER_INTERFACE,
+
+                RESOURCE_VPP_HEAP_USAGE_PERCENT, // of the VPP main heap
+
+            } resource_t;
+
         public:
 
             ResourceLimiter(
@@ -50,10 +73,28 @@ namespace saivpp
 
             void clearLimits();
 
+            size_t getResourceLimit(
+                    _In_ resource_t resource) const;
+
+            void setResourceLimit(
+                    _In_ resource_t resource,
+                    _In_ size_t limit);
+
+        public:
+
+            static bool deserializeResource(
+                    _In_ const std::string& name,
+                    _Out_ resource_t& resource);
+
+            static std::string serializeResource(
+                    _In_ resource_t resource);
+
         private:
 
             uint32_t m_switchIndex;
 
             std::map<sai_object_type_t, size_t> m_objectTypeLimits;
+
+            std::map<resource_t, size_t> m_resourceLimits;
     };
 }
@@ -63,6 +63,10 @@ std::shared_ptr<ResourceLimiterContainer> ResourceLimiterParser::parseFromFile(
          *
          * where N is switchIndex (0..255) - SAI_VPP_SWITCH_INDEX_MAX
          * if N is not specified then zero (0) is assumed
+         *
+         * instead of object type, VPP side capacity can be limited by
+         * resource name, like VPP_VRF_ROUTE_ENTRY=limit, see
+         * ResourceLimiter::resource_t
          */
 
         if (line.size() > 0 && (line[0] == '#' || line[0] == ';'))
@@ -140,18 +144,6 @@ void ResourceLimiterParser::parse(
 {
     SWSS_LOG_ENTER();
 
-    sai_object_type_t objectType;
-
-    try
-    {
-        sai_deserialize_object_type(strObjectType, objectType);
-    }
-    catch(const std::exception& e)
-    {
-        SWSS_LOG_ERROR("failed to deserialize '%s' as object type: %s", strObjectType.c_str(), e.what());
-        return;
-    }
-
     size_t limit;
 
     if (sscanf(strLimit.c_str(), "%zu", &limit) != 1)
@@ -169,6 +161,31 @@ void ResourceLimiterParser::parse(
         container->insert(switchIndex, limiter);
     }
 
+    ResourceLimiter::resource_t resource;
+
+    if (ResourceLimiter::deserializeResource(strObjectType, resource))
+    {
+        SWSS_LOG_NOTICE("adding limit on switch index %u, %s = %zu",
+                switchIndex,
+                strObjectType.c_str(),
+                limit);
+
+        limiter->setResourceLimit(resource, limit);
+        return;
+    }
+
+    sai_object_type_t objectType;
+
+    try
+    {
+        sai_deserialize_object_type(strObjectType, objectType);
+    }
+    catch(const std::exception& e)
+    {
+        SWSS_LOG_ERROR("failed to deserialize '%s' as object type: %s", strObjectType.c_str(), e.what());
+        return;
+    }
+
     SWSS_LOG_NOTICE("adding limit on switch index %u, %s = %zu",
             switchIndex,
             sai_serialize_object_type(objectType).c_str(),
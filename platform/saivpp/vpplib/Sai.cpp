@@ -55,6 +55,8 @@ Sai::Sai()
 
     m_fdbAgingThreadRun = false;
 
+    m_counterStreamThreadRun = false;
+
     m_eventQueueThreadRun = false;
 
     m_apiInitialized = false;
@@ -171,6 +173,24 @@ sai_status_t Sai::initialize(
 
     SWSS_LOG_NOTICE("hostif use TAP device: %s", (useTapDevice ? "true" : "false"));
 
+    sai_vpp_hostif_offload_t hostifOffload;
+
+    if (!SwitchConfig::parseHostifOffload(service_method_table->profile_get_value(0, SAI_KEY_VPP_HOSTIF_OFFLOAD), hostifOffload))
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    const char *vppApiSocket = service_method_table->profile_get_value(0, SAI_KEY_VPP_API_SOCKET);
+
+    const char *vppStatsSocket = service_method_table->profile_get_value(0, SAI_KEY_VPP_STATS_SOCKET);
+
+    const char *vppPuntSocket = service_method_table->profile_get_value(0, SAI_KEY_VPP_PUNT_SOCKET);
+
+    m_counterStream = CounterStream::create(
+            service_method_table->profile_get_value(0, SAI_KEY_VPP_COUNTER_STREAM_INTERVAL),
+            service_method_table->profile_get_value(0, SAI_KEY_VPP_COUNTER_STREAM_RATE_LIMIT),
+            service_method_table->profile_get_value(0, SAI_KEY_VPP_COUNTER_STREAM_CPU_BUDGET));
+
     auto cstrGlobalContext = service_method_table->profile_get_value(0, SAI_KEY_VPP_GLOBAL_CONTEXT);
 
     m_globalContext = 0;
@@ -235,6 +255,26 @@ sai_status_t Sai::initialize(
         sc->m_switchType = switchType;
         sc->m_bootType = bootType;
         sc->m_useTapDevice = useTapDevice;
+        sc->m_hostifOffload = hostifOffload;
+
+        if (sc->m_vppApiSocket.empty() && vppApiSocket)
+        {
+            sc->m_vppApiSocket = vppApiSocket;
+        }
+
+        if (sc->m_vppStatsSocket.empty() && vppStatsSocket)
+        {
+            sc->m_vppStatsSocket = vppStatsSocket;
+        }
+
+        if (sc->m_vppPuntSocket.empty() && vppPuntSocket)
+        {
+            sc->m_vppPuntSocket = vppPuntSocket;
+        }
+
+        SWSS_LOG_NOTICE("switch index %u vpp api socket: '%s', stats socket: '%s'",
+                sc->m_switchIndex, sc->m_vppApiSocket.c_str(), sc->m_vppStatsSocket.c_str());
+
         sc->m_laneMap = m_laneMapContainer->getLaneMap(sc->m_switchIndex);
 
         if (sc->m_laneMap == nullptr)
@@ -286,6 +326,11 @@ sai_status_t Sai::initialize(
         startFdbAgingThread();
     }
 
+    if (m_counterStream)
+    {
+        startCounterStreamThread();
+    }
+
     m_apiInitialized = true;
 
     return SAI_STATUS_SUCCESS;
@@ -308,6 +353,8 @@ sai_status_t Sai::uninitialize(void)
 
     stopFdbAgingThread();
 
+    stopCounterStreamThread();
+
     stopEventQueueThread();
 
     // at this point packets may still arrive on hostif but event queue thread
@@ -551,7 +598,16 @@ sai_status_t Sai::bulkGetStats(
     SWSS_LOG_ENTER();
     VPP_CHECK_API_INITIALIZED();
 
-    return SAI_STATUS_NOT_IMPLEMENTED;
+    return m_meta->bulkGetStats(
+            switchId,
+            object_type,
+            object_count,
+            object_key,
+            number_of_counters,
+            counter_ids,
+            mode,
+            object_statuses,
+            counters);
 }
 
 sai_status_t Sai::bulkClearStats(
@@ -568,7 +624,15 @@ sai_status_t Sai::bulkClearStats(
     SWSS_LOG_ENTER();
     VPP_CHECK_API_INITIALIZED();
 
-    return SAI_STATUS_NOT_IMPLEMENTED;
+    return m_meta->bulkClearStats(
+            switchId,
+            object_type,
+            object_count,
+            object_key,
+            number_of_counters,
+            counter_ids,
+            mode,
+            object_statuses);
 }
 
 // BULK QUAD OID
@@ -724,6 +788,32 @@ sai_status_t Sai::flushFdbEntries(
             attr_list);
 }
 
+sai_status_t Sai::sendHostifPacket(
+        _In_ sai_object_id_t hostifId,
+        _In_ sai_size_t bufferSize,
+        _In_ const void *buffer,
+        _In_ uint32_t attrCount,
+        _In_ const sai_attribute_t *attrList)
+{
+    MUTEX();
+    SWSS_LOG_ENTER();
+    VPP_CHECK_API_INITIALIZED();
+
+    if (buffer == NULL || (attrCount && attrList == NULL))
+    {
+        SWSS_LOG_ERROR("buffer or attribute list is NULL");
+
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return m_vsSai->sendHostifPacket(
+            hostifId,
+            bufferSize,
+            buffer,
+            attrCount,
+            attrList);
+}
+
 // SAI API
 
 sai_status_t Sai::objectTypeGetAvailability(
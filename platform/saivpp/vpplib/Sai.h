@@ -19,9 +19,11 @@
 #include "LaneMapContainer.h"
 #include "EventQueue.h"
 #include "EventPayloadNotification.h"
+#include "EventPayloadNetLinkMsgBatch.h"
 #include "ResourceLimiterContainer.h"
 #include "CorePortIndexMapContainer.h"
 #include "Context.h"
+#include "CounterStream.h"
 
 #include "meta/Meta.h"
 
@@ -165,6 +167,13 @@ namespace saivpp
                     _In_ uint32_t attrCount,
                     _In_ const sai_attribute_t *attrList) override;
 
+            sai_status_t sendHostifPacket(
+                    _In_ sai_object_id_t hostifId,
+                    _In_ sai_size_t bufferSize,
+                    _In_ const void *buffer,
+                    _In_ uint32_t attrCount,
+                    _In_ const sai_attribute_t *attrList);
+
         public: // SAI API
 
             virtual sai_status_t objectTypeGetAvailability(
@@ -242,6 +251,17 @@ namespace saivpp
 
             void stopFdbAgingThread();
 
+        private: // counter streaming
+
+            void collectCountersForStreaming(
+                    _Out_ std::vector<CounterStream::ObjectCounters>& counters);
+
+            void counterStreamThreadProc();
+
+            void startCounterStreamThread();
+
+            void stopCounterStreamThread();
+
         private: // event queue
 
             void startEventQueueThread();
@@ -259,6 +279,9 @@ namespace saivpp
             void syncProcessEventNetLinkMsg(
                     _In_ std::shared_ptr<EventPayloadNetLinkMsg> payload);
 
+            void syncProcessEventNetLinkMsgBatch(
+                    _In_ std::shared_ptr<EventPayloadNetLinkMsgBatch> payload);
+
             void asyncProcessEventNotification(
                     _In_ std::shared_ptr<EventPayloadNotification> payload);
 
@@ -282,6 +305,16 @@ namespace saivpp
 
             std::shared_ptr<std::thread> m_fdbAgingThread;
 
+        private: // counter streaming thread
+
+            bool m_counterStreamThreadRun;
+
+            std::shared_ptr<swss::SelectableEvent> m_counterStreamThreadEvent;
+
+            std::shared_ptr<std::thread> m_counterStreamThread;
+
+            std::shared_ptr<CounterStream> m_counterStream;
+
         private: // event queue
 
             bool m_eventQueueThreadRun;
@@ -18,6 +18,9 @@
 #include "swss/logger.h"
 #include "meta/sai_serialize.h"
 
+#include <algorithm>
+#include <type_traits>
+
 using namespace saivpp;
 
 SaiAttrWrap::SaiAttrWrap(
@@ -31,15 +34,22 @@ SaiAttrWrap::SaiAttrWrap(
     m_attr.id = attr->id;
 
     /*
-     * We are making serialize and deserialize to get copy of
-     * attribute, it may be a list so we need to allocate new memory.
+     * We are making copy of attribute, it may be a list so we need to
+     * allocate new memory.
      *
      * This copy will be used later to get previous value of attribute
      * if attribute will be updated. And if this attribute is oid list
      * then we need to release object reference count.
      */
 
-    m_value = sai_serialize_attr_value(*m_meta, *attr, false);
+    if (copyAttrValue(attr))
+    {
+        return;
+    }
+
+    // not handled value type, copy using serialize and deserialize
+
+    std::call_once(m_valueSerialized, [&] { m_value = sai_serialize_attr_value(*m_meta, *attr, false); });
 
     sai_deserialize_attr_value(m_value, *m_meta, m_attr, false);
 }
@@ -59,7 +69,7 @@ SaiAttrWrap::SaiAttrWrap(
 
     m_attr.id = m_meta->attrid;
 
-    m_value = attrValue;
+    std::call_once(m_valueSerialized, [&] { m_value = attrValue; });
 
     sai_deserialize_attr_value(attrValue.c_str(), *m_meta, m_attr, false);
 }
@@ -94,5 +104,197 @@ const std::string& SaiAttrWrap::getAttrStrValue() const
 {
     SWSS_LOG_ENTER();
 
+    // stats and notification threads may read the value concurrently
+
+    std::call_once(m_valueSerialized, [this] { m_value = sai_serialize_attr_value(*m_meta, m_attr, false); });
+
     return m_value;
 }
+
+template <typename T>
+static void copy_list(
+        _Out_ T& dst,
+        _In_ const T& src)
+{
+    SWSS_LOG_ENTER();
+
+    dst.count = src.count;
+    dst.list = NULL;
+
+    if (src.list == NULL || src.count == 0)
+    {
+        return;
+    }
+
+    // same allocator as sai_deserialize_*, released by sai_free_list
+
+    dst.list = new typename std::remove_reference<decltype(*src.list)>::type[src.count];
+
+    std::copy(src.list, src.list + src.count, dst.list);
+}
+
+bool SaiAttrWrap::copyAttrValue(
+        _In_ const sai_attribute_t *attr)
+{
+    SWSS_LOG_ENTER();
+
+    const sai_attribute_value_t &src = attr->value;
+
+    sai_attribute_value_t &dst = m_attr.value;
+
+    switch (m_meta->attrvaluetype)
+    {
+        case SAI_ATTR_VALUE_TYPE_BOOL:
+        case SAI_ATTR_VALUE_TYPE_CHARDATA:
+        case SAI_ATTR_VALUE_TYPE_UINT8:
+        case SAI_ATTR_VALUE_TYPE_INT8:
+        case SAI_ATTR_VALUE_TYPE_UINT16:
+        case SAI_ATTR_VALUE_TYPE_INT16:
+        case SAI_ATTR_VALUE_TYPE_UINT32:
+        case SAI_ATTR_VALUE_TYPE_INT32:
+        case SAI_ATTR_VALUE_TYPE_UINT64:
+        case SAI_ATTR_VALUE_TYPE_INT64:
+        case SAI_ATTR_VALUE_TYPE_POINTER:
+        case SAI_ATTR_VALUE_TYPE_MAC:
+        case SAI_ATTR_VALUE_TYPE_IPV4:
+        case SAI_ATTR_VALUE_TYPE_IPV6:
+        case SAI_ATTR_VALUE_TYPE_IP_ADDRESS:
+        case SAI_ATTR_VALUE_TYPE_IP_PREFIX:
+        case SAI_ATTR_VALUE_TYPE_OBJECT_ID:
+        case SAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+        case SAI_ATTR_VALUE_TYPE_INT32_RANGE:
+        case SAI_ATTR_VALUE_TYPE_TIMESPEC:
+        case SAI_ATTR_VALUE_TYPE_NAT_ENTRY_DATA:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_BOOL:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_UINT8:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_INT8:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_UINT16:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_INT16:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_UINT32:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_INT32:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_UINT64:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_MAC:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_IPV4:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_IPV6:
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_OBJECT_ID:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_BOOL:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_UINT8:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_INT8:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_UINT16:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_INT16:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_UINT32:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_INT32:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_MAC:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_IPV4:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_IPV6:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_IP_ADDRESS:
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_OBJECT_ID:
+
+            // no pointers inside, plain copy is deep copy
+            dst = src;
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            copy_list(dst.objlist, src.objlist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            copy_list(dst.u8list, src.u8list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_INT8_LIST:
+            copy_list(dst.s8list, src.s8list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            copy_list(dst.u16list, src.u16list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_INT16_LIST:
+            copy_list(dst.s16list, src.s16list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            copy_list(dst.u32list, src.u32list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_INT32_LIST:
+            copy_list(dst.s32list, src.s32list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_UINT16_RANGE_LIST:
+            copy_list(dst.u16rangelist, src.u16rangelist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_VLAN_LIST:
+            copy_list(dst.vlanlist, src.vlanlist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_QOS_MAP_LIST:
+            copy_list(dst.qosmap, src.qosmap);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_MAP_LIST:
+            copy_list(dst.maplist, src.maplist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_IP_ADDRESS_LIST:
+            copy_list(dst.ipaddrlist, src.ipaddrlist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_SEGMENT_LIST:
+            copy_list(dst.segmentlist, src.segmentlist);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_ACL_CAPABILITY:
+            dst.aclcapability.is_action_list_mandatory = src.aclcapability.is_action_list_mandatory;
+            copy_list(dst.aclcapability.action_list, src.aclcapability.action_list);
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_OBJECT_LIST:
+
+            dst.aclfield.enable = src.aclfield.enable;
+            dst.aclfield.data.objlist.count = 0;
+            dst.aclfield.data.objlist.list = NULL;
+
+            // list is only valid when field is enabled
+            if (src.aclfield.enable)
+            {
+                copy_list(dst.aclfield.data.objlist, src.aclfield.data.objlist);
+            }
+
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_ACL_FIELD_DATA_UINT8_LIST:
+
+            dst.aclfield.enable = src.aclfield.enable;
+            dst.aclfield.mask.u8list.count = 0;
+            dst.aclfield.mask.u8list.list = NULL;
+            dst.aclfield.data.u8list.count = 0;
+            dst.aclfield.data.u8list.list = NULL;
+
+            if (src.aclfield.enable)
+            {
+                copy_list(dst.aclfield.mask.u8list, src.aclfield.mask.u8list);
+                copy_list(dst.aclfield.data.u8list, src.aclfield.data.u8list);
+            }
+
+            return true;
+
+        case SAI_ATTR_VALUE_TYPE_ACL_ACTION_DATA_OBJECT_LIST:
+
+            dst.aclaction.enable = src.aclaction.enable;
+            dst.aclaction.parameter.objlist.count = 0;
+            dst.aclaction.parameter.objlist.list = NULL;
+
+            if (src.aclaction.enable)
+            {
+                copy_list(dst.aclaction.parameter.objlist, src.aclaction.parameter.objlist);
+            }
+
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -19,6 +19,7 @@ extern "C" {
 #include "saimetadata.h"
 }
 
+#include <mutex>
 #include <string>
 
 namespace saivpp
@@ -49,14 +50,34 @@ namespace saivpp
 
             const sai_attr_metadata_t* getAttrMetadata() const;
 
+            /**
+             * @brief Get serialized attribute value.
+             *
+             * Value is serialized on first call, create and set only keep
+             * binary copy of the attribute. Safe to call from several threads.
+             */
             const std::string& getAttrStrValue() const;
 
+        private:
+
+            /**
+             * @brief Deep copy attribute value into m_attr.
+             *
+             * Lists are allocated with new[] so they can be released by
+             * sai_deserialize_free_attribute_value. Returns false if value
+             * type is not handled and serialized copy must be used.
+             */
+            bool copyAttrValue(
+                    _In_ const sai_attribute_t *attr);
+
         private:
 
             const sai_attr_metadata_t *m_meta;
 
             sai_attribute_t m_attr;
 
-            std::string m_value;
+            mutable std::string m_value;
+
+            mutable std::once_flag m_valueSerialized;
     };
 }
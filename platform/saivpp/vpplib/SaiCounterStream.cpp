@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Microsoft, Inc.
+ * Modifications copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Sai.h"
+#include "SaiInternal.h"
+
+#include "swss/logger.h"
+#include "swss/select.h"
+
+#include <time.h>
+
+using namespace saivpp;
+
+static std::chrono::nanoseconds thread_cpu_time()
+{
+    SWSS_LOG_ENTER();
+
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    {
+        return std::chrono::nanoseconds(0);
+    }
+
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+void Sai::startCounterStreamThread()
+{
+    SWSS_LOG_ENTER();
+
+    m_counterStreamThreadEvent = std::make_shared<swss::SelectableEvent>();
+
+    m_counterStreamThreadRun = true;
+
+    m_counterStreamThread = std::make_shared<std::thread>(&Sai::counterStreamThreadProc, this);
+}
+
+void Sai::stopCounterStreamThread()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("begin");
+
+    if (m_counterStreamThreadRun)
+    {
+        m_counterStreamThreadRun = false;
+
+        m_counterStreamThreadEvent->notify();
+
+        m_counterStreamThread->join();
+    }
+
+    m_counterStream = nullptr;
+
+    SWSS_LOG_NOTICE("end");
+}
+
+void Sai::collectCountersForStreaming(
+        _Out_ std::vector<CounterStream::ObjectCounters>& counters)
+{
+    MUTEX();
+    SWSS_LOG_ENTER();
+
+    // must be executed under mutex since
+    // this call comes from other thread
+
+    m_vsSai->collectPortCounters(counters);
+}
+
+void Sai::counterStreamThreadProc()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("begin");
+
+    swss::Select s;
+
+    s.addSelectable(m_counterStreamThreadEvent.get());
+
+    uint32_t wait = m_counterStream->getInterval();
+
+    while (m_counterStreamThreadRun)
+    {
+        swss::Selectable *sel = nullptr;
+
+        int result = s.select(&sel, (int)wait);
+
+        if (sel == m_counterStreamThreadEvent.get())
+        {
+            // user requested shutdown_switch
+            break;
+        }
+
+        if (result != swss::Select::TIMEOUT)
+        {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto cpu = thread_cpu_time();
+
+        std::vector<CounterStream::ObjectCounters> counters;
+
+        collectCountersForStreaming(counters);
+
+        // redis writes are done outside of the api mutex
+
+        size_t written = m_counterStream->publish(counters);
+
+        SWSS_LOG_DEBUG("streamed counters of %zu of %zu ports", written, counters.size());
+
+        wait = m_counterStream->nextWaitMs(
+                std::chrono::steady_clock::now() - start,
+                thread_cpu_time() - cpu);
+    }
+
+    SWSS_LOG_NOTICE("end");
+}
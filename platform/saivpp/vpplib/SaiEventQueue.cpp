@@ -82,6 +82,9 @@ void Sai::processQueueEvent(
         case EVENT_TYPE_NET_LINK_MSG:
             return syncProcessEventNetLinkMsg(std::dynamic_pointer_cast<EventPayloadNetLinkMsg>(event->getPayload()));
 
+        case EVENT_TYPE_NET_LINK_MSG_BATCH:
+            return syncProcessEventNetLinkMsgBatch(std::dynamic_pointer_cast<EventPayloadNetLinkMsgBatch>(event->getPayload()));
+
         case EVENT_TYPE_NOTIFICATION:
             return asyncProcessEventNotification(std::dynamic_pointer_cast<EventPayloadNotification>(event->getPayload()));
 
@@ -112,6 +115,19 @@ void Sai::syncProcessEventNetLinkMsg(
     m_vsSai->syncProcessEventNetLinkMsg(payload);
 }
 
+void Sai::syncProcessEventNetLinkMsgBatch(
+        _In_ std::shared_ptr<EventPayloadNetLinkMsgBatch> payload)
+{
+    MUTEX();
+
+    SWSS_LOG_ENTER();
+
+    for (auto& msg: payload->getMessages())
+    {
+        m_vsSai->syncProcessEventNetLinkMsg(msg);
+    }
+}
+
 void Sai::asyncProcessEventNotification(
         _In_ std::shared_ptr<EventPayloadNotification> payload)
 {
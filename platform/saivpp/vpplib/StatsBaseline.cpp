@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StatsBaseline.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+// stat ids below this are stored densely
+#define SAI_VPP_STATS_BASELINE_DENSE_MAX 0x1000
+
+using namespace saivpp;
+
+uint64_t* StatsBaseline::find(
+        _In_ sai_object_id_t oid,
+        _In_ sai_stat_id_t id,
+        _In_ bool create)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_index.find(oid);
+
+    if (it == m_index.end())
+    {
+        if (!create)
+        {
+            return nullptr;
+        }
+
+        size_t slot;
+
+        if (m_free.empty())
+        {
+            slot = m_baselines.size();
+            m_baselines.emplace_back();
+        }
+        else
+        {
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+
+        m_baselines[slot].m_oid = oid;
+
+        it = m_index.emplace(oid, slot).first;
+    }
+
+    auto& ob = m_baselines[it->second];
+
+    if (id < SAI_VPP_STATS_BASELINE_DENSE_MAX)
+    {
+        if (id >= ob.m_dense.size())
+        {
+            if (!create)
+            {
+                return nullptr;
+            }
+
+            ob.m_dense.resize(id + 1, 0);
+        }
+
+        return &ob.m_dense[id];
+    }
+
+    auto sit = ob.m_sparse.find(id);
+
+    if (sit == ob.m_sparse.end())
+    {
+        if (!create)
+        {
+            return nullptr;
+        }
+
+        sit = ob.m_sparse.emplace(id, 0).first;
+    }
+
+    return &sit->second;
+}
+
+uint64_t StatsBaseline::read(
+        _In_ sai_object_id_t oid,
+        _In_ sai_stat_id_t id,
+        _In_ uint64_t raw)
+{
+    SWSS_LOG_ENTER();
+
+    auto baseline = find(oid, id, false);
+
+    if (baseline == nullptr)
+    {
+        return raw;
+    }
+
+    if (raw < *baseline)
+    {
+        SWSS_LOG_INFO("counter %u of %s went back, dropping baseline",
+                id, sai_serialize_object_id(oid).c_str());
+
+        *baseline = 0;
+    }
+
+    return raw - *baseline;
+}
+
+void StatsBaseline::clear(
+        _In_ sai_object_id_t oid,
+        _In_ sai_stat_id_t id,
+        _In_ uint64_t raw)
+{
+    SWSS_LOG_ENTER();
+
+    *find(oid, id, true) = raw;
+}
+
+void StatsBaseline::set(
+        _In_ sai_object_id_t oid,
+        _In_ sai_stat_id_t id,
+        _In_ uint64_t baseline)
+{
+    SWSS_LOG_ENTER();
+
+    auto b = find(oid, id, baseline != 0);
+
+    if (b)
+    {
+        *b = baseline;
+    }
+}
+
+void StatsBaseline::remove(
+        _In_ sai_object_id_t oid)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_index.find(oid);
+
+    if (it == m_index.end())
+    {
+        return;
+    }
+
+    auto& ob = m_baselines[it->second];
+
+    ob.m_oid = SAI_NULL_OBJECT_ID;
+    ob.m_dense.clear();
+    ob.m_sparse.clear();
+
+    m_free.push_back(it->second);
+
+    m_index.erase(it);
+}
+
+size_t StatsBaseline::dump(
+        _Out_ std::ostream& os) const
+{
+    SWSS_LOG_ENTER();
+
+    size_t count = 0;
+
+    for (auto& kvp: m_index)
+    {
+        auto& ob = m_baselines[kvp.second];
+
+        auto oid = sai_serialize_object_id(ob.m_oid);
+
+        for (size_t id = 0; id < ob.m_dense.size(); id++)
+        {
+            if (ob.m_dense[id])
+            {
+                os << SAI_VPP_STATS_BASELINE << " " << oid << " " << id << " " << ob.m_dense[id] << std::endl;
+                count++;
+            }
+        }
+
+        for (auto& s: ob.m_sparse)
+        {
+            if (s.second)
+            {
+                os << SAI_VPP_STATS_BASELINE << " " << oid << " " << s.first << " " << s.second << std::endl;
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+extern "C" {
+#include "sai.h"
+}
+
+#include "swss/sal.h"
+
+#include <map>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#define SAI_VPP_STATS_BASELINE "SAI_VPP_STATS_BASELINE"
+
+namespace saivpp
+{
+    /*
+     * Clear on read support for monotonic counters. VPP counters are never
+     * reset by a SAI clear, instead the value at clear time is kept as a
+     * baseline and subtracted from every following read.
+     */
+    class StatsBaseline
+    {
+        public:
+
+            StatsBaseline() = default;
+
+            virtual ~StatsBaseline() = default;
+
+        public:
+
+            /*
+             * Returns raw minus the baseline. A raw value below the baseline
+             * means the counter was reset (interface recreated, VPP
+             * restarted), in which case the baseline is dropped.
+             */
+            uint64_t read(
+                    _In_ sai_object_id_t oid,
+                    _In_ sai_stat_id_t id,
+                    _In_ uint64_t raw);
+
+            void clear(
+                    _In_ sai_object_id_t oid,
+                    _In_ sai_stat_id_t id,
+                    _In_ uint64_t raw);
+
+            void set(
+                    _In_ sai_object_id_t oid,
+                    _In_ sai_stat_id_t id,
+                    _In_ uint64_t baseline);
+
+            void remove(
+                    _In_ sai_object_id_t oid);
+
+            /*
+             * Writes one "SAI_VPP_STATS_BASELINE oid stat_id baseline" line
+             * per non zero baseline, for warm restart.
+             */
+            size_t dump(
+                    _Out_ std::ostream& os) const;
+
+        private:
+
+            uint64_t* find(
+                    _In_ sai_object_id_t oid,
+                    _In_ sai_stat_id_t id,
+                    _In_ bool create);
+
+        private:
+
+            /*
+             * Stat ids are dense enums, so baselines of an object are a
+             * vector indexed by stat id. Range based ids (drop reasons,
+             * custom) are kept apart.
+             */
+            typedef struct _ObjectBaseline
+            {
+                sai_object_id_t m_oid;
+
+                std::vector<uint64_t> m_dense;
+
+                std::map<sai_stat_id_t, uint64_t> m_sparse;
+
+            } ObjectBaseline;
+
+            std::vector<ObjectBaseline> m_baselines;
+
+            // slot in m_baselines by object
+            std::unordered_map<sai_object_id_t, size_t> m_index;
+
+            std::vector<size_t> m_free;
+    };
+}
@@ -53,31 +53,27 @@ sai_status_t SwitchBCM56850::create_qos_queues_per_port(
     // 10 in and 10 out queues per port
     const uint32_t port_qos_queues_count = 20;
 
-    std::vector<sai_object_id_t> queues;
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
 
     for (uint32_t i = 0; i < port_qos_queues_count; ++i)
     {
-        sai_object_id_t queue_id;
-
-        CHECK_STATUS(create(SAI_OBJECT_TYPE_QUEUE, &queue_id, m_switch_id, 0, NULL));
-
-        queues.push_back(queue_id);
+        std::vector<sai_attribute_t> attrs(3);
 
-        attr.id = SAI_QUEUE_ATTR_TYPE;
-        attr.value.s32 = (i < port_qos_queues_count / 2) ?  SAI_QUEUE_TYPE_UNICAST : SAI_QUEUE_TYPE_MULTICAST;
+        attrs[0].id = SAI_QUEUE_ATTR_TYPE;
+        attrs[0].value.s32 = (i < port_qos_queues_count / 2) ?  SAI_QUEUE_TYPE_UNICAST : SAI_QUEUE_TYPE_MULTICAST;
 
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
+        attrs[1].id = SAI_QUEUE_ATTR_INDEX;
+        attrs[1].value.u8 = (uint8_t)i;
 
-        attr.id = SAI_QUEUE_ATTR_INDEX;
-        attr.value.u8 = (uint8_t)i;
+        attrs[2].id = SAI_QUEUE_ATTR_PORT;
+        attrs[2].value.oid = port_id;
 
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
+        attr_lists.push_back(attrs);
+    }
 
-        attr.id = SAI_QUEUE_ATTR_PORT;
-        attr.value.oid = port_id;
+    std::vector<sai_object_id_t> queues;
 
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
-    }
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_QUEUE, attr_lists, queues));
 
     attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
     attr.value.u32 = port_qos_queues_count;
@@ -103,31 +99,27 @@ sai_status_t SwitchBCM56850::create_cpu_qos_queues(
     // CPU queues are of type multicast queues
     const uint32_t port_qos_queues_count = 32;
 
-    std::vector<sai_object_id_t> queues;
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
 
     for (uint32_t i = 0; i < port_qos_queues_count; ++i)
     {
-        sai_object_id_t queue_id;
-
-        CHECK_STATUS(create(SAI_OBJECT_TYPE_QUEUE, &queue_id, m_switch_id, 0, NULL));
+        std::vector<sai_attribute_t> attrs(3);
 
-        queues.push_back(queue_id);
+        attrs[0].id = SAI_QUEUE_ATTR_TYPE;
+        attrs[0].value.s32 = SAI_QUEUE_TYPE_MULTICAST;
 
-        attr.id = SAI_QUEUE_ATTR_TYPE;
-        attr.value.s32 = SAI_QUEUE_TYPE_MULTICAST;
+        attrs[1].id = SAI_QUEUE_ATTR_INDEX;
+        attrs[1].value.u8 = (uint8_t)i;
 
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
+        attrs[2].id = SAI_QUEUE_ATTR_PORT;
+        attrs[2].value.oid = port_id;
 
-        attr.id = SAI_QUEUE_ATTR_INDEX;
-        attr.value.u8 = (uint8_t)i;
-
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
+        attr_lists.push_back(attrs);
+    }
 
-        attr.id = SAI_QUEUE_ATTR_PORT;
-        attr.value.oid = port_id;
+    std::vector<sai_object_id_t> queues;
 
-        CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue_id, &attr));
-    }
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_QUEUE, attr_lists, queues));
 
     attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
     attr.value.u32 = port_qos_queues_count;
@@ -411,14 +403,10 @@ sai_status_t SwitchBCM56850::create_scheduler_groups_per_port(
 
     std::vector<sai_object_id_t> sgs;
 
-    for (uint32_t i = 0; i < port_sgs_count; ++i)
-    {
-        sai_object_id_t sg_id;
-
-        CHECK_STATUS(create(SAI_OBJECT_TYPE_SCHEDULER_GROUP, &sg_id, m_switch_id, 0, NULL));
+    // attributes are populated by scheduler group tree
+    std::vector<std::vector<sai_attribute_t>> sg_attr_lists(port_sgs_count);
 
-        sgs.push_back(sg_id);
-    }
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_SCHEDULER_GROUP, sg_attr_lists, sgs));
 
     attr.id = SAI_PORT_ATTR_QOS_SCHEDULER_GROUP_LIST;
     attr.value.objlist.count = port_sgs_count;
@@ -30,7 +30,11 @@ SwitchConfig::SwitchConfig(
     m_bootType(SAI_VPP_BOOT_TYPE_COLD),
     m_switchIndex(switchIndex),
     m_hardwareInfo(hwinfo),
-    m_useTapDevice(false)
+    m_useTapDevice(false),
+    m_hostifOffload(SAI_VPP_HOSTIF_OFFLOAD_NONE),
+    m_vppApiSocket(),
+    m_vppStatsSocket(),
+    m_vppPuntSocket()
 {
     SWSS_LOG_ENTER();
 
@@ -90,14 +94,19 @@ bool SwitchConfig::parseSwitchType(
     {
         switchType = SAI_VPP_SWITCH_TYPE_MLNX2700;
     }
+    else if (st == SAI_VALUE_VPP_SWITCH_TYPE_VPP)
+    {
+        switchType = SAI_VPP_SWITCH_TYPE_VPP;
+    }
     else
     {
-        SWSS_LOG_ERROR("unknown switch type: '%s', expected (%s|%s|%s|%s)",
+        SWSS_LOG_ERROR("unknown switch type: '%s', expected (%s|%s|%s|%s|%s)",
                 switchTypeStr,
                 SAI_VALUE_VPP_SWITCH_TYPE_BCM81724,
                 SAI_VALUE_VPP_SWITCH_TYPE_BCM56850,
                 SAI_VALUE_VPP_SWITCH_TYPE_BCM56971B0,
-                SAI_VALUE_VPP_SWITCH_TYPE_MLNX2700);
+                SAI_VALUE_VPP_SWITCH_TYPE_MLNX2700,
+                SAI_VALUE_VPP_SWITCH_TYPE_VPP);
 
         return false;
     }
@@ -147,3 +156,37 @@ bool SwitchConfig::parseUseTapDevice(
 
     return false;
 }
+
+bool SwitchConfig::parseHostifOffload(
+        _In_ const char* hostifOffloadStr,
+        _Out_ sai_vpp_hostif_offload_t& hostifOffload)
+{
+    SWSS_LOG_ENTER();
+
+    std::string ho = (hostifOffloadStr == NULL) ? SAI_VALUE_VPP_HOSTIF_OFFLOAD_NONE : hostifOffloadStr;
+
+    if (ho == SAI_VALUE_VPP_HOSTIF_OFFLOAD_NONE)
+    {
+        hostifOffload = SAI_VPP_HOSTIF_OFFLOAD_NONE;
+    }
+    else if (ho == SAI_VALUE_VPP_HOSTIF_OFFLOAD_CSUM)
+    {
+        hostifOffload = SAI_VPP_HOSTIF_OFFLOAD_CSUM;
+    }
+    else if (ho == SAI_VALUE_VPP_HOSTIF_OFFLOAD_GSO)
+    {
+        hostifOffload = SAI_VPP_HOSTIF_OFFLOAD_GSO;
+    }
+    else
+    {
+        SWSS_LOG_ERROR("unknown hostif offload: '%s', expected (%s|%s|%s)",
+                hostifOffloadStr,
+                SAI_VALUE_VPP_HOSTIF_OFFLOAD_NONE,
+                SAI_VALUE_VPP_HOSTIF_OFFLOAD_CSUM,
+                SAI_VALUE_VPP_HOSTIF_OFFLOAD_GSO);
+
+        return false;
+    }
+
+    return true;
+}
@@ -41,6 +41,8 @@ namespace saivpp
 
         SAI_VPP_SWITCH_TYPE_MLNX2700,
 
+        SAI_VPP_SWITCH_TYPE_VPP,
+
     } sai_vpp_switch_type_t;
 
     typedef enum _sai_vpp_boot_type_t
@@ -53,6 +55,16 @@ namespace saivpp
 
     } sai_vpp_boot_type_t;
 
+    typedef enum _sai_vpp_hostif_offload_t
+    {
+        SAI_VPP_HOSTIF_OFFLOAD_NONE,
+
+        SAI_VPP_HOSTIF_OFFLOAD_CSUM,
+
+        SAI_VPP_HOSTIF_OFFLOAD_GSO,
+
+    } sai_vpp_hostif_offload_t;
+
     class SwitchConfig
     {
         public:
@@ -80,6 +92,10 @@ namespace saivpp
             static bool parseUseTapDevice(
                     _In_ const char* useTapDeviceStr);
 
+            static bool parseHostifOffload(
+                    _In_ const char* hostifOffloadStr,
+                    _Out_ sai_vpp_hostif_offload_t& hostifOffload);
+
         public:
 
             sai_switch_type_t m_saiSwitchType;
@@ -94,6 +110,19 @@ namespace saivpp
 
             bool m_useTapDevice;
 
+            sai_vpp_hostif_offload_t m_hostifOffload;
+
+            /*
+             * API and stats segment sockets of the VPP instance backing this
+             * switch, empty for the default /run/vpp sockets.
+             */
+            std::string m_vppApiSocket;
+
+            std::string m_vppStatsSocket;
+
+            // VPP punt socket, empty for /run/vpp/punt.sock
+            std::string m_vppPuntSocket;
+
             std::shared_ptr<LaneMap> m_laneMap;
 
             std::shared_ptr<LaneMap> m_fabricLaneMap;
@@ -18,7 +18,7 @@
 #include "RealObjectIdManager.h"
 #include "SwitchStateBase.h"
 #include "RealObjectIdManager.h"
-#include "EventPayloadNetLinkMsg.h"
+#include "EventPayloadNetLinkMsgBatch.h"
 
 #include "swss/logger.h"
 
@@ -68,7 +68,7 @@ SwitchState::SwitchState(
     if (m_switchConfig->m_useTapDevice)
     {
         m_linkCallbackIndex = NetMsgRegistrar::getInstance().registerCallback(
-                std::bind(&SwitchState::asyncOnLinkMsg, this, std::placeholders::_1, std::placeholders::_2));
+                std::bind(&SwitchState::asyncOnLinkMsg, this, std::placeholders::_1));
     }
 
     if (m_switchConfig->m_resourceLimiter)
@@ -179,39 +179,80 @@ bool SwitchState::getTapNameFromPortId(
     return false;
 }
 
-void SwitchState::asyncOnLinkMsg(
-        _In_ int nlmsg_type,
-        _In_ struct nl_object *obj)
+void SwitchState::addLinkIfIndex(
+        _In_ int ifindex)
 {
     SWSS_LOG_ENTER();
 
-    switch (nlmsg_type)
+    if (m_switchConfig->m_useTapDevice)
     {
-        case RTM_NEWLINK:
-        case RTM_DELLINK:
-            break;
+        NetMsgRegistrar::getInstance().addIfIndex(m_linkCallbackIndex, ifindex);
+    }
+}
 
-        default:
+void SwitchState::removeLinkIfIndex(
+        _In_ int ifindex)
+{
+    SWSS_LOG_ENTER();
 
-            SWSS_LOG_WARN("unsupported nlmsg_type: %d", nlmsg_type);
-            return;
+    if (m_switchConfig->m_useTapDevice)
+    {
+        NetMsgRegistrar::getInstance().removeIfIndex(m_linkCallbackIndex, ifindex);
     }
+}
+
+void SwitchState::asyncOnLinkMsg(
+        _In_ const std::vector<NetMsgRegistrar::LinkState>& links)
+{
+    SWSS_LOG_ENTER();
+
+    // registrar delivers only interfaces owned by this switch and new
+    // addresses, coalesced
+
+    std::vector<std::shared_ptr<EventPayloadNetLinkMsg>> msgs;
+
+    for (auto& link: links)
+    {
+        switch (link.m_nlmsgType)
+        {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+                break;
+
+            case RTM_NEWADDR:
+
+                SWSS_LOG_INFO("received RTM_NEWADDR %s, ifindex: %d",
+                        link.m_ipAddress.c_str(),
+                        link.m_ifIndex);
 
-    struct rtnl_link *link = (struct rtnl_link *)obj;
+                msgs.push_back(std::make_shared<EventPayloadNetLinkMsg>(
+                            m_switch_id, link.m_nlmsgType, link.m_ifIndex, link.m_ifFlags, link.m_ifName, link.m_ipAddress));
+                continue;
 
-    int             if_index = rtnl_link_get_ifindex(link);
-    unsigned int    if_flags = rtnl_link_get_flags(link); // IFF_LOWER_UP and IFF_RUNNING
-    const char*     if_name  = rtnl_link_get_name(link);
+            default:
+
+                SWSS_LOG_WARN("unsupported nlmsg_type: %d", link.m_nlmsgType);
+                continue;
+        }
 
-    SWSS_LOG_NOTICE("received %s ifname: %s, ifflags: 0x%x, ifindex: %d",
-            (nlmsg_type == RTM_NEWLINK ? "RTM_NEWLINK" : "RTM_DELLINK"),
-            if_name,
-            if_flags,
-            if_index);
+        SWSS_LOG_NOTICE("received %s ifname: %s, ifflags: 0x%x, ifindex: %d",
+                (link.m_nlmsgType == RTM_NEWLINK ? "RTM_NEWLINK" : "RTM_DELLINK"),
+                link.m_ifName.c_str(),
+                link.m_ifFlags,
+                link.m_ifIndex);
 
-    auto payload = std::make_shared<EventPayloadNetLinkMsg>(m_switch_id, nlmsg_type, if_index, if_flags, if_name);
+        msgs.push_back(std::make_shared<EventPayloadNetLinkMsg>(
+                    m_switch_id, link.m_nlmsgType, link.m_ifIndex, link.m_ifFlags, link.m_ifName));
+    }
+
+    if (msgs.empty())
+    {
+        return;
+    }
 
-    m_switchConfig->m_eventQueue->enqueue(std::make_shared<Event>(EVENT_TYPE_NET_LINK_MSG, payload));
+    auto payload = std::make_shared<EventPayloadNetLinkMsgBatch>(msgs);
+
+    m_switchConfig->m_eventQueue->enqueue(std::make_shared<Event>(EVENT_TYPE_NET_LINK_MSG_BATCH, payload));
 }
 
 sai_status_t SwitchState::getStatsExt(
@@ -268,24 +309,26 @@ sai_status_t SwitchState::getStatsExt(
         if (perform_set)
         {
             localcounters[ id ] = counters[i];
+
+            m_statsBaseline.set(object_id, id, 0);
         }
         else
         {
+            // if counter is not found on list, just return 0
             auto it = localcounters.find(id);
 
-            if (it == localcounters.end())
-            {
-                // if counter is not found on list, just return 0
-                counters[i] = 0;
-            }
-            else
-            {
-                counters[i] = it->second;
-            }
+            uint64_t raw = (it == localcounters.end()) ? 0 : it->second;
+
+            /*
+             * Counters polled from VPP are absolute, a clear only moves the
+             * baseline so the next poll doesn't bring the old value back.
+             */
+
+            counters[i] = m_statsBaseline.read(object_id, id, raw);
 
             if (mode == SAI_STATS_MODE_READ_AND_CLEAR)
             {
-                localcounters[ id ] = 0;
+                m_statsBaseline.clear(object_id, id, raw);
             }
         }
     }
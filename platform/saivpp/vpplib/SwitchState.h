@@ -21,6 +21,8 @@ extern "C" {
 
 #include "SaiAttrWrap.h"
 #include "SwitchConfig.h"
+#include "NetMsgRegistrar.h"
+#include "StatsBaseline.h"
 
 #include "meta/Meta.h"
 
@@ -71,7 +73,7 @@ namespace saivpp
                     _In_ sai_stats_mode_t mode,
                     _Out_ uint64_t *counters);
 
-            sai_status_t queryStatsCapability(
+            virtual sai_status_t queryStatsCapability(
                     _In_ sai_object_id_t switchId,
                     _In_ sai_object_type_t objectType,
                     _Inout_ sai_stat_capability_list_t *stats_capability);
@@ -108,8 +110,13 @@ namespace saivpp
             void unregisterLinkCallback();
 
             void asyncOnLinkMsg(
-                    _In_ int nlmsg_type,
-                    _In_ struct nl_object *obj);
+                    _In_ const std::vector<NetMsgRegistrar::LinkState>& links);
+
+            void addLinkIfIndex(
+                    _In_ int ifindex);
+
+            void removeLinkIfIndex(
+                    _In_ int ifindex);
 
             std::shared_ptr<saimeta::Meta> getMeta();
 
@@ -121,6 +128,9 @@ namespace saivpp
 
             std::map<std::string, std::map<int, uint64_t>> m_countersMap;
 
+            // values of m_countersMap at the last clear
+            StatsBaseline m_statsBaseline;
+
             sai_object_id_t m_switch_id;
 
         private : // tap device related objects
@@ -23,9 +23,13 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <inttypes.h>
 
 #define SAI_VPP_MAX_PORTS 1024
 
+// flex counter poll interval, all counter reads within it share a snapshot
+#define SAI_VPP_STATS_SNAPSHOT_MS 1000
+
 using namespace saivpp;
 
 SwitchStateBase::SwitchStateBase(
@@ -61,6 +65,13 @@ SwitchStateBase::SwitchStateBase(
             m_objectHash[kvp.first] = kvp.second;
         }
 
+        for (auto& b: warmBootState->m_statsBaselines)
+        {
+            m_statsBaseline.set(std::get<0>(b), std::get<1>(b), std::get<2>(b));
+        }
+
+        rebuild_list_indexes();
+
         if (m_switchConfig->m_useTapDevice)
         {
             m_fdb_info_set = warmBootState->m_fdbInfoSet;
@@ -174,6 +185,13 @@ sai_status_t SwitchStateBase::create(
         return createHostif(object_id, switch_id, attr_count, attr_list);
     }
 
+    if (object_type == SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY)
+    {
+        sai_object_id_t object_id;
+        sai_deserialize_object_id(serializedObjectId, object_id);
+        return createHostifTableEntry(object_id, switch_id, attr_count, attr_list);
+    }
+
     if (object_type == SAI_OBJECT_TYPE_ROUTER_INTERFACE)
     {
         sai_object_id_t object_id;
@@ -191,6 +209,11 @@ sai_status_t SwitchStateBase::create(
         return addIpNbr(serializedObjectId, switch_id, attr_count, attr_list);
     }
 
+    if (object_type == SAI_OBJECT_TYPE_NEXT_HOP)
+    {
+        return createNextHop(serializedObjectId, switch_id, attr_count, attr_list);
+    }
+
     if (object_type == SAI_OBJECT_TYPE_MACSEC_PORT)
     {
         sai_object_id_t object_id;
@@ -283,6 +306,54 @@ sai_status_t SwitchStateBase::create_internal(
         objectHash[serializedObjectId][a->getAttrMetadata()->attridname] = a;
     }
 
+    index_list_member(object_type, serializedObjectId);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::create_objects(
+        _In_ sai_object_type_t object_type,
+        _In_ const std::vector<std::vector<sai_attribute_t>>& attr_lists,
+        _Out_ std::vector<sai_object_id_t>& object_ids)
+{
+    SWSS_LOG_ENTER();
+
+    auto &objectHash = m_objectHash.at(object_type);
+
+    size_t count = attr_lists.size();
+
+    if (m_switchConfig->m_resourceLimiter)
+    {
+        size_t limit = m_switchConfig->m_resourceLimiter->getObjectTypeLimit(object_type);
+
+        if (objectHash.size() + count > limit)
+        {
+            SWSS_LOG_ERROR("too many %s, created %zu is resource limit",
+                    sai_serialize_object_type(object_type).c_str(),
+                    limit);
+
+            return SAI_STATUS_INSUFFICIENT_RESOURCES;
+        }
+    }
+
+    object_ids = m_realObjectIdManager->allocateNewObjectIds(object_type, m_switch_id, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto sid = sai_serialize_object_id(object_ids[i]);
+
+        auto& hash = objectHash[sid];
+
+        for (auto &attr: attr_lists[i])
+        {
+            auto a = std::make_shared<SaiAttrWrap>(object_type, &attr);
+
+            hash[a->getAttrMetadata()->attridname] = a;
+        }
+
+        index_list_member(object_type, sid);
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -414,6 +485,13 @@ sai_status_t SwitchStateBase::remove(
         return removeHostif(objectId);
     }
 
+    if (object_type == SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY)
+    {
+        sai_object_id_t objectId;
+        sai_deserialize_object_id(serializedObjectId, objectId);
+        return removeHostifTableEntry(objectId);
+    }
+
     if (object_type == SAI_OBJECT_TYPE_ROUTER_INTERFACE)
     {
         sai_object_id_t objectId;
@@ -483,6 +561,17 @@ sai_status_t SwitchStateBase::remove_internal(
 
     objectHash.erase(it);
 
+    if (sai_metadata_get_object_type_info(object_type)->isobjectid)
+    {
+        sai_object_id_t oid;
+
+        sai_deserialize_object_id(serializedObjectId, oid);
+
+        m_statsBaseline.remove(oid);
+
+        unindex_list_member(object_type, oid);
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -598,6 +687,24 @@ sai_status_t SwitchStateBase::set(
         return setMACsecSA(objectId, attr);
     }
 
+    if (objectType == SAI_OBJECT_TYPE_ROUTE_ENTRY && attr && attr->id == SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID)
+    {
+        CHECK_STATUS(set_internal(objectType, serializedObjectId, attr));
+
+        rekey_pending_route(serializedObjectId);
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (objectType == SAI_OBJECT_TYPE_ROUTE_ENTRY && attr && attr->id == SAI_ROUTE_ENTRY_ATTR_COUNTER_ID)
+    {
+        CHECK_STATUS(set_internal(objectType, serializedObjectId, attr));
+
+        bind_route_counter(serializedObjectId, attr->value.oid);
+
+        return SAI_STATUS_SUCCESS;
+    }
+
     return set_internal(objectType, serializedObjectId, attr);
 }
 
@@ -626,6 +733,11 @@ sai_status_t SwitchStateBase::set_internal(
     // set have only one attribute
     attrHash[a->getAttrMetadata()->attridname] = a;
 
+    if (objectType == SAI_OBJECT_TYPE_BRIDGE_PORT && attr->id == SAI_BRIDGE_PORT_ATTR_BRIDGE_ID)
+    {
+        index_list_member(objectType, serializedObjectId);
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -799,12 +911,34 @@ sai_status_t SwitchStateBase::bulkCreate(
         return SAI_STATUS_FAILURE;
     }
 
+    if (object_type == SAI_OBJECT_TYPE_ROUTER_INTERFACE)
+    {
+        return createRouterifs(switch_id, serialized_object_ids, attr_count, attr_list, mode, object_statuses);
+    }
+
     sai_status_t status = SAI_STATUS_SUCCESS;
     uint32_t it;
 
     for (it = 0; it < object_count; it++)
     {
-        object_statuses[it] = create_internal(object_type, serialized_object_ids[it], switch_id, attr_count[it], attr_list[it]);
+        // routes and neighbors are admitted and counted as in a single create
+
+        if (object_type == SAI_OBJECT_TYPE_ROUTE_ENTRY)
+        {
+            object_statuses[it] = addIpRoute(serialized_object_ids[it], switch_id, attr_count[it], attr_list[it]);
+        }
+        else if (object_type == SAI_OBJECT_TYPE_NEIGHBOR_ENTRY)
+        {
+            object_statuses[it] = addIpNbr(serialized_object_ids[it], switch_id, attr_count[it], attr_list[it]);
+        }
+        else if (object_type == SAI_OBJECT_TYPE_NEXT_HOP)
+        {
+            object_statuses[it] = createNextHop(serialized_object_ids[it], switch_id, attr_count[it], attr_list[it]);
+        }
+        else
+        {
+            object_statuses[it] = create_internal(object_type, serialized_object_ids[it], switch_id, attr_count[it], attr_list[it]);
+        }
 
         if (object_statuses[it] != SAI_STATUS_SUCCESS)
         {
@@ -816,6 +950,7 @@ sai_status_t SwitchStateBase::bulkCreate(
             {
                 break;
             }
+
         }
     }
 
@@ -848,7 +983,27 @@ sai_status_t SwitchStateBase::bulkRemove(
 
     for (it = 0; it < object_count; it++)
     {
-        object_statuses[it] = remove_internal(object_type, serialized_object_ids[it]);
+        if (object_type == SAI_OBJECT_TYPE_ROUTER_INTERFACE)
+        {
+            // same VPP cleanup as a single remove
+
+            sai_object_id_t object_id;
+            sai_deserialize_object_id(serialized_object_ids[it], object_id);
+
+            object_statuses[it] = removeRouterif(object_id);
+        }
+        else if (object_type == SAI_OBJECT_TYPE_ROUTE_ENTRY)
+        {
+            object_statuses[it] = removeIpRoute(serialized_object_ids[it]);
+        }
+        else if (object_type == SAI_OBJECT_TYPE_NEIGHBOR_ENTRY)
+        {
+            object_statuses[it] = removeIpNbr(serialized_object_ids[it]);
+        }
+        else
+        {
+            object_statuses[it] = remove_internal(object_type, serialized_object_ids[it]);
+        }
 
         if (object_statuses[it] != SAI_STATUS_SUCCESS)
         {
@@ -860,6 +1015,7 @@ sai_status_t SwitchStateBase::bulkRemove(
             {
                 break;
             }
+
         }
     }
 
@@ -905,6 +1061,13 @@ sai_status_t SwitchStateBase::bulkSet(
             {
                 break;
             }
+
+            continue;
+        }
+
+        if (object_type == SAI_OBJECT_TYPE_ROUTE_ENTRY && attr_list[it].id == SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID)
+        {
+            rekey_pending_route(serialized_object_ids[it]);
         }
     }
 
@@ -1362,51 +1525,68 @@ sai_status_t SwitchStateBase::create_default_trap_group()
     return set(SAI_OBJECT_TYPE_SWITCH, m_switch_id, &attr);
 }
 
-sai_status_t SwitchStateBase::create_ingress_priority_groups_per_port(
-        _In_ sai_object_id_t port_id)
+// NOTE: must be per switch (mlnx and brcm is 8)
+#define SAI_VPP_PORT_PGS_COUNT 8
+
+void SwitchStateBase::add_port_ingress_priority_groups_attrs(
+        _In_ sai_object_id_t port_id,
+        _Inout_ std::vector<std::vector<sai_attribute_t>>& attr_lists) const
 {
     SWSS_LOG_ENTER();
 
-    const uint32_t port_pgs_count = 8; // NOTE: must be per switch (mlnx and brcm is 8)
-
-    std::vector<sai_object_id_t> pgs;
-
-    for (uint32_t i = 0; i < port_pgs_count; ++i)
+    for (uint32_t i = 0; i < SAI_VPP_PORT_PGS_COUNT; ++i)
     {
-        sai_object_id_t pg_id;
-
-        sai_attribute_t attr[3];
+        std::vector<sai_attribute_t> attrs(3);
 
         // NOTE: on brcm this attribute is not added
 
-        attr[0].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE;
-        attr[0].value.oid = SAI_NULL_OBJECT_ID;
-
-        attr[1].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_PORT;
-        attr[1].value.oid = port_id;
+        attrs[0].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE;
+        attrs[0].value.oid = SAI_NULL_OBJECT_ID;
 
-        attr[2].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_INDEX;
-        attr[2].value.oid = i;
+        attrs[1].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_PORT;
+        attrs[1].value.oid = port_id;
 
-        CHECK_STATUS(create(SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &pg_id, m_switch_id, 3, attr));
+        attrs[2].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_INDEX;
+        attrs[2].value.oid = i;
 
-        pgs.push_back(pg_id);
+        attr_lists.push_back(attrs);
     }
+}
+
+sai_status_t SwitchStateBase::set_port_ingress_priority_groups(
+        _In_ sai_object_id_t port_id,
+        _In_ sai_object_id_t *pgs)
+{
+    SWSS_LOG_ENTER();
 
     sai_attribute_t attr;
 
     attr.id = SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS;
-    attr.value.u32 = port_pgs_count;
+    attr.value.u32 = SAI_VPP_PORT_PGS_COUNT;
 
     CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
 
     attr.id = SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST;
-    attr.value.objlist.count = port_pgs_count;
-    attr.value.objlist.list = pgs.data();
+    attr.value.objlist.count = SAI_VPP_PORT_PGS_COUNT;
+    attr.value.objlist.list = pgs;
 
-    CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+    return set(SAI_OBJECT_TYPE_PORT, port_id, &attr);
+}
 
-    return SAI_STATUS_SUCCESS;
+sai_status_t SwitchStateBase::create_ingress_priority_groups_per_port(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    add_port_ingress_priority_groups_attrs(port_id, attr_lists);
+
+    std::vector<sai_object_id_t> pgs;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, attr_lists, pgs));
+
+    return set_port_ingress_priority_groups(port_id, pgs.data());
 }
 
 sai_status_t SwitchStateBase::create_ingress_priority_groups()
@@ -1417,9 +1597,24 @@ sai_status_t SwitchStateBase::create_ingress_priority_groups()
 
     SWSS_LOG_INFO("create ingress priority groups");
 
+    // build priority groups of all ports in one pass
+
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    attr_lists.reserve(m_port_list.size() * SAI_VPP_PORT_PGS_COUNT);
+
     for (auto &port_id: m_port_list)
     {
-        create_ingress_priority_groups_per_port(port_id);
+        add_port_ingress_priority_groups_attrs(port_id, attr_lists);
+    }
+
+    std::vector<sai_object_id_t> pgs;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, attr_lists, pgs));
+
+    for (size_t idx = 0; idx < m_port_list.size(); idx++)
+    {
+        CHECK_STATUS(set_port_ingress_priority_groups(m_port_list[idx], pgs.data() + idx * SAI_VPP_PORT_PGS_COUNT));
     }
 
     return SAI_STATUS_SUCCESS;
@@ -2013,6 +2208,10 @@ sai_status_t SwitchStateBase::warm_update_switch()
         CHECK_STATUS(set_switch_supported_object_types());
     }
 
+    warm_update_resource_usage();
+
+    warm_update_route_counters();
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -2053,47 +2252,21 @@ sai_status_t SwitchStateBase::refresh_vlan_member_list(
 {
     SWSS_LOG_ENTER();
 
-    auto &all_vlan_members = m_objectHash.at(SAI_OBJECT_TYPE_VLAN_MEMBER);
-
-    auto m_member_list = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_VLAN, SAI_VLAN_ATTR_MEMBER_LIST);
-    auto md_vlan_id = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_VLAN_MEMBER, SAI_VLAN_MEMBER_ATTR_VLAN_ID);
-    //auto md_brportid = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_VLAN_MEMBER, SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID);
-
     std::vector<sai_object_id_t> vlan_member_list;
 
-    /*
-     * We want order as bridge port order (so port order)
-     */
-
-    sai_attribute_t attr;
-
-    auto me = m_objectHash.at(SAI_OBJECT_TYPE_VLAN).at(sai_serialize_object_id(vlan_id));
-
-    for (auto vm: all_vlan_members)
+    if (!m_vlanMemberIndex.fetchChanged(vlan_id, vlan_member_list))
     {
-        if (vm.second.at(md_vlan_id->attridname)->getAttr()->value.oid != vlan_id)
-        {
-            /*
-             * Only interested in our vlan
-             */
-
-            continue;
-        }
-
-        // TODO we need order as bridge ports, but we need bridge id!
-
-        {
-            sai_object_id_t vlan_member_id;
-
-            sai_deserialize_object_id(vm.first, vlan_member_id);
-
-            vlan_member_list.push_back(vlan_member_id);
-        }
+        return SAI_STATUS_SUCCESS;
     }
 
     uint32_t vlan_member_list_count = (uint32_t)vlan_member_list.size();
 
-    SWSS_LOG_NOTICE("recalculated %s: %u", m_member_list->attridname, vlan_member_list_count);
+    SWSS_LOG_NOTICE("recalculated %s: %u, generation %" PRIu64,
+            meta->attridname,
+            vlan_member_list_count,
+            m_vlanMemberIndex.getGeneration(vlan_id));
+
+    sai_attribute_t attr;
 
     attr.id = SAI_VLAN_ATTR_MEMBER_LIST;
     attr.value.objlist.count = vlan_member_list_count;
@@ -2108,7 +2281,14 @@ sai_status_t SwitchStateBase::refresh_port_list(
     SWSS_LOG_ENTER();
 
     // since now port can be added or removed, we need to update port list
-    // dynamically
+    // dynamically, ports are indexed in oid order on create
+
+    std::vector<sai_object_id_t> ports;
+
+    if (!m_portListIndex.fetchChanged(m_switch_id, ports))
+    {
+        return SAI_STATUS_SUCCESS;
+    }
 
     sai_attribute_t attr;
 
@@ -2123,13 +2303,8 @@ sai_status_t SwitchStateBase::refresh_port_list(
 
     m_port_list.clear();
 
-    // iterate via ASIC state to find all the ports
-
-    for (const auto& it: m_objectHash.at(SAI_OBJECT_TYPE_PORT))
+    for (auto port_id: ports)
     {
-        sai_object_id_t port_id;
-        sai_deserialize_object_id(it.first, port_id);
-
         // don't put CPU port id on the list
 
         if (port_id == cpu_port_id)
@@ -2149,11 +2324,9 @@ sai_status_t SwitchStateBase::refresh_port_list(
      * the PORT_LIST attribute.
      *
      * This needs to be investigated, and to reflect exact behaviour here.
-     * Currently we just sort all the port oids.
+     * Currently port oids are sorted.
      */
 
-    std::sort(m_port_list.begin(), m_port_list.end());
-
     uint32_t port_count = (uint32_t)m_port_list.size();
 
     attr.id = SAI_SWITCH_ATTR_PORT_LIST;
@@ -2172,6 +2345,151 @@ sai_status_t SwitchStateBase::refresh_port_list(
     return SAI_STATUS_SUCCESS;
 }
 
+void SwitchStateBase::index_list_member(
+        _In_ sai_object_type_t object_type,
+        _In_ const std::string &serializedObjectId)
+{
+    SWSS_LOG_ENTER();
+
+    if (object_type != SAI_OBJECT_TYPE_PORT &&
+            object_type != SAI_OBJECT_TYPE_VLAN_MEMBER &&
+            object_type != SAI_OBJECT_TYPE_BRIDGE_PORT)
+    {
+        return;
+    }
+
+    sai_object_id_t oid;
+    sai_deserialize_object_id(serializedObjectId, oid);
+
+    if (object_type == SAI_OBJECT_TYPE_PORT)
+    {
+        m_portListIndex.insert(m_switch_id, oid, oid);
+        return;
+    }
+
+    auto& attrHash = m_objectHash.at(object_type).at(serializedObjectId);
+
+    if (object_type == SAI_OBJECT_TYPE_VLAN_MEMBER)
+    {
+        auto md_vlan_id = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_VLAN_MEMBER, SAI_VLAN_MEMBER_ATTR_VLAN_ID);
+
+        auto it = attrHash.find(md_vlan_id->attridname);
+
+        if (it != attrHash.end())
+        {
+            // TODO we need order as bridge ports, but we need bridge id!
+
+            m_vlanMemberIndex.insert(it->second->getAttr()->value.oid, oid, oid);
+        }
+
+        return;
+    }
+
+    auto m_port_id = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_BRIDGE_PORT, SAI_BRIDGE_PORT_ATTR_PORT_ID);
+    auto m_bridge_id = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_BRIDGE_PORT, SAI_BRIDGE_PORT_ATTR_BRIDGE_ID);
+    auto m_type = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_BRIDGE_PORT, SAI_BRIDGE_PORT_ATTR_TYPE);
+
+    auto bit = attrHash.find(m_bridge_id->attridname);
+
+    if (bit == attrHash.end())
+    {
+        auto tit = attrHash.find(m_type->attridname);
+
+        if (tit == attrHash.end() || tit->second->getAttr()->value.s32 != SAI_BRIDGE_PORT_TYPE_PORT)
+        {
+            // fine on router 1q
+
+            m_bridgePortIndex.erase(oid);
+            return;
+        }
+
+        // this bridge port is type PORT, and it's missing BRIDGE_ID attr
+
+        sai_attribute_t attr;
+
+        attr.id = SAI_SWITCH_ATTR_DEFAULT_1Q_BRIDGE_ID;
+
+        if (get(SAI_OBJECT_TYPE_SWITCH, m_switch_id, 1, &attr) != SAI_STATUS_SUCCESS)
+        {
+            return;
+        }
+
+        SWSS_LOG_NOTICE("setting default bridge id (%s) on bridge port %s",
+                sai_serialize_object_id(attr.value.oid).c_str(),
+                serializedObjectId.c_str());
+
+        attr.id = SAI_BRIDGE_PORT_ATTR_BRIDGE_ID;
+
+        bit = attrHash.emplace(m_bridge_id->attridname, std::make_shared<SaiAttrWrap>(SAI_OBJECT_TYPE_BRIDGE_PORT, &attr)).first;
+    }
+
+    sai_object_id_t bridge_id = bit->second->getAttr()->value.oid;
+
+    if (bridge_id == SAI_NULL_OBJECT_ID)
+    {
+        m_bridgePortIndex.erase(oid);
+        return;
+    }
+
+    // bridge ports are listed in port order
+
+    auto pit = attrHash.find(m_port_id->attridname);
+
+    uint64_t order = (pit == attrHash.end()) ? oid : pit->second->getAttr()->value.oid;
+
+    m_bridgePortIndex.insert(bridge_id, oid, order);
+}
+
+void SwitchStateBase::unindex_list_member(
+        _In_ sai_object_type_t object_type,
+        _In_ sai_object_id_t object_id)
+{
+    SWSS_LOG_ENTER();
+
+    switch (object_type)
+    {
+        case SAI_OBJECT_TYPE_PORT:
+            m_portListIndex.erase(object_id);
+            break;
+
+        case SAI_OBJECT_TYPE_VLAN_MEMBER:
+            m_vlanMemberIndex.erase(object_id);
+            break;
+
+        case SAI_OBJECT_TYPE_BRIDGE_PORT:
+            m_bridgePortIndex.erase(object_id);
+            break;
+
+        case SAI_OBJECT_TYPE_VLAN:
+            m_vlanMemberIndex.eraseOwner(object_id);
+            break;
+
+        case SAI_OBJECT_TYPE_BRIDGE:
+            m_bridgePortIndex.eraseOwner(object_id);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void SwitchStateBase::rebuild_list_indexes()
+{
+    SWSS_LOG_ENTER();
+
+    m_portListIndex.clear();
+    m_vlanMemberIndex.clear();
+    m_bridgePortIndex.clear();
+
+    for (auto ot: { SAI_OBJECT_TYPE_PORT, SAI_OBJECT_TYPE_VLAN_MEMBER, SAI_OBJECT_TYPE_BRIDGE_PORT })
+    {
+        for (auto& kvp: m_objectHash.at(ot))
+        {
+            index_list_member(ot, kvp.first);
+        }
+    }
+}
+
 sai_status_t SwitchStateBase::refresh_macsec_sci_in_ingress_macsec_acl(
         _In_ sai_object_id_t object_id)
 {
@@ -2322,10 +2640,12 @@ sai_status_t SwitchStateBase::refresh_read_only(
 
             case SAI_SWITCH_ATTR_AVAILABLE_IPV4_ROUTE_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_IPV6_ROUTE_ENTRY:
-            case SAI_SWITCH_ATTR_AVAILABLE_IPV4_NEXTHOP_ENTRY:
-            case SAI_SWITCH_ATTR_AVAILABLE_IPV6_NEXTHOP_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_IPV4_NEIGHBOR_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_IPV6_NEIGHBOR_ENTRY:
+                return refresh_crm_available(meta);
+
+            case SAI_SWITCH_ATTR_AVAILABLE_IPV4_NEXTHOP_ENTRY:
+            case SAI_SWITCH_ATTR_AVAILABLE_IPV6_NEXTHOP_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_NEXT_HOP_GROUP_MEMBER_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_NEXT_HOP_GROUP_ENTRY:
             case SAI_SWITCH_ATTR_AVAILABLE_FDB_ENTRY:
@@ -3012,6 +3332,12 @@ std::string SwitchStateBase::dump_switch_database_for_warm_restart() const
                 sai_serialize_object_id(m_switch_id).c_str());
     }
 
+    size_t baselines = m_statsBaseline.dump(ss);
+
+    SWSS_LOG_NOTICE("dumped %zu counter baselines for switch %s",
+            baselines,
+            sai_serialize_object_id(m_switch_id).c_str());
+
     SWSS_LOG_NOTICE("dumped %zu objects from switch %s",
             count,
             sai_serialize_object_id(m_switch_id).c_str());
@@ -3035,6 +3361,40 @@ sai_object_id_t SwitchStateBase::switchIdQuery(
     return RealObjectIdManager::switchIdQuery(objectId);
 }
 
+std::shared_ptr<const VppStatsSnapshot> SwitchStateBase::get_stats_snapshot(
+        _In_ bool withRoutes)
+{
+    SWSS_LOG_ENTER();
+
+    auto now = std::chrono::steady_clock::now();
+
+    bool expired = (now - m_statsSnapshotTime >= std::chrono::milliseconds(SAI_VPP_STATS_SNAPSHOT_MS));
+
+    if (!expired && (!withRoutes || (m_statsSnapshot && m_statsSnapshot->hasRoutes())))
+    {
+        return m_statsSnapshot;
+    }
+
+    m_statsSnapshotTime = now;
+
+    // keep reading routes for as long as route counters are bound
+
+    m_statsSnapshot = VppStatsSnapshot::take(withRoutes || !m_counterRoute.empty());
+
+    if (m_statsSnapshot)
+    {
+        for (auto& it: m_statsSnapshot->getInterfaces())
+        {
+            for (auto& xs: it.second.m_xstats)
+            {
+                m_portXstatNames.insert(xs.first);
+            }
+        }
+    }
+
+    return m_statsSnapshot;
+}
+
 void SwitchStateBase::debugSetStats(
         _In_ sai_object_id_t oid,
         _In_ const std::map<sai_stat_id_t, uint64_t>& stats)
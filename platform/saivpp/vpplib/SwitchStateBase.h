@@ -25,9 +25,18 @@
 #include "EventPayloadNetLinkMsg.h"
 #include "MACsecManager.h"
 #include "IpVrfInfo.h"
+#include "VppStatsSnapshot.h"
+#include "ObjectListIndex.h"
+#include "CounterStream.h"
+#include "PuntSocket.h"
+#include "PendingRoutes.h"
+
+#include "vppxlate/SaiVppStats.h"
 
 #include <set>
 #include <unordered_set>
+#include <unordered_map>
+#include <chrono>
 #include <vector>
 
 #define SAI_VPP_FDB_INFO "SAI_VPP_FDB_INFO"
@@ -99,6 +108,14 @@ namespace saivpp
 
             virtual sai_status_t create_ingress_priority_groups();
 
+            void add_port_ingress_priority_groups_attrs(
+                    _In_ sai_object_id_t port_id,
+                    _Inout_ std::vector<std::vector<sai_attribute_t>>& attr_lists) const;
+
+            sai_status_t set_port_ingress_priority_groups(
+                    _In_ sai_object_id_t port_id,
+                    _In_ sai_object_id_t *pgs);
+
             virtual sai_status_t create_vlan_members();
 
             virtual sai_status_t create_bridge_ports();
@@ -182,6 +199,29 @@ namespace saivpp
             virtual sai_status_t refresh_port_serdes_id(
                     _In_ sai_object_id_t bridge_id);
 
+        protected: // list membership
+
+            /*
+             * Keeps PORT_LIST, VLAN MEMBER_LIST and BRIDGE PORT_LIST
+             * membership up to date as members are created and removed.
+             */
+
+            void index_list_member(
+                    _In_ sai_object_type_t object_type,
+                    _In_ const std::string &serializedObjectId);
+
+            void unindex_list_member(
+                    _In_ sai_object_type_t object_type,
+                    _In_ sai_object_id_t object_id);
+
+            void rebuild_list_indexes();
+
+            ObjectListIndex m_portListIndex;
+
+            ObjectListIndex m_vlanMemberIndex;
+
+            ObjectListIndex m_bridgePortIndex;
+
         public:
 
             virtual sai_status_t warm_boot_initialize_objects();
@@ -237,6 +277,18 @@ namespace saivpp
                     _In_ uint32_t attr_count,
                     _In_ const sai_attribute_t *attr_list);
 
+            /**
+             * @brief Create many objects of the same type at once.
+             *
+             * Object ids are preallocated as one range and the attribute
+             * hashes are inserted into the object hash in one pass. Intended
+             * for default objects, custom create handlers are not called.
+             */
+            sai_status_t create_objects(
+                    _In_ sai_object_type_t object_type,
+                    _In_ const std::vector<std::vector<sai_attribute_t>>& attr_lists,
+                    _Out_ std::vector<sai_object_id_t>& object_ids);
+
             virtual sai_status_t remove(
                     _In_ sai_object_type_t object_type,
                     _In_ sai_object_id_t object_id);
@@ -503,6 +555,42 @@ namespace saivpp
             bool hasIfIndex(
                     _In_ int ifIndex) const;
 
+        protected: // hostif packet I/O
+
+            sai_status_t createHostifTableEntry(
+                    _In_ sai_object_id_t object_id,
+                    _In_ sai_object_id_t switch_id,
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list);
+
+            sai_status_t removeHostifTableEntry(
+                    _In_ sai_object_id_t objectId);
+
+            sai_status_t vpp_hostif_table_entry_punt_add(
+                    _In_ sai_object_id_t entry_id,
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list);
+
+            void vpp_hostif_table_entry_punt_del(
+                    _In_ sai_object_id_t entry_id);
+
+            std::shared_ptr<PuntSocket> getPuntSocket();
+
+            void update_punt_interfaces();
+
+        public:
+
+            /*
+             * Injects the packet into VPP, out of the egress port for pipeline
+             * bypass, or to the IP lookup for pipeline lookup.
+             */
+            sai_status_t sendHostifPacket(
+                    _In_ sai_object_id_t hif_id,
+                    _In_ sai_size_t buffer_size,
+                    _In_ const void *buffer,
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list);
+
         public: // TODO move inside warm boot load state
 
             sai_status_t vpp_recreate_hostif_tap_interfaces();
@@ -622,13 +710,41 @@ namespace saivpp
                     _In_ sai_object_id_t macsec_sa_id,
                     _Out_ sai_attribute_t &attr);
 
-            void retryCreateIngressMaCsecSAs();
+            void deferIngressMACsecSA(
+                    _In_ const MACsecAttr &macsec_attr);
+
+            void cancelIngressMACsecSAs(
+                    _In_ const std::string &macsec_name,
+                    _In_ const std::string &sci);
+
+            /*
+             * Retries the pending ingress SAs of the device whose backoff
+             * expired, or all of them on the event that may resolve them.
+             */
+            void retryCreateIngressMaCsecSAs(
+                    _In_ const std::string &macsec_name,
+                    _In_ bool ignore_backoff);
 
             MACsecManager m_macsecManager;
 
             std::unordered_map<sai_object_id_t, sai_object_id_t> m_macsecFlowPortMap;
 
-            std::unordered_set<MACsecAttr, MACsecAttr::Hash> m_uncreatedIngressMACsecSAs;
+            typedef struct _MACsecSARetry
+            {
+                uint32_t m_attempts;
+
+                std::chrono::steady_clock::time_point m_retryTime;
+
+            } MACsecSARetry;
+
+            /*
+             * Ingress SAs which could not be created yet, keyed by MACsec
+             * device they wait for. Retried when that device reports a link
+             * event or gets its egress SA.
+             */
+            std::map<std::string, std::unordered_map<MACsecAttr, MACsecSARetry, MACsecAttr::Hash>> m_uncreatedIngressMACsecSAs;
+
+            std::map<std::string, int> m_macsecIfIndex;
 
         protected:
 
@@ -701,12 +817,46 @@ namespace saivpp
 		    _In_ uint32_t attr_count,
 		    _In_ const sai_attribute_t *attr_list);
 
+            sai_status_t createRouterifs(
+                    _In_ sai_object_id_t switch_id,
+                    _In_ const std::vector<std::string>& serialized_object_ids,
+                    _In_ const uint32_t *attr_count,
+                    _In_ const sai_attribute_t **attr_list,
+                    _In_ sai_bulk_op_error_mode_t mode,
+                    _Out_ sai_status_t *object_statuses);
+
             sai_status_t removeRouterif(
                     _In_ sai_object_id_t objectId);
 
-	    sai_status_t vpp_create_router_interface(
-		    _In_ uint32_t attr_count,
-		    _In_ const sai_attribute_t *attr_list);
+            /*
+             * VPP side configuration of a router interface, collected from
+             * its attributes so that many router interfaces can be sent to
+             * VPP as one pipelined batch.
+             */
+            typedef struct _RifVppConfig
+            {
+                std::string m_hwifName;
+
+                std::string m_linuxIfname;
+
+                uint16_t m_vlanId;
+
+                sai_object_id_t m_vrfObjId;
+
+                uint32_t m_mtu; // 0 if not passed
+
+                int m_adminUp; // -1 if not passed
+
+            } RifVppConfig;
+
+            sai_status_t vpp_get_router_interface_config(
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list,
+                    _Out_ std::vector<RifVppConfig>& configs);
+
+            sai_status_t vpp_create_router_interfaces(
+                    _In_ const std::vector<RifVppConfig>& configs,
+                    _Out_ std::vector<sai_status_t>& statuses);
 
 	    sai_status_t vpp_update_router_interface(
 		    _In_ sai_object_id_t object_id,
@@ -791,14 +941,281 @@ namespace saivpp
                     _In_ uint32_t attr_count,
                     _In_ const sai_attribute_t *attr_list,
                     _In_ bool is_add);
+            sai_status_t IpRouteAddRemoveStored(
+                    _In_ const std::string &serializedObjectId,
+                    _In_ bool is_add);
+
+            /*
+             * Routes which can't be programmed in VPP yet wait in a pending
+             * queue, keyed by the missing dependency, and are retried when
+             * the event resolving it happens: the first router interface of
+             * the virtual router, the router interface or next hop of the
+             * route, or a host interface getting an address in the route
+             * prefix.
+             */
+
+            PendingRoutes::route_dep_t route_missing_dependency(
+                    _In_ const sai_route_entry_t& route_entry,
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list,
+                    _Out_ sai_object_id_t& dep_id);
+
+            void defer_route(
+                    _In_ const std::string &serializedObjectId,
+                    _In_ const sai_route_entry_t& route_entry,
+                    _In_ PendingRoutes::route_dep_t dep,
+                    _In_ sai_object_id_t dep_id);
+
+            bool cancel_pending_route(
+                    _In_ const std::string &serializedObjectId);
+
+            void retry_pending_routes(
+                    _In_ const std::set<std::string>& routes,
+                    _In_ const std::string& event);
+
+            void drain_pending_routes(
+                    _In_ PendingRoutes::route_dep_t dep,
+                    _In_ sai_object_id_t dep_id);
+
+            void drain_pending_address_routes(
+                    _In_ const std::vector<std::string>& addresses,
+                    _In_ const std::string& event);
+
+            /*
+             * Reads the host interface addresses only when routes wait for
+             * one.
+             */
+            void drain_pending_address_routes(
+                    _In_ const std::string& event);
+
+            sai_status_t createNextHop(
+                    _In_ const std::string &serializedObjectId,
+                    _In_ sai_object_id_t switch_id,
+                    _In_ uint32_t attr_count,
+                    _In_ const sai_attribute_t *attr_list);
+
+            void rekey_pending_route(
+                    _In_ const std::string &serializedObjectId);
+
+        private:
 
+            PendingRoutes m_pendingRoutes;
+
+        protected:
+
+            /*
+             * Admission control against VPP side capacity (see
+             * ResourceLimiter::resource_t), checked before anything is
+             * programmed in VPP.
+             */
+
+            size_t get_resource_limit(
+                    _In_ ResourceLimiter::resource_t resource,
+                    _In_ size_t default_limit) const;
+
+            sai_status_t check_route_admission(
+                    _In_ const sai_route_entry_t& entry);
+
+            sai_status_t check_neighbor_admission(
+                    _In_ const sai_neighbor_entry_t& entry);
+
+            sai_status_t check_sub_port_admission();
+
+            bool vpp_heap_exhausted();
+
+            void update_route_usage(
+                    _In_ const sai_route_entry_t& entry,
+                    _In_ int delta);
+
+            void update_neighbor_usage(
+                    _In_ const sai_neighbor_entry_t& entry,
+                    _In_ int delta);
+
+            void update_sub_port_usage(
+                    _In_ int delta);
+
+            void warm_update_resource_usage();
+
+            sai_status_t refresh_crm_available(
+                    _In_ const sai_attr_metadata_t *meta);
+
+        private:
+
+            size_t m_ipv4RouteCount = 0;
+            size_t m_ipv6RouteCount = 0;
+
+            std::map<sai_object_id_t, size_t> m_vrfRouteCount;
+
+            size_t m_ipv4NeighborCount = 0;
+            size_t m_ipv6NeighborCount = 0;
+
+            size_t m_subPortCount = 0;
+
+            bool m_heapExhausted = false;
+
+            std::chrono::steady_clock::time_point m_heapUsageTime;
+
+        public:
+
+            /*
+             * Route flow counters and per VRF route statistics, read from
+             * the /net/route/to combined counters of the VPP FIB entries.
+             */
+
+            typedef struct _VrfRouteSummary
+            {
+                size_t m_routes;
+
+                uint64_t m_packets;
+
+                uint64_t m_bytes;
+
+            } VrfRouteSummary;
+
+            sai_status_t setRouteCounterStats(
+                    _In_ sai_object_id_t counter_id);
+
+            sai_status_t setMACsecStats(
+                    _In_ sai_object_type_t object_type,
+                    _In_ sai_object_id_t object_id);
+
+            sai_status_t getVrfRouteSummary(
+                    _In_ sai_object_id_t vr_id,
+                    _Out_ VrfRouteSummary& summary);
+
+        protected:
+
+            void bind_route_counter(
+                    _In_ const std::string& serializedObjectId,
+                    _In_ sai_object_id_t counter_id);
+
+            void update_route_stats_index(
+                    _In_ const std::string& serializedObjectId,
+                    _In_ sai_object_id_t vr_id,
+                    _In_ uint32_t stats_index);
+
+            /*
+             * Rebinds route counters and looks up the FIB entry of each
+             * programmed route, both are lost with a warm restart.
+             */
+            void warm_update_route_counters();
+
+        private:
+
+            typedef struct _RouteStatsIndex
+            {
+                sai_object_id_t m_vrId;
+
+                uint32_t m_index; // load balance index of the FIB entry
+
+            } RouteStatsIndex;
+
+            std::unordered_map<std::string, RouteStatsIndex> m_routeStatsIndex;
+
+            std::unordered_map<sai_object_id_t, std::string> m_counterRoute;
+
+            std::unordered_map<std::string, sai_object_id_t> m_routeCounter;
+
+        public:
+
+            /*
+             * Port and port queue counters, mapped from the VPP interface
+             * counters and the DPDK extended stats of the port's hardware
+             * interface.
+             */
+
+            sai_status_t setPortStats(
+                    _In_ sai_object_id_t port_id);
+
+            /*
+             * VPP dataplane load and buffer/heap usage as vendor switch
+             * stats, see sai_vpp_switch_stat_t.
+             */
+
+            sai_status_t setSwitchStats(
+                    _In_ sai_object_id_t switch_id);
+
+            /*
+             * Counters of all front panel ports from a fresh snapshot, with
+             * clear baselines applied, for counter streaming.
+             */
+            void collectPortCounters(
+                    _Inout_ std::vector<CounterStream::ObjectCounters>& counters);
+
+            sai_status_t queryStatsCapability(
+                    _In_ sai_object_id_t switchId,
+                    _In_ sai_object_type_t objectType,
+                    _Inout_ sai_stat_capability_list_t *stats_capability) override;
+
+        private:
+
+            void switchStatsCapability(
+                    _Inout_ std::map<sai_stat_id_t, uint32_t>& supported) const;
+
+        protected:
+
+            /*
+             * VPP stats segment snapshot shared by all counter reads of a
+             * poll cycle, taken again once it is older than the poll
+             * interval. Returns nullptr if VPP stats are not available.
+             */
+            std::shared_ptr<const VppStatsSnapshot> get_stats_snapshot(
+                    _In_ bool withRoutes);
+
+        private:
+
+            std::shared_ptr<const VppStatsSnapshot> m_statsSnapshot;
+
+            std::chrono::steady_clock::time_point m_statsSnapshotTime;
+
+            // xstats seen in any snapshot, for queryStatsCapability
+            std::set<std::string> m_portXstatNames;
+
+        protected:
 
             int vpp_add_ip_vrf(_In_ sai_object_id_t objectId, uint32_t vrf_id);
 	    int vpp_del_ip_vrf(_In_ sai_object_id_t objectId);
 
-            int vpp_get_vrf_id(const char *linux_ifname, uint32_t *vrf_id);
+            /*
+             * Adds the ipv4 or ipv6 table of the VRF to VPP on its first user
+             * and deletes it with the last one. No-op for the default VRF.
+             */
+            int vpp_ip_vrf_ref(
+                    _In_ sai_object_id_t objectId,
+                    _In_ bool is_ipv6,
+                    _In_ const std::string& user);
+
+            int vpp_ip_vrf_unref(
+                    _In_ sai_object_id_t objectId,
+                    _In_ bool is_ipv6,
+                    _In_ const std::string& user);
+
+            /*
+             * Binds a router interface in the ipv6 table of its VRF, done
+             * with its first ipv6 address. No-op for the default VRF.
+             */
+            int vpp_router_interface_bind_ipv6(
+                    _In_ sai_object_id_t vr_id,
+                    _In_ const char *hwif_name,
+                    _In_ uint16_t vlan_id);
+
+            sai_status_t vpp_router_interface_vrf_unref(
+                    _In_ sai_object_id_t rif_id,
+                    _In_ sai_object_id_t port_id,
+                    _In_ uint16_t vlan_id);
+
+            int vpp_get_vrf_ids(_Out_ std::map<std::string, uint32_t>& vrf_ids);
+
+            int vpp_get_host_addresses(_Out_ std::vector<std::string>& addresses);
 
         public:
+
+            /*
+             * Makes this switch's VPP instance the target of the VPP api and
+             * stats clients, must be called before any VPP access.
+             */
+            int vpp_client_activate();
+
             bool vpp_get_hwif_name (
 		    _In_ sai_object_id_t object_id,
                     _In_ uint32_t vlan_id,
@@ -808,10 +1225,21 @@ namespace saivpp
 	    void populate_if_mapping();
 	    const char *tap_to_hwif_name(const char *name);
 
-        private:
+            /*
+             * VPP hardware interface name of each SONiC port name, from
+             * sonic_vpp_ifmap.ini.
+             */
 	    std::map<std::string, std::string> m_hostif_hwif_map;
+
+        private:
 	    int mapping_init = 0;
 
+            // opened on the first genetlink trap or sent packet
+            std::shared_ptr<PuntSocket> m_puntSocket;
+
+            // VPP punts registered for a genetlink hostif table entry
+            std::map<sai_object_id_t, std::vector<vpp_punt_t>> m_hostifTableEntryPunts;
+
         public: // TODO private
 
             std::set<FdbInfo> m_fdb_info_set;
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SwitchStateBase.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+#include "vppxlate/SaiVppStats.h"
+
+#include <algorithm>
+
+using namespace saivpp;
+
+/*
+ * Heap usage is read from the VPP stats segment, so it is sampled at most
+ * this often rather than on every create.
+ */
+#define SAI_VPP_HEAP_USAGE_REFRESH_MS 1000
+
+#define SAI_VPP_MAIN_HEAP "main heap"
+
+size_t SwitchStateBase::get_resource_limit(
+        _In_ ResourceLimiter::resource_t resource,
+        _In_ size_t default_limit) const
+{
+    SWSS_LOG_ENTER();
+
+    if (m_switchConfig->m_resourceLimiter)
+    {
+        size_t limit = m_switchConfig->m_resourceLimiter->getResourceLimit(resource);
+
+        if (limit != SIZE_MAX)
+        {
+            return limit;
+        }
+    }
+
+    return default_limit;
+}
+
+bool SwitchStateBase::vpp_heap_exhausted()
+{
+    SWSS_LOG_ENTER();
+
+    size_t threshold = get_resource_limit(ResourceLimiter::RESOURCE_VPP_HEAP_USAGE_PERCENT, SIZE_MAX);
+
+    if (threshold == SIZE_MAX || m_switchConfig->m_useTapDevice == false)
+    {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (now - m_heapUsageTime < std::chrono::milliseconds(SAI_VPP_HEAP_USAGE_REFRESH_MS))
+    {
+        return m_heapExhausted;
+    }
+
+    m_heapUsageTime = now;
+
+    vpp_heap_usage_t usage;
+
+    if (vpp_heap_usage_query(SAI_VPP_MAIN_HEAP, &usage) != 0 || usage.total == 0)
+    {
+        SWSS_LOG_WARN("failed to read VPP %s usage", SAI_VPP_MAIN_HEAP);
+
+        m_heapExhausted = false;
+
+        return m_heapExhausted;
+    }
+
+    bool exhausted = (usage.used * 100 >= usage.total * threshold);
+
+    if (exhausted != m_heapExhausted)
+    {
+        SWSS_LOG_NOTICE("VPP %s usage %lu of %lu bytes is %s %zu%% threshold",
+                SAI_VPP_MAIN_HEAP,
+                usage.used,
+                usage.total,
+                exhausted ? "above" : "below",
+                threshold);
+    }
+
+    m_heapExhausted = exhausted;
+
+    return m_heapExhausted;
+}
+
+/*
+ * Only limits configured in the resource limiter are enforced, the default
+ * CRM capacities are reported to orchagent but are not VPP limits.
+ */
+sai_status_t SwitchStateBase::check_route_admission(
+        _In_ const sai_route_entry_t& entry)
+{
+    SWSS_LOG_ENTER();
+
+    bool is_v4 = (entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4);
+
+    size_t used = is_v4 ? m_ipv4RouteCount : m_ipv6RouteCount;
+
+    size_t limit = is_v4 ?
+        get_resource_limit(ResourceLimiter::RESOURCE_IPV4_ROUTE_ENTRY, SIZE_MAX) :
+        get_resource_limit(ResourceLimiter::RESOURCE_IPV6_ROUTE_ENTRY, SIZE_MAX);
+
+    if (used >= limit)
+    {
+        SWSS_LOG_ERROR("too many %s routes, %zu is resource limit", is_v4 ? "IPv4" : "IPv6", limit);
+
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    size_t vrf_limit = get_resource_limit(ResourceLimiter::RESOURCE_VRF_ROUTE_ENTRY, SIZE_MAX);
+
+    if (vrf_limit != SIZE_MAX)
+    {
+        auto it = m_vrfRouteCount.find(entry.vr_id);
+
+        if (it != m_vrfRouteCount.end() && it->second >= vrf_limit)
+        {
+            SWSS_LOG_ERROR("too many routes in virtual router %s, %zu is resource limit",
+                    sai_serialize_object_id(entry.vr_id).c_str(),
+                    vrf_limit);
+
+            return SAI_STATUS_INSUFFICIENT_RESOURCES;
+        }
+    }
+
+    if (vpp_heap_exhausted())
+    {
+        SWSS_LOG_ERROR("VPP heap usage is above threshold, rejecting route");
+
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::check_neighbor_admission(
+        _In_ const sai_neighbor_entry_t& entry)
+{
+    SWSS_LOG_ENTER();
+
+    bool is_v4 = (entry.ip_address.addr_family == SAI_IP_ADDR_FAMILY_IPV4);
+
+    size_t used = is_v4 ? m_ipv4NeighborCount : m_ipv6NeighborCount;
+
+    size_t limit = is_v4 ?
+        get_resource_limit(ResourceLimiter::RESOURCE_IPV4_NEIGHBOR_ENTRY, SIZE_MAX) :
+        get_resource_limit(ResourceLimiter::RESOURCE_IPV6_NEIGHBOR_ENTRY, SIZE_MAX);
+
+    if (used >= limit)
+    {
+        SWSS_LOG_ERROR("too many %s neighbors, %zu is resource limit", is_v4 ? "IPv4" : "IPv6", limit);
+
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (vpp_heap_exhausted())
+    {
+        SWSS_LOG_ERROR("VPP heap usage is above threshold, rejecting neighbor");
+
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::check_sub_port_admission()
+{
+    SWSS_LOG_ENTER();
+
+    size_t limit = get_resource_limit(ResourceLimiter::RESOURCE_SUB_PORT_ROUTER_INTERFACE, SIZE_MAX);
+
+    if (m_subPortCount >= limit)
+    {
+        SWSS_LOG_ERROR("too many sub port router interfaces, %zu is resource limit", limit);
+
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void update_usage(
+        _Inout_ size_t& count,
+        _In_ int delta)
+{
+    SWSS_LOG_ENTER();
+
+    if (delta < 0 && count < (size_t)(-delta))
+    {
+        count = 0;
+        return;
+    }
+
+    count += delta;
+}
+
+void SwitchStateBase::update_route_usage(
+        _In_ const sai_route_entry_t& entry,
+        _In_ int delta)
+{
+    SWSS_LOG_ENTER();
+
+    if (entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        update_usage(m_ipv4RouteCount, delta);
+    }
+    else
+    {
+        update_usage(m_ipv6RouteCount, delta);
+    }
+
+    auto& vrf_count = m_vrfRouteCount[entry.vr_id];
+
+    update_usage(vrf_count, delta);
+
+    if (vrf_count == 0)
+    {
+        m_vrfRouteCount.erase(entry.vr_id);
+    }
+}
+
+void SwitchStateBase::update_neighbor_usage(
+        _In_ const sai_neighbor_entry_t& entry,
+        _In_ int delta)
+{
+    SWSS_LOG_ENTER();
+
+    if (entry.ip_address.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        update_usage(m_ipv4NeighborCount, delta);
+    }
+    else
+    {
+        update_usage(m_ipv6NeighborCount, delta);
+    }
+}
+
+void SwitchStateBase::update_sub_port_usage(
+        _In_ int delta)
+{
+    SWSS_LOG_ENTER();
+
+    update_usage(m_subPortCount, delta);
+}
+
+void SwitchStateBase::warm_update_resource_usage()
+{
+    SWSS_LOG_ENTER();
+
+    for (auto& kvp: m_objectHash.at(SAI_OBJECT_TYPE_ROUTE_ENTRY))
+    {
+        sai_route_entry_t entry;
+
+        sai_deserialize_route_entry(kvp.first, entry);
+
+        update_route_usage(entry, 1);
+    }
+
+    for (auto& kvp: m_objectHash.at(SAI_OBJECT_TYPE_NEIGHBOR_ENTRY))
+    {
+        sai_neighbor_entry_t entry;
+
+        sai_deserialize_neighbor_entry(kvp.first, entry);
+
+        update_neighbor_usage(entry, 1);
+    }
+
+    for (auto& kvp: m_objectHash.at(SAI_OBJECT_TYPE_ROUTER_INTERFACE))
+    {
+        sai_attribute_t attr;
+
+        attr.id = SAI_ROUTER_INTERFACE_ATTR_TYPE;
+
+        if (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, kvp.first, 1, &attr) == SAI_STATUS_SUCCESS &&
+                attr.value.s32 == SAI_ROUTER_INTERFACE_TYPE_SUB_PORT)
+        {
+            update_sub_port_usage(1);
+        }
+    }
+
+    SWSS_LOG_NOTICE("resource usage after warm boot: routes %zu/%zu, neighbors %zu/%zu, sub ports %zu",
+            m_ipv4RouteCount, m_ipv6RouteCount,
+            m_ipv4NeighborCount, m_ipv6NeighborCount,
+            m_subPortCount);
+}
+
+sai_status_t SwitchStateBase::refresh_crm_available(
+        _In_ const sai_attr_metadata_t *meta)
+{
+    SWSS_LOG_ENTER();
+
+    size_t used;
+    size_t limit;
+
+    switch (meta->attrid)
+    {
+        case SAI_SWITCH_ATTR_AVAILABLE_IPV4_ROUTE_ENTRY:
+            used = m_ipv4RouteCount;
+            limit = get_resource_limit(ResourceLimiter::RESOURCE_IPV4_ROUTE_ENTRY, m_maxIPv4RouteEntries);
+            break;
+
+        case SAI_SWITCH_ATTR_AVAILABLE_IPV6_ROUTE_ENTRY:
+            used = m_ipv6RouteCount;
+            limit = get_resource_limit(ResourceLimiter::RESOURCE_IPV6_ROUTE_ENTRY, m_maxIPv6RouteEntries);
+            break;
+
+        case SAI_SWITCH_ATTR_AVAILABLE_IPV4_NEIGHBOR_ENTRY:
+            used = m_ipv4NeighborCount;
+            limit = get_resource_limit(ResourceLimiter::RESOURCE_IPV4_NEIGHBOR_ENTRY, m_maxIPv4NeighborEntries);
+            break;
+
+        case SAI_SWITCH_ATTR_AVAILABLE_IPV6_NEIGHBOR_ENTRY:
+            used = m_ipv6NeighborCount;
+            limit = get_resource_limit(ResourceLimiter::RESOURCE_IPV6_NEIGHBOR_ENTRY, m_maxIPv6NeighborEntries);
+            break;
+
+        default:
+            return SAI_STATUS_SUCCESS;
+    }
+
+    /*
+     * With VPP heap over its threshold nothing more can be admitted, report
+     * it so CRM raises the threshold event and orchagent backs off.
+     */
+
+    size_t available = (used >= limit || vpp_heap_exhausted()) ? 0 : limit - used;
+
+    sai_attribute_t attr;
+
+    attr.id = meta->attrid;
+    attr.value.u32 = (uint32_t)std::min(available, (size_t)UINT32_MAX);
+
+    return set(SAI_OBJECT_TYPE_SWITCH, m_switch_id, &attr);
+}
@@ -586,6 +586,8 @@ bool SwitchStateBase::hostif_create_tap_veth_forwarding(
                 port_id,
                 m_switchConfig->m_eventQueue);
 
+    addLinkIfIndex(sock_address.sll_ifindex);
+
     SWSS_LOG_NOTICE("setup forward rule for %s succeeded", tapname.c_str());
 
     return true;
@@ -675,25 +677,20 @@ sai_status_t SwitchStateBase::vpp_create_hostif_tap_interface(
 
     std::string name = std::string(attr_name->value.chardata);
 
-    // create TAP device
-
     SWSS_LOG_INFO("creating hostif %s", name.c_str());
 
-    // int tapfd = vpp_create_tap_device(name.c_str(), IFF_TAP);
-    int tapfd = vpp_create_tap_device(name.c_str(), IFF_TAP | IFF_MULTI_QUEUE | IFF_NO_PI | IFF_VNET_HDR);
+    // linux-cp creates the host TAP and punts to it
+    const char *dev = name.c_str();
 
-    if (tapfd < 0)
-    {
-        SWSS_LOG_ERROR("failed to create TAP device for %s", name.c_str());
+    init_vpp_client();
+    configure_lcp_interface(tap_to_hwif_name(dev), dev);
 
-        return SAI_STATUS_FAILURE;
-    }
+    auto offload = m_switchConfig->m_hostifOffload;
 
-    SWSS_LOG_ERROR("created TAP device for %s, fd: %d", name.c_str(), tapfd);
+    if (offload != SAI_VPP_HOSTIF_OFFLOAD_NONE &&
+            lcp_host_tap_set_offload(dev, offload == SAI_VPP_HOSTIF_OFFLOAD_GSO, true) != 0)
     {
-        const char *dev = name.c_str();
-	init_vpp_client();
-	configure_lcp_interface(tap_to_hwif_name(dev), dev);
+        SWSS_LOG_WARN("failed to enable offloads on host TAP of %s", dev);
     }
 
     sai_attribute_t attr;
@@ -721,8 +718,6 @@ sai_status_t SwitchStateBase::vpp_create_hostif_tap_interface(
                 sai_serialize_mac(attr.value.mac).c_str(),
                 name.c_str());
 
-        close(tapfd);
-
         return SAI_STATUS_FAILURE;
     }
     */
@@ -874,23 +869,20 @@ sai_status_t SwitchStateBase::vpp_remove_hostif_tap_interface(
     // TODO this should be hosif_id or if index ?
     std::string name = std::string(attr.value.chardata);
 
-    /*
     auto it = m_hostif_info_map.find(name);
 
-    if (it == m_hostif_info_map.end())
+    if (it != m_hostif_info_map.end())
     {
-        SWSS_LOG_ERROR("failed to find host info entry for tap device: %s", name.c_str());
+        SWSS_LOG_NOTICE("attempting to remove tap device: %s", name.c_str());
 
-        return SAI_STATUS_FAILURE;
-    }
+        // link messages of the interface are no longer delivered to this switch
 
-    SWSS_LOG_NOTICE("attempting to remove tap device: %s", name.c_str());
+        removeLinkIfIndex(it->second->m_ifindex);
 
-    auto info = it->second; // destructor will stop threads
-    */
-    // remove host info entry from map
+        // remove host info entry from map, destructor will stop threads
 
-    // m_hostif_info_map.erase(it);
+        m_hostif_info_map.erase(it);
+    }
 
     // remove interface mapping
 
@@ -924,6 +916,15 @@ sai_status_t SwitchStateBase::createHostif(
 
     CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_HOSTIF, sid, switch_id, attr_count, attr_list));
 
+    if (m_switchConfig->m_useTapDevice == true)
+    {
+        // punted packets of the new port go to its host netdev
+
+        update_punt_interfaces();
+
+        drain_pending_address_routes("host interface create");
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -980,17 +981,30 @@ void SwitchStateBase::syncOnLinkMsg(
 
     auto msgtype = payload->getNlmsgType();
 
+    if (msgtype == RTM_NEWADDR)
+    {
+        drain_pending_address_routes({ payload->getIpAddress() }, "host interface address " + payload->getIpAddress());
+        return;
+    }
+
     if (msgtype != RTM_NEWLINK)
     {
         // ignore delete message
         return;
     }
 
+    if (m_uncreatedIngressMACsecSAs.find(ifname) != m_uncreatedIngressMACsecSAs.end())
+    {
+        // MACsec device came up, its pending ingress SAs can be created
+
+        retryCreateIngressMaCsecSAs(ifname, true);
+        return;
+    }
+
     if (!hasIfIndex(ifindex))
     {
-        // since we will receive messages from all indexes and all switches
-        // then we only need to check messages addressed for us and since
-        // ifindex is unique across system, then we will use that
+        // registrar already filters on owned ifindex, but message may be
+        // queued before this switch dropped the interface
 
         return;
     }
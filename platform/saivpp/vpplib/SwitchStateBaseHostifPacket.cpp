@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SwitchStateBase.h"
+#include "PuntSocket.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <linux/if_ether.h>
+#include <netinet/in.h>
+#include <string.h>
+
+using namespace saivpp;
+
+// VPP side of the punt socket, "punt { socket <path> }" in startup.conf
+#define SAI_VPP_PUNT_SOCKET_DEFAULT "/run/vpp/punt.sock"
+
+#define SAI_VPP_IPPROTO_OSPF 89
+#define SAI_VPP_IPPROTO_VRRP 112
+
+/*
+ * Traps VPP 23.02 can punt to a socket, by UDP port or IP protocol. Others,
+ * sampled packets included, have no VPP punt and stay on the host TAP.
+ */
+static const std::map<int32_t, std::vector<vpp_punt_t>> trap_punts = {
+    { SAI_HOSTIF_TRAP_TYPE_BFD,     { { false, IPPROTO_UDP, 3784 } } },
+    { SAI_HOSTIF_TRAP_TYPE_BFDV6,   { { true,  IPPROTO_UDP, 3784 } } },
+    { SAI_HOSTIF_TRAP_TYPE_DHCP,    { { false, IPPROTO_UDP, 67 }, { false, IPPROTO_UDP, 68 } } },
+    { SAI_HOSTIF_TRAP_TYPE_DHCPV6,  { { true,  IPPROTO_UDP, 547 }, { true, IPPROTO_UDP, 546 } } },
+    { SAI_HOSTIF_TRAP_TYPE_SNMP,    { { false, IPPROTO_UDP, 161 }, { true, IPPROTO_UDP, 161 } } },
+    { SAI_HOSTIF_TRAP_TYPE_OSPF,    { { false, SAI_VPP_IPPROTO_OSPF, 0 } } },
+    { SAI_HOSTIF_TRAP_TYPE_OSPFV6,  { { true,  SAI_VPP_IPPROTO_OSPF, 0 } } },
+    { SAI_HOSTIF_TRAP_TYPE_VRRP,    { { false, SAI_VPP_IPPROTO_VRRP, 0 } } },
+    { SAI_HOSTIF_TRAP_TYPE_VRRPV6,  { { true,  SAI_VPP_IPPROTO_VRRP, 0 } } },
+    { SAI_HOSTIF_TRAP_TYPE_PIM,     { { false, IPPROTO_PIM, 0 }, { true, IPPROTO_PIM, 0 } } },
+};
+
+std::shared_ptr<PuntSocket> SwitchStateBase::getPuntSocket()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_puntSocket)
+    {
+        return m_puntSocket;
+    }
+
+    std::string server = m_switchConfig->m_vppPuntSocket.empty()
+        ? SAI_VPP_PUNT_SOCKET_DEFAULT
+        : m_switchConfig->m_vppPuntSocket;
+
+    std::string client = server + ".sai" + std::to_string(m_switchConfig->m_switchIndex);
+
+    auto puntSocket = std::make_shared<PuntSocket>(client, server);
+
+    if (!puntSocket->open())
+    {
+        return nullptr;
+    }
+
+    m_puntSocket = puntSocket;
+
+    return m_puntSocket;
+}
+
+void SwitchStateBase::update_punt_interfaces()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_puntSocket == nullptr)
+    {
+        return;
+    }
+
+    // rx interface of punted packets to host netdev of the port
+
+    for (auto& kvp: m_objectHash.at(SAI_OBJECT_TYPE_PORT))
+    {
+        sai_object_id_t port_id;
+
+        sai_deserialize_object_id(kvp.first, port_id);
+
+        std::string tap_name;
+        std::string hwif_name;
+        uint32_t sw_if_index;
+
+        if (!getTapNameFromPortId(port_id, tap_name) ||
+                !vpp_get_hwif_name(port_id, 0, hwif_name) ||
+                get_sw_if_index(hwif_name.c_str(), &sw_if_index) != 0)
+        {
+            continue;
+        }
+
+        m_puntSocket->setInterface(sw_if_index, if_nametoindex(tap_name.c_str()));
+    }
+}
+
+sai_status_t SwitchStateBase::vpp_hostif_table_entry_punt_add(
+        _In_ sai_object_id_t entry_id,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list)
+{
+    SWSS_LOG_ENTER();
+
+    auto attr_type = sai_metadata_get_attr_by_id(SAI_HOSTIF_TABLE_ENTRY_ATTR_TYPE, attr_count, attr_list);
+    auto attr_channel = sai_metadata_get_attr_by_id(SAI_HOSTIF_TABLE_ENTRY_ATTR_CHANNEL_TYPE, attr_count, attr_list);
+
+    if (attr_type == NULL || attr_channel == NULL ||
+            attr_type->value.s32 != SAI_HOSTIF_TABLE_ENTRY_TYPE_TRAP_ID ||
+            attr_channel->value.s32 != SAI_HOSTIF_TABLE_ENTRY_CHANNEL_TYPE_GENETLINK)
+    {
+        // netdev channels are served by linux-cp
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    auto attr_trap = sai_metadata_get_attr_by_id(SAI_HOSTIF_TABLE_ENTRY_ATTR_TRAP_ID, attr_count, attr_list);
+    auto attr_hostif = sai_metadata_get_attr_by_id(SAI_HOSTIF_TABLE_ENTRY_ATTR_HOST_IF, attr_count, attr_list);
+
+    if (attr_trap == NULL || attr_hostif == NULL)
+    {
+        SWSS_LOG_ERROR("genetlink hostif table entry needs trap id and host interface");
+
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_TYPE;
+
+    if (objectTypeQuery(attr_trap->value.oid) != SAI_OBJECT_TYPE_HOSTIF_TRAP ||
+            get(SAI_OBJECT_TYPE_HOSTIF_TRAP, attr_trap->value.oid, 1, &attr) != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_NOTICE("trap %s has no VPP punt, not delivered on genetlink",
+                sai_serialize_object_id(attr_trap->value.oid).c_str());
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    int32_t trap_type = attr.value.s32;
+
+    auto it = trap_punts.find(trap_type);
+
+    if (it == trap_punts.end())
+    {
+        SWSS_LOG_NOTICE("trap %s has no VPP punt, not delivered on genetlink",
+                sai_serialize_enum(trap_type, &sai_metadata_enum_sai_hostif_trap_type_t).c_str());
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    // genetlink family and multicast group of the host interface
+
+    std::string family;
+    std::string mcgrp;
+
+    attr.id = SAI_HOSTIF_ATTR_NAME;
+
+    CHECK_STATUS(get(SAI_OBJECT_TYPE_HOSTIF, attr_hostif->value.oid, 1, &attr));
+
+    family = std::string(attr.value.chardata, strnlen(attr.value.chardata, sizeof(attr.value.chardata)));
+
+    attr.id = SAI_HOSTIF_ATTR_GENETLINK_MCGRP_NAME;
+
+    CHECK_STATUS(get(SAI_OBJECT_TYPE_HOSTIF, attr_hostif->value.oid, 1, &attr));
+
+    mcgrp = std::string(attr.value.chardata, strnlen(attr.value.chardata, sizeof(attr.value.chardata)));
+
+    auto puntSocket = getPuntSocket();
+
+    if (puntSocket == nullptr)
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    auto channel = puntSocket->getChannel(family, mcgrp);
+
+    if (channel == nullptr)
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    update_punt_interfaces();
+
+    auto& registered = m_hostifTableEntryPunts[entry_id];
+
+    for (auto& punt: it->second)
+    {
+        if (!puntSocket->addTrap(punt, (uint32_t)trap_type, channel))
+        {
+            // already registered in VPP by another table entry
+
+            registered.push_back(punt);
+
+            continue;
+        }
+
+        char server_path[108];
+
+        if (punt_socket_register(&punt, puntSocket->getClientPath().c_str(), server_path, sizeof(server_path)) != 0)
+        {
+            SWSS_LOG_ERROR("VPP punt of %s proto %u port %u failed, is the punt socket enabled in VPP?",
+                    punt.is_ipv6 ? "ip6" : "ip4", punt.protocol, punt.port);
+
+            puntSocket->removeTrap(punt);
+
+            // drop the registrations this entry already made
+
+            vpp_hostif_table_entry_punt_del(entry_id);
+
+            return SAI_STATUS_FAILURE;
+        }
+
+        if (server_path[0] && m_switchConfig->m_vppPuntSocket.empty())
+        {
+            puntSocket->setServerPath(server_path);
+        }
+
+        registered.push_back(punt);
+    }
+
+    SWSS_LOG_NOTICE("trap %s punted on %zu VPP registrations to %s/%s",
+            sai_serialize_enum(trap_type, &sai_metadata_enum_sai_hostif_trap_type_t).c_str(),
+            registered.size(), family.c_str(), mcgrp.c_str());
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void SwitchStateBase::vpp_hostif_table_entry_punt_del(
+        _In_ sai_object_id_t entry_id)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_hostifTableEntryPunts.find(entry_id);
+
+    if (it == m_hostifTableEntryPunts.end())
+    {
+        return;
+    }
+
+    for (auto& punt: it->second)
+    {
+        if (!m_puntSocket->removeTrap(punt))
+        {
+            continue;
+        }
+
+        if (punt_socket_deregister(&punt) != 0)
+        {
+            SWSS_LOG_WARN("failed to remove VPP punt of %s proto %u port %u",
+                    punt.is_ipv6 ? "ip6" : "ip4", punt.protocol, punt.port);
+        }
+    }
+
+    m_hostifTableEntryPunts.erase(it);
+}
+
+sai_status_t SwitchStateBase::createHostifTableEntry(
+        _In_ sai_object_id_t object_id,
+        _In_ sai_object_id_t switch_id,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list)
+{
+    SWSS_LOG_ENTER();
+
+    auto sid = sai_serialize_object_id(object_id);
+
+    CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY, sid, switch_id, attr_count, attr_list));
+
+    sai_status_t status = vpp_hostif_table_entry_punt_add(object_id, attr_count, attr_list);
+
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        remove_internal(SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY, sid);
+    }
+
+    return status;
+}
+
+sai_status_t SwitchStateBase::removeHostifTableEntry(
+        _In_ sai_object_id_t objectId)
+{
+    SWSS_LOG_ENTER();
+
+    vpp_hostif_table_entry_punt_del(objectId);
+
+    auto sid = sai_serialize_object_id(objectId);
+
+    CHECK_STATUS(remove_internal(SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY, sid));
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::sendHostifPacket(
+        _In_ sai_object_id_t hif_id,
+        _In_ sai_size_t buffer_size,
+        _In_ const void *buffer,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list)
+{
+    SWSS_LOG_ENTER();
+
+    auto attr_tx_type = sai_metadata_get_attr_by_id(SAI_HOSTIF_PACKET_ATTR_HOSTIF_TX_TYPE, attr_count, attr_list);
+
+    if (attr_tx_type == NULL)
+    {
+        SWSS_LOG_ERROR("attr SAI_HOSTIF_PACKET_ATTR_HOSTIF_TX_TYPE was not passed");
+
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    if (buffer_size < ETH_HLEN)
+    {
+        SWSS_LOG_ERROR("packet of %u bytes is too short", (uint32_t)buffer_size);
+
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    // egress port, or the port of a netdev host interface
+
+    sai_object_id_t port_id = SAI_NULL_OBJECT_ID;
+
+    auto attr_port = sai_metadata_get_attr_by_id(SAI_HOSTIF_PACKET_ATTR_EGRESS_PORT_OR_LAG, attr_count, attr_list);
+
+    if (attr_port)
+    {
+        port_id = attr_port->value.oid;
+    }
+    else if (hif_id != SAI_NULL_OBJECT_ID)
+    {
+        sai_attribute_t attr;
+
+        attr.id = SAI_HOSTIF_ATTR_OBJ_ID;
+
+        if (get(SAI_OBJECT_TYPE_HOSTIF, hif_id, 1, &attr) == SAI_STATUS_SUCCESS)
+        {
+            port_id = attr.value.oid;
+        }
+    }
+
+    uint32_t sw_if_index = ~0U;
+
+    if (port_id != SAI_NULL_OBJECT_ID)
+    {
+        if (objectTypeQuery(port_id) != SAI_OBJECT_TYPE_PORT)
+        {
+            SWSS_LOG_ERROR("packet egress %s is not a port", sai_serialize_object_id(port_id).c_str());
+
+            return SAI_STATUS_NOT_SUPPORTED;
+        }
+
+        std::string hwif_name;
+
+        if (!vpp_get_hwif_name(port_id, 0, hwif_name) ||
+                get_sw_if_index(hwif_name.c_str(), &sw_if_index) != 0)
+        {
+            SWSS_LOG_ERROR("no VPP interface for port %s", sai_serialize_object_id(port_id).c_str());
+
+            return SAI_STATUS_FAILURE;
+        }
+    }
+
+    auto data = static_cast<const uint8_t*>(buffer);
+
+    uint32_t action;
+
+    switch (attr_tx_type->value.s32)
+    {
+        case SAI_HOSTIF_TX_TYPE_PIPELINE_BYPASS:
+
+            if (sw_if_index == ~0U)
+            {
+                SWSS_LOG_ERROR("pipeline bypass needs an egress port");
+
+                return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+            }
+
+            action = VPP_PUNT_ACTION_L2;
+            break;
+
+        case SAI_HOSTIF_TX_TYPE_PIPELINE_LOOKUP:
+        {
+            // routed by VPP in the table of the port, the default one without
+
+            uint16_t ethertype = (uint16_t)((data[12] << 8) | data[13]);
+
+            if (ethertype == ETHERTYPE_IP)
+            {
+                action = VPP_PUNT_ACTION_IP4_ROUTED;
+            }
+            else if (ethertype == ETHERTYPE_IPV6)
+            {
+                action = VPP_PUNT_ACTION_IP6_ROUTED;
+            }
+            else
+            {
+                SWSS_LOG_ERROR("pipeline lookup of ethertype 0x%04x is not supported", ethertype);
+
+                return SAI_STATUS_NOT_SUPPORTED;
+            }
+
+            if (sw_if_index == ~0U)
+            {
+                sw_if_index = 0;
+            }
+
+            data += ETH_HLEN;
+            buffer_size -= ETH_HLEN;
+            break;
+        }
+
+        default:
+
+            SWSS_LOG_ERROR("hostif tx type %d is not supported", attr_tx_type->value.s32);
+
+            return SAI_STATUS_NOT_SUPPORTED;
+    }
+
+    auto puntSocket = getPuntSocket();
+
+    if (puntSocket == nullptr ||
+            !puntSocket->inject(sw_if_index, action, data, buffer_size))
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
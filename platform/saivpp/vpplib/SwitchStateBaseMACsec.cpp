@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <regex>
+#include <algorithm>
 
 #include <net/if.h>
 #include <arpa/inet.h>
@@ -36,6 +37,16 @@ using namespace saivpp;
 #define MACSEC_PORT_IDENTIFIER (4)
 #define MACSEC_SCI_LENGTH (MACSEC_SYSTEM_IDENTIFIER + MACSEC_PORT_IDENTIFIER)
 
+/*
+ * Pending ingress SA creation polled by counter reads backs off
+ * exponentially between attempts. Once the retry budget is exhausted the
+ * failure is logged and the SA stays pending, retried at the maximum
+ * interval. The egress SA and the device link events retry it at once.
+ */
+#define SAI_VPP_MACSEC_SA_RETRY_BASE_MS 100
+#define SAI_VPP_MACSEC_SA_RETRY_MAX_MS 10000
+#define SAI_VPP_MACSEC_SA_RETRY_BUDGET 10
+
 #define SAI_METADATA_GET_ATTR_BY_ID(attr, attrId, attrCount, attrList) \
 { \
     attr = sai_metadata_get_attr_by_id(attrId, attrCount, attrList); \
@@ -111,7 +122,7 @@ sai_status_t SwitchStateBase::setAclEntryMACsecFlowActive(
                     }
                     else
                     {
-                        m_uncreatedIngressMACsecSAs.insert(macsecAttr);
+                        deferIngressMACsecSA(macsecAttr);
                     }
                 }
             }
@@ -192,6 +203,17 @@ sai_status_t SwitchStateBase::createMACsecPort(
         if (m_macsecManager.create_macsec_port(macsecAttr))
         {
             SWSS_LOG_NOTICE("Enable MACsec port %s", macsecAttr.m_macsecName.c_str());
+
+            int ifindex = (int)if_nametoindex(macsecAttr.m_macsecName.c_str());
+
+            if (macsecAttr.m_direction == SAI_MACSEC_DIRECTION_EGRESS && ifindex != 0)
+            {
+                // link events of MACsec device trigger pending ingress SAs
+
+                m_macsecIfIndex[macsecAttr.m_macsecName] = ifindex;
+
+                addLinkIfIndex(ifindex);
+            }
         }
     }
 
@@ -249,7 +271,7 @@ sai_status_t SwitchStateBase::createMACsecSA(
             // So retry to create them.
             if (macsecAttr.m_direction == SAI_MACSEC_DIRECTION_EGRESS)
             {
-                retryCreateIngressMaCsecSAs();
+                retryCreateIngressMaCsecSAs(macsecAttr.m_macsecName, true);
             }
         }
         else
@@ -257,7 +279,7 @@ sai_status_t SwitchStateBase::createMACsecSA(
             // In Linux MACsec model, Egress SA need to be created before ingress SA.
             // So, if try to create the ingress SA firstly, it will failed.
             // But to create the egress SA should be always successful.
-            m_uncreatedIngressMACsecSAs.insert(macsecAttr);
+            deferIngressMACsecSA(macsecAttr);
         }
     }
 
@@ -294,18 +316,15 @@ sai_status_t SwitchStateBase::removeMACsecPort(
         }
     }
 
-    auto saItr = m_uncreatedIngressMACsecSAs.begin();
+    cancelIngressMACsecSAs(macsecAttr.m_macsecName, "");
+
+    auto ifItr = m_macsecIfIndex.find(macsecAttr.m_macsecName);
 
-    while (saItr != m_uncreatedIngressMACsecSAs.end())
+    if (macsecAttr.m_direction == SAI_MACSEC_DIRECTION_EGRESS && ifItr != m_macsecIfIndex.end())
     {
-        if (saItr->m_macsecName == macsecAttr.m_macsecName)
-        {
-            saItr = m_uncreatedIngressMACsecSAs.erase(saItr);
-        }
-        else
-        {
-            saItr ++;
-        }
+        removeLinkIfIndex(ifItr->second);
+
+        m_macsecIfIndex.erase(ifItr);
     }
 
     auto sid = sai_serialize_object_id(macsecPortId);
@@ -330,19 +349,7 @@ sai_status_t SwitchStateBase::removeMACsecSC(
         }
     }
 
-    auto saItr = m_uncreatedIngressMACsecSAs.begin();
-
-    while (saItr != m_uncreatedIngressMACsecSAs.end())
-    {
-        if (saItr->m_macsecName == macsecAttr.m_macsecName && saItr->m_sci == macsecAttr.m_sci)
-        {
-            saItr = m_uncreatedIngressMACsecSAs.erase(saItr);
-        }
-        else
-        {
-            saItr ++;
-        }
-    }
+    cancelIngressMACsecSAs(macsecAttr.m_macsecName, macsecAttr.m_sci);
 
     auto sid = sai_serialize_object_id(macsecScId);
     return remove_internal(SAI_OBJECT_TYPE_MACSEC_SC, sid);
@@ -365,6 +372,13 @@ sai_status_t SwitchStateBase::removeMACsecSA(
                     static_cast<std::uint32_t>(macsecAttr.m_an),
                     macsecAttr.m_macsecName.c_str());
         }
+
+        auto bucket = m_uncreatedIngressMACsecSAs.find(macsecAttr.m_macsecName);
+
+        if (bucket != m_uncreatedIngressMACsecSAs.end())
+        {
+            bucket->second.erase(macsecAttr);
+        }
     }
 
     auto sid = sai_serialize_object_id(macsecSaId);
@@ -918,6 +932,10 @@ sai_status_t SwitchStateBase::getMACsecSAPacketNumber(
 
     if (loadMACsecAttr(SAI_OBJECT_TYPE_MACSEC_SA, macsecSaId, macsecAttr) == SAI_STATUS_SUCCESS)
     {
+        // counter poll of a pending SA retries it once its backoff expired
+
+        retryCreateIngressMaCsecSAs(macsecAttr.m_macsecName, false);
+
         if (m_macsecManager.get_macsec_sa_pn(macsecAttr, attr.value.u64))
         {
             return SAI_STATUS_SUCCESS;
@@ -933,27 +951,208 @@ sai_status_t SwitchStateBase::getMACsecSAPacketNumber(
     return SAI_STATUS_FAILURE;
 }
 
-void SwitchStateBase::retryCreateIngressMaCsecSAs()
+sai_status_t SwitchStateBase::setMACsecStats(
+        _In_ sai_object_type_t object_type,
+        _In_ sai_object_id_t object_id)
 {
     SWSS_LOG_ENTER();
 
-    auto itr = m_uncreatedIngressMACsecSAs.begin();
+    MACsecAttr macsecAttr;
+
+    CHECK_STATUS(loadMACsecAttr(object_type, object_id, macsecAttr));
 
-    while (itr != m_uncreatedIngressMACsecSAs.end())
+    MACsecStatsCollector::SCStats sc;
+
+    if (!m_macsecManager.get_macsec_sc_stats(macsecAttr, sc))
+    {
+        // not created yet in kernel or dump failed, keep last values
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    bool ingress = (macsecAttr.m_direction == SAI_MACSEC_DIRECTION_INGRESS);
+
+    std::map<sai_stat_id_t, uint64_t> stats;
+
+    if (object_type == SAI_OBJECT_TYPE_MACSEC_SC)
+    {
+        stats[SAI_MACSEC_SC_STAT_SA_NOT_IN_USE] = ingress ?
+            sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_PKTS_NOT_USING_SA] + sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_PKTS_UNUSED_SA] : 0;
+
+        debugSetStats(object_id, stats);
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    auto sa = sc.m_sas.find(macsecAttr.m_an);
+
+    if (sa == sc.m_sas.end())
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    auto& sastats = sa->second.m_stats;
+
+    // Linux keeps octets and late/delayed/unchecked per SC, report them on its SAs
+
+    if (ingress)
+    {
+        stats[SAI_MACSEC_SA_STAT_OCTETS_ENCRYPTED] = sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_OCTETS_DECRYPTED];
+        stats[SAI_MACSEC_SA_STAT_OCTETS_PROTECTED] = sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_OCTETS_VALIDATED];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_UNCHECKED] = sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_PKTS_UNCHECKED];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_DELAYED] = sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_PKTS_DELAYED];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_LATE] = sc.m_stats[MACSEC_RXSC_STATS_ATTR_IN_PKTS_LATE];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_INVALID] = sastats[MACSEC_SA_STATS_ATTR_IN_PKTS_INVALID];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_NOT_VALID] = sastats[MACSEC_SA_STATS_ATTR_IN_PKTS_NOT_VALID];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_NOT_USING_SA] = sastats[MACSEC_SA_STATS_ATTR_IN_PKTS_NOT_USING_SA];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_UNUSED_SA] = sastats[MACSEC_SA_STATS_ATTR_IN_PKTS_UNUSED_SA];
+        stats[SAI_MACSEC_SA_STAT_IN_PKTS_OK] = sastats[MACSEC_SA_STATS_ATTR_IN_PKTS_OK];
+    }
+    else
     {
-        if (m_macsecManager.create_macsec_sa(*itr))
+        stats[SAI_MACSEC_SA_STAT_OCTETS_ENCRYPTED] = sc.m_stats[MACSEC_TXSC_STATS_ATTR_OUT_OCTETS_ENCRYPTED];
+        stats[SAI_MACSEC_SA_STAT_OCTETS_PROTECTED] = sc.m_stats[MACSEC_TXSC_STATS_ATTR_OUT_OCTETS_PROTECTED];
+        stats[SAI_MACSEC_SA_STAT_OUT_PKTS_ENCRYPTED] = sastats[MACSEC_SA_STATS_ATTR_OUT_PKTS_ENCRYPTED];
+        stats[SAI_MACSEC_SA_STAT_OUT_PKTS_PROTECTED] = sastats[MACSEC_SA_STATS_ATTR_OUT_PKTS_PROTECTED];
+    }
+
+    debugSetStats(object_id, stats);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void SwitchStateBase::deferIngressMACsecSA(
+        _In_ const MACsecAttr &macsecAttr)
+{
+    SWSS_LOG_ENTER();
+
+    auto& bucket = m_uncreatedIngressMACsecSAs[macsecAttr.m_macsecName];
+
+    if (bucket.find(macsecAttr) != bucket.end())
+    {
+        return;
+    }
+
+    SWSS_LOG_INFO(
+            "MACsec SA %s:%u waits for the device %s",
+            macsecAttr.m_sci.c_str(),
+            static_cast<std::uint32_t>(macsecAttr.m_an),
+            macsecAttr.m_macsecName.c_str());
+
+    bucket[macsecAttr] = { 0, std::chrono::steady_clock::now() };
+}
+
+void SwitchStateBase::cancelIngressMACsecSAs(
+        _In_ const std::string &macsecName,
+        _In_ const std::string &sci)
+{
+    SWSS_LOG_ENTER();
+
+    auto bucket = m_uncreatedIngressMACsecSAs.find(macsecName);
+
+    if (bucket == m_uncreatedIngressMACsecSAs.end())
+    {
+        return;
+    }
+
+    if (sci.empty())
+    {
+        m_uncreatedIngressMACsecSAs.erase(bucket);
+        return;
+    }
+
+    auto itr = bucket->second.begin();
+
+    while (itr != bucket->second.end())
+    {
+        if (itr->first.m_sci == sci)
+        {
+            itr = bucket->second.erase(itr);
+        }
+        else
+        {
+            itr ++;
+        }
+    }
+
+    if (bucket->second.empty())
+    {
+        m_uncreatedIngressMACsecSAs.erase(bucket);
+    }
+}
+
+void SwitchStateBase::retryCreateIngressMaCsecSAs(
+        _In_ const std::string &macsecName,
+        _In_ bool ignoreBackoff)
+{
+    SWSS_LOG_ENTER();
+
+    auto bucket = m_uncreatedIngressMACsecSAs.find(macsecName);
+
+    if (bucket == m_uncreatedIngressMACsecSAs.end())
+    {
+        return;
+    }
+
+    if (if_nametoindex(macsecName.c_str()) == 0)
+    {
+        // device still missing, don't spend retry budget
+
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    auto itr = bucket->second.begin();
+
+    while (itr != bucket->second.end())
+    {
+        auto& retry = itr->second;
+
+        if (!ignoreBackoff && now < retry.m_retryTime)
+        {
+            itr ++;
+            continue;
+        }
+
+        if (m_macsecManager.create_macsec_sa(itr->first))
         {
             SWSS_LOG_NOTICE(
                 "Enable MACsec SA %s:%u at the device %s",
-                itr->m_sci.c_str(),
-                static_cast<std::uint32_t>(itr->m_an),
-                itr->m_macsecName.c_str());
+                itr->first.m_sci.c_str(),
+                static_cast<std::uint32_t>(itr->first.m_an),
+                itr->first.m_macsecName.c_str());
 
-            itr = m_uncreatedIngressMACsecSAs.erase(itr);
+            itr = bucket->second.erase(itr);
+            continue;
         }
-        else
+
+        if (++retry.m_attempts == SAI_VPP_MACSEC_SA_RETRY_BUDGET)
         {
-            itr ++;
+            SWSS_LOG_ERROR(
+                "Failed to create MACsec SA %s:%u at the device %s after %u attempts, keeping it pending",
+                itr->first.m_sci.c_str(),
+                static_cast<std::uint32_t>(itr->first.m_an),
+                itr->first.m_macsecName.c_str(),
+                retry.m_attempts);
         }
+
+        uint64_t delay = SAI_VPP_MACSEC_SA_RETRY_MAX_MS;
+
+        if (retry.m_attempts < SAI_VPP_MACSEC_SA_RETRY_BUDGET)
+        {
+            delay = std::min<uint64_t>(
+                    (uint64_t)SAI_VPP_MACSEC_SA_RETRY_BASE_MS << retry.m_attempts,
+                    SAI_VPP_MACSEC_SA_RETRY_MAX_MS);
+        }
+
+        retry.m_retryTime = now + std::chrono::milliseconds(delay);
+
+        itr ++;
+    }
+
+    if (bucket->second.empty())
+    {
+        m_uncreatedIngressMACsecSAs.erase(bucket);
     }
 }
@@ -179,6 +179,21 @@ sai_status_t SwitchStateBase::addIpNbr(
 {
     SWSS_LOG_ENTER();
 
+    sai_neighbor_entry_t nbr_entry;
+
+    sai_deserialize_neighbor_entry(serializedObjectId, nbr_entry);
+
+    auto &objectHash = m_objectHash.at(SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
+
+    bool exists = (objectHash.find(serializedObjectId) != objectHash.end());
+
+    if (!exists)
+    {
+        // reject before anything is programmed in VPP
+
+        CHECK_STATUS(check_neighbor_admission(nbr_entry));
+    }
+
     if (is_ip_nbr_active() == true) {
 	SWSS_LOG_NOTICE("Add neighbor in VPP %s", serializedObjectId.c_str());
 	addRemoveIpNbr(serializedObjectId, attr_count, attr_list, true);
@@ -186,6 +201,8 @@ sai_status_t SwitchStateBase::addIpNbr(
 
     CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, serializedObjectId, switch_id, attr_count, attr_list));
 
+    update_neighbor_usage(nbr_entry, 1);
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -201,5 +218,11 @@ sai_status_t SwitchStateBase::removeIpNbr(
 
     CHECK_STATUS(remove_internal(SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, serializedObjectId));
 
+    sai_neighbor_entry_t nbr_entry;
+
+    sai_deserialize_neighbor_entry(serializedObjectId, nbr_entry);
+
+    update_neighbor_usage(nbr_entry, -1);
+
     return SAI_STATUS_SUCCESS;
 }
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SwitchStateBase.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+using namespace saivpp;
+
+namespace
+{
+    typedef enum _PortStatSource
+    {
+        PORT_STAT_VPP_PACKETS,
+
+        PORT_STAT_VPP_BYTES,
+
+        PORT_STAT_XSTAT,
+
+    } PortStatSource;
+
+    typedef struct _PortStatMap
+    {
+        sai_port_stat_t m_stat;
+
+        PortStatSource m_source;
+
+        /*
+         * VPP counters are summed, xstats are aliases of the same counter
+         * in different drivers and the first one present is used.
+         */
+        std::vector<const char*> m_names;
+
+        // VPP counters subtracted from the sum
+        std::vector<const char*> m_excluded;
+
+    } PortStatMap;
+
+    const std::vector<PortStatMap> portStatMap = {
+        { SAI_PORT_STAT_IF_IN_OCTETS,           PORT_STAT_VPP_BYTES,   { "rx" } },
+        // VPP rx/tx count all packets, unicast is what is left of them
+        { SAI_PORT_STAT_IF_IN_UCAST_PKTS,       PORT_STAT_VPP_PACKETS, { "rx" }, { "rx-multicast", "rx-broadcast" } },
+        { SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS,   PORT_STAT_VPP_PACKETS, { "rx-multicast", "rx-broadcast" } },
+        { SAI_PORT_STAT_IF_IN_BROADCAST_PKTS,   PORT_STAT_VPP_PACKETS, { "rx-broadcast" } },
+        { SAI_PORT_STAT_IF_IN_MULTICAST_PKTS,   PORT_STAT_VPP_PACKETS, { "rx-multicast" } },
+        { SAI_PORT_STAT_IF_IN_DISCARDS,         PORT_STAT_VPP_PACKETS, { "drops" } },
+        { SAI_PORT_STAT_IF_IN_ERRORS,           PORT_STAT_VPP_PACKETS, { "rx-error" } },
+        // dropped by the NIC, ring full or no buffers, before VPP saw them
+        { SAI_PORT_STAT_IN_DROPPED_PKTS,        PORT_STAT_VPP_PACKETS, { "rx-no-buf", "rx-miss" } },
+        { SAI_PORT_STAT_IF_OUT_OCTETS,          PORT_STAT_VPP_BYTES,   { "tx" } },
+        { SAI_PORT_STAT_IF_OUT_UCAST_PKTS,      PORT_STAT_VPP_PACKETS, { "tx" }, { "tx-multicast", "tx-broadcast" } },
+        { SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS,  PORT_STAT_VPP_PACKETS, { "tx-multicast", "tx-broadcast" } },
+        { SAI_PORT_STAT_IF_OUT_BROADCAST_PKTS,  PORT_STAT_VPP_PACKETS, { "tx-broadcast" } },
+        { SAI_PORT_STAT_IF_OUT_MULTICAST_PKTS,  PORT_STAT_VPP_PACKETS, { "tx-multicast" } },
+        { SAI_PORT_STAT_IF_OUT_ERRORS,          PORT_STAT_VPP_PACKETS, { "tx-error" } },
+        { SAI_PORT_STAT_IP_IN_RECEIVES,         PORT_STAT_VPP_PACKETS, { "ip4" } },
+        { SAI_PORT_STAT_IPV6_IN_RECEIVES,       PORT_STAT_VPP_PACKETS, { "ip6" } },
+
+        { SAI_PORT_STAT_IF_IN_FCS_ERRORS,               PORT_STAT_XSTAT, { "rx_crc_errors" } },
+        { SAI_PORT_STAT_ETHER_STATS_CRC_ALIGN_ERRORS,   PORT_STAT_XSTAT, { "rx_crc_errors" } },
+        { SAI_PORT_STAT_IF_IN_UNKNOWN_PROTOS,           PORT_STAT_XSTAT, { "rx_unknown_protocol_packets" } },
+        { SAI_PORT_STAT_ETHER_STATS_UNDERSIZE_PKTS,     PORT_STAT_XSTAT, { "rx_undersize_errors", "rx_undersized_errors" } },
+        { SAI_PORT_STAT_ETHER_STATS_OVERSIZE_PKTS,      PORT_STAT_XSTAT, { "rx_oversize_errors" } },
+        { SAI_PORT_STAT_ETHER_RX_OVERSIZE_PKTS,         PORT_STAT_XSTAT, { "rx_oversize_errors" } },
+        { SAI_PORT_STAT_ETHER_STATS_FRAGMENTS,          PORT_STAT_XSTAT, { "rx_fragment_errors", "rx_fragmented_errors" } },
+        { SAI_PORT_STAT_ETHER_STATS_JABBERS,            PORT_STAT_XSTAT, { "rx_jabber_errors" } },
+        { SAI_PORT_STAT_PAUSE_RX_PKTS,                  PORT_STAT_XSTAT, { "rx_xoff_packets", "rx_flow_control_xoff_packets", "rx_pause_ctrl_phy" } },
+        { SAI_PORT_STAT_PAUSE_TX_PKTS,                  PORT_STAT_XSTAT, { "tx_xoff_packets", "tx_flow_control_xoff_packets", "tx_pause_ctrl_phy" } },
+
+        { SAI_PORT_STAT_ETHER_IN_PKTS_64_OCTETS,            PORT_STAT_XSTAT, { "rx_size_64_packets" } },
+        { SAI_PORT_STAT_ETHER_IN_PKTS_65_TO_127_OCTETS,     PORT_STAT_XSTAT, { "rx_size_65_to_127_packets" } },
+        { SAI_PORT_STAT_ETHER_IN_PKTS_128_TO_255_OCTETS,    PORT_STAT_XSTAT, { "rx_size_128_to_255_packets" } },
+        { SAI_PORT_STAT_ETHER_IN_PKTS_256_TO_511_OCTETS,    PORT_STAT_XSTAT, { "rx_size_256_to_511_packets" } },
+        { SAI_PORT_STAT_ETHER_IN_PKTS_512_TO_1023_OCTETS,   PORT_STAT_XSTAT, { "rx_size_512_to_1023_packets" } },
+        { SAI_PORT_STAT_ETHER_IN_PKTS_1024_TO_1518_OCTETS,  PORT_STAT_XSTAT, { "rx_size_1024_to_1518_packets", "rx_size_1024_to_1522_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_64_OCTETS,           PORT_STAT_XSTAT, { "tx_size_64_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_65_TO_127_OCTETS,    PORT_STAT_XSTAT, { "tx_size_65_to_127_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_128_TO_255_OCTETS,   PORT_STAT_XSTAT, { "tx_size_128_to_255_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_256_TO_511_OCTETS,   PORT_STAT_XSTAT, { "tx_size_256_to_511_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_512_TO_1023_OCTETS,  PORT_STAT_XSTAT, { "tx_size_512_to_1023_packets" } },
+        { SAI_PORT_STAT_ETHER_OUT_PKTS_1024_TO_1518_OCTETS, PORT_STAT_XSTAT, { "tx_size_1024_to_1518_packets", "tx_size_1024_to_1522_packets" } },
+    };
+
+    // RMON size buckets count both directions
+    const std::vector<std::vector<sai_port_stat_t>> portStatSums = {
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_64_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_64_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_64_OCTETS },
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_65_TO_127_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_65_TO_127_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_65_TO_127_OCTETS },
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_128_TO_255_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_128_TO_255_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_128_TO_255_OCTETS },
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_256_TO_511_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_256_TO_511_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_256_TO_511_OCTETS },
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_512_TO_1023_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_512_TO_1023_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_512_TO_1023_OCTETS },
+        { SAI_PORT_STAT_ETHER_STATS_PKTS_1024_TO_1518_OCTETS,
+          SAI_PORT_STAT_ETHER_IN_PKTS_1024_TO_1518_OCTETS, SAI_PORT_STAT_ETHER_OUT_PKTS_1024_TO_1518_OCTETS },
+    };
+}
+
+sai_status_t SwitchStateBase::setPortStats(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    std::string ifname;
+
+    if (!vpp_get_hwif_name(port_id, 0, ifname))
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    auto snapshot = get_stats_snapshot(false);
+
+    auto counters = snapshot ? snapshot->getInterface(ifname) : nullptr;
+
+    if (counters == nullptr)
+    {
+        // keep last values
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    auto& pc = *counters;
+
+    std::map<sai_stat_id_t, uint64_t> stats;
+
+    for (auto& m: portStatMap)
+    {
+        uint64_t value = 0;
+
+        if (m.m_source == PORT_STAT_XSTAT)
+        {
+            for (auto name: m.m_names)
+            {
+                auto xs = pc.m_xstats.find(name);
+
+                if (xs != pc.m_xstats.end())
+                {
+                    value = xs->second;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            for (auto name: m.m_names)
+            {
+                auto c = pc.m_vpp.find(name);
+
+                if (c != pc.m_vpp.end())
+                {
+                    value += (m.m_source == PORT_STAT_VPP_BYTES) ? c->second.bytes : c->second.packets;
+                }
+            }
+
+            for (auto name: m.m_excluded)
+            {
+                auto c = pc.m_vpp.find(name);
+
+                if (c != pc.m_vpp.end())
+                {
+                    uint64_t excluded = (m.m_source == PORT_STAT_VPP_BYTES) ? c->second.bytes : c->second.packets;
+
+                    // counters are not read atomically, don't wrap around
+
+                    value -= std::min(value, excluded);
+                }
+            }
+        }
+
+        stats[m.m_stat] = value;
+    }
+
+    for (auto& s: portStatSums)
+    {
+        stats[s.at(0)] = stats[s.at(1)] + stats[s.at(2)];
+    }
+
+    debugSetStats(port_id, stats);
+
+    // per queue counters, queue list is in queue index order
+
+    std::vector<sai_object_id_t> queues;
+
+    if (!get_port_queues(port_id, queues))
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    std::map<uint32_t, std::map<sai_stat_id_t, uint64_t>> queueStats;
+
+    for (auto& xs: pc.m_xstats)
+    {
+        uint32_t q;
+        char what[16];
+
+        if (sscanf(xs.first.c_str(), "tx_q%u_%15s", &q, what) != 2 || q >= queues.size())
+        {
+            continue;
+        }
+
+        if (strcmp(what, "packets") == 0)
+        {
+            queueStats[q][SAI_QUEUE_STAT_PACKETS] = xs.second;
+        }
+        else if (strcmp(what, "bytes") == 0)
+        {
+            queueStats[q][SAI_QUEUE_STAT_BYTES] = xs.second;
+        }
+    }
+
+    for (auto& qs: queueStats)
+    {
+        debugSetStats(queues.at(qs.first), qs.second);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::queryStatsCapability(
+        _In_ sai_object_id_t switchId,
+        _In_ sai_object_type_t objectType,
+        _Inout_ sai_stat_capability_list_t *stats_capability)
+{
+    SWSS_LOG_ENTER();
+
+    if (objectType != SAI_OBJECT_TYPE_PORT &&
+            objectType != SAI_OBJECT_TYPE_QUEUE &&
+            objectType != SAI_OBJECT_TYPE_SWITCH)
+    {
+        return SwitchState::queryStatsCapability(switchId, objectType, stats_capability);
+    }
+
+    // xstats depend on the NIC driver, only advertise the ones VPP exports
+
+    get_stats_snapshot(false);
+
+    const uint32_t modes = SAI_STATS_MODE_READ | SAI_STATS_MODE_READ_AND_CLEAR;
+
+    std::map<sai_stat_id_t, uint32_t> supported;
+
+    if (objectType == SAI_OBJECT_TYPE_SWITCH)
+    {
+        // vendor stats come on top of the standard switch stats
+
+        auto info = sai_metadata_get_object_type_info(objectType);
+
+        for (size_t i = 0; i < info->statenum->valuescount; i++)
+        {
+            supported[info->statenum->values[i]] = SAI_STATS_MODE_READ_AND_CLEAR;
+        }
+
+        switchStatsCapability(supported);
+    }
+    else if (objectType == SAI_OBJECT_TYPE_PORT)
+    {
+        for (auto& m: portStatMap)
+        {
+            if (m.m_source != PORT_STAT_XSTAT)
+            {
+                supported[m.m_stat] = modes;
+                continue;
+            }
+
+            for (auto name: m.m_names)
+            {
+                if (m_portXstatNames.find(name) != m_portXstatNames.end())
+                {
+                    supported[m.m_stat] = modes;
+                    break;
+                }
+            }
+        }
+
+        for (auto& s: portStatSums)
+        {
+            if (supported.find(s.at(1)) != supported.end() && supported.find(s.at(2)) != supported.end())
+            {
+                supported[s.at(0)] = modes;
+            }
+        }
+    }
+    else
+    {
+        if (m_portXstatNames.find("tx_q0_packets") != m_portXstatNames.end())
+        {
+            supported[SAI_QUEUE_STAT_PACKETS] = modes;
+        }
+
+        if (m_portXstatNames.find("tx_q0_bytes") != m_portXstatNames.end())
+        {
+            supported[SAI_QUEUE_STAT_BYTES] = modes;
+        }
+
+        if (supported.empty())
+        {
+            // driver without per queue xstats, or none seen yet
+
+            return SwitchState::queryStatsCapability(switchId, objectType, stats_capability);
+        }
+    }
+
+    if (stats_capability->count < supported.size() || stats_capability->list == nullptr)
+    {
+        stats_capability->count = (uint32_t)supported.size();
+
+        return SAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    uint32_t i = 0;
+
+    for (auto& kvp: supported)
+    {
+        stats_capability->list[i].stat_enum = kvp.first;
+        stats_capability->list[i].stat_modes = kvp.second;
+        i++;
+    }
+
+    stats_capability->count = i;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void SwitchStateBase::collectPortCounters(
+        _Inout_ std::vector<CounterStream::ObjectCounters>& counters)
+{
+    SWSS_LOG_ENTER();
+
+    // streaming interval may be shorter than the snapshot lifetime
+
+    m_statsSnapshotTime = {};
+
+    for (const auto& it: m_objectHash.at(SAI_OBJECT_TYPE_PORT))
+    {
+        sai_object_id_t port_id;
+        sai_deserialize_object_id(it.first, port_id);
+
+        if (port_id == m_cpu_port_id)
+            continue;
+
+        if (setPortStats(port_id) != SAI_STATUS_SUCCESS)
+            continue;
+
+        auto cit = m_countersMap.find(it.first);
+
+        if (cit == m_countersMap.end())
+            continue;
+
+        CounterStream::ObjectCounters oc;
+
+        oc.m_oid = port_id;
+
+        for (auto& kvp: cit->second)
+        {
+            oc.m_counters.emplace_back(
+                    sai_serialize_port_stat((sai_port_stat_t)kvp.first),
+                    m_statsBaseline.read(port_id, kvp.first, kvp.second));
+        }
+
+        counters.push_back(std::move(oc));
+    }
+}
@@ -26,6 +26,7 @@
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <net/if.h>
+#include <ctype.h>
 
 #include "SwitchStateBaseUtils.h"
 
@@ -38,12 +39,10 @@ using namespace saivpp;
 IpVrfInfo::IpVrfInfo(
     _In_ sai_object_id_t obj_id,
     _In_ uint32_t vrf_id,
-    _In_ std::string &vrf_name,
-    _In_ bool is_ipv6):
+    _In_ std::string &vrf_name):
     m_obj_id(obj_id),
     m_vrf_id(vrf_id),
-    m_vrf_name(vrf_name),
-    m_is_ipv6(is_ipv6)
+    m_vrf_name(vrf_name)
 {
     SWSS_LOG_ENTER();
 }
@@ -52,6 +51,14 @@ IpVrfInfo::~IpVrfInfo()
 {
 }
 
+/*
+ * A router interface uses the tables of its VRF under its VPP interface name
+ */
+static std::string rif_vrf_user (const std::string& hwif_name, uint16_t vlan_id)
+{
+    return vlan_id ? hwif_name + "." + std::to_string(vlan_id) : hwif_name;
+}
+
 bool vpp_get_intf_ip_address (
     const char *linux_ifname,
     sai_ip_prefix_t& ip_prefix,
@@ -150,6 +157,14 @@ void SwitchStateBase::vpp_intf_remove_prefix_entry (const std::string& intf_name
     m_intf_prefix_map.erase(it);
 }
 
+int SwitchStateBase::vpp_client_activate()
+{
+    SWSS_LOG_ENTER();
+
+    return vpp_client_select(m_switchConfig->m_vppApiSocket.c_str(),
+                             m_switchConfig->m_vppStatsSocket.c_str());
+}
+
 bool SwitchStateBase::vpp_get_hwif_name (
       _In_ sai_object_id_t object_id,
       _In_ uint32_t vlan_id,
@@ -438,6 +453,16 @@ sai_status_t SwitchStateBase::vpp_add_del_intf_ip_addr (
 	hw_ifname = hwifname;
     }
 
+    if (is_add && is_v6) {
+	attr.id = SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID;
+
+	if (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, rif_id, 1, &attr) == SAI_STATUS_SUCCESS &&
+	    vpp_router_interface_bind_ipv6(attr.value.oid, hwifname, vlan_id) != 0) {
+	    vpp_intf_remove_prefix_entry(ip_prefix_key);
+	    return SAI_STATUS_FAILURE;
+	}
+    }
+
     int ret = interface_ip_address_add_del(hw_ifname, &vpp_ip_prefix, is_add);
 
     if (ret == 0)
@@ -502,7 +527,7 @@ sai_status_t SwitchStateBase::vpp_add_del_intf_ip_addr_norif (
 	if (found == false)
 	{
 	    SWSS_LOG_ERROR("host interface for prefix not found");
-	    return SAI_STATUS_FAILURE;
+	    return SAI_STATUS_ADDR_NOT_FOUND;
 	}
     } else {
 	std::string intf_data;
@@ -604,6 +629,12 @@ sai_status_t SwitchStateBase::vpp_add_del_intf_ip_addr_norif (
 	hw_ifname = hwifname;
     }
 
+    if (is_add && is_v6 &&
+	vpp_router_interface_bind_ipv6(route_entry.vr_id, hwifname, (uint16_t)vlan_id) != 0) {
+	vpp_intf_remove_prefix_entry(ip_prefix_key);
+	return SAI_STATUS_FAILURE;
+    }
+
     int ret = interface_ip_address_add_del(hw_ifname, &vpp_ip_prefix, is_add);
 
     if (ret == 0)
@@ -704,6 +735,10 @@ sai_status_t SwitchStateBase::vpp_get_router_intf_name (
     return SAI_STATUS_SUCCESS;
 }
 
+/*
+ * Only records the VRF and its table id, the ipv4 and ipv6 tables are added
+ * to VPP by vpp_ip_vrf_ref on the first user of each family.
+ */
 int SwitchStateBase::vpp_add_ip_vrf (_In_ sai_object_id_t objectId, uint32_t vrf_id)
 {
     auto it = vrf_objMap.find(objectId);
@@ -711,19 +746,22 @@ int SwitchStateBase::vpp_add_ip_vrf (_In_ sai_object_id_t objectId, uint32_t vrf
     if (it != vrf_objMap.end()) {
 	auto sw = it->second;
 	if (sw != nullptr) {
-      	   SWSS_LOG_NOTICE("VRF(%s) with id %u already exists", sai_serialize_object_id(objectId).c_str(), sw->m_vrf_id);
+	    if (sw->m_vrf_id != vrf_id) {
+		SWSS_LOG_ERROR("VRF(%s) has table %u, ignoring table %u", sai_serialize_object_id(objectId).c_str(),
+			       sw->m_vrf_id, vrf_id);
+	    }
 	} else {
 	    SWSS_LOG_ERROR("VRF(%s) object with null data", sai_serialize_object_id(objectId).c_str());
 	}
 	return 0;
     }
 
-    std::string vrf_name = "vrf_" + vrf_id;
+    std::string vrf_name = "vrf_" + std::to_string(vrf_id);
 
-    if (ip_vrf_add(vrf_id, vrf_name.c_str(), false) == 0) {
-	SWSS_LOG_NOTICE("VRF(%s) with id %u created in VPP", sai_serialize_object_id(objectId).c_str(), vrf_id);
-	vrf_objMap[objectId] = std::make_shared<IpVrfInfo>(objectId, vrf_id, vrf_name, false);
-    }
+    SWSS_LOG_NOTICE("VRF(%s) uses VPP table %u", sai_serialize_object_id(objectId).c_str(), vrf_id);
+    vrf_objMap[objectId] = std::make_shared<IpVrfInfo>(objectId, vrf_id, vrf_name);
+
+    drain_pending_routes(PendingRoutes::ROUTE_DEP_VRF, objectId);
 
     return 0;
 }
@@ -735,14 +773,123 @@ int SwitchStateBase::vpp_del_ip_vrf (_In_ sai_object_id_t objectId)
     if (it != vrf_objMap.end()) {
 	auto sw = it->second;
 	if (sw != nullptr) {
+	   /* The tables are deleted in VPP with their last user */
+	   for (int af = 0; af < 2; af++) {
+	       if (!sw->m_users[af].empty()) {
+		   SWSS_LOG_ERROR("VRF(%s) %s table still has %zu users", sai_serialize_object_id(objectId).c_str(),
+				  af ? "ipv6" : "ipv4", sw->m_users[af].size());
+		   return -1;
+	       }
+	   }
       	   SWSS_LOG_NOTICE("Deleting VRF(%s) with id %u", sai_serialize_object_id(objectId).c_str(), sw->m_vrf_id);
-	   ip_vrf_del(sw->m_vrf_id, sw->m_vrf_name.c_str(), sw->m_is_ipv6);
-	   vrf_objMap.erase(it);
 	}
+	vrf_objMap.erase(it);
     }
     return 0;
 }
 
+int SwitchStateBase::vpp_ip_vrf_ref (
+    _In_ sai_object_id_t objectId,
+    _In_ bool is_ipv6,
+    _In_ const std::string& user)
+{
+    SWSS_LOG_ENTER();
+
+    auto vrf = vpp_get_ip_vrf(objectId);
+
+    if (vrf == nullptr) {
+	return 0;
+    }
+
+    auto& users = vrf->m_users[is_ipv6 ? 1 : 0];
+
+    if (users.find(user) != users.end()) {
+	return 0;
+    }
+
+    if (users.empty()) {
+	init_vpp_client();
+
+	int ret = ip_vrf_add(vrf->m_vrf_id, vrf->m_vrf_name.c_str(), is_ipv6);
+
+	if (ret != 0) {
+	    SWSS_LOG_ERROR("Failed to create %s table %u in VPP for VRF(%s) (%d)", is_ipv6 ? "ipv6" : "ipv4",
+			   vrf->m_vrf_id, sai_serialize_object_id(objectId).c_str(), ret);
+	    return ret;
+	}
+	SWSS_LOG_NOTICE("VRF(%s) %s table %u created in VPP", sai_serialize_object_id(objectId).c_str(),
+			is_ipv6 ? "ipv6" : "ipv4", vrf->m_vrf_id);
+    }
+
+    users.insert(user);
+
+    return 0;
+}
+
+int SwitchStateBase::vpp_ip_vrf_unref (
+    _In_ sai_object_id_t objectId,
+    _In_ bool is_ipv6,
+    _In_ const std::string& user)
+{
+    SWSS_LOG_ENTER();
+
+    auto vrf = vpp_get_ip_vrf(objectId);
+
+    if (vrf == nullptr) {
+	return 0;
+    }
+
+    auto& users = vrf->m_users[is_ipv6 ? 1 : 0];
+
+    if (users.erase(user) == 0 || !users.empty()) {
+	return 0;
+    }
+
+    init_vpp_client();
+
+    int ret = ip_vrf_del(vrf->m_vrf_id, vrf->m_vrf_name.c_str(), is_ipv6);
+
+    SWSS_LOG_NOTICE("VRF(%s) %s table %u deleted in VPP (%d)", sai_serialize_object_id(objectId).c_str(),
+		    is_ipv6 ? "ipv6" : "ipv4", vrf->m_vrf_id, ret);
+
+    return ret;
+}
+
+int SwitchStateBase::vpp_router_interface_bind_ipv6 (
+    _In_ sai_object_id_t vr_id,
+    _In_ const char *hwif_name,
+    _In_ uint16_t vlan_id)
+{
+    SWSS_LOG_ENTER();
+
+    auto vrf = vpp_get_ip_vrf(vr_id);
+
+    if (vrf == nullptr) {
+	return 0;
+    }
+
+    std::string user = rif_vrf_user(hwif_name, vlan_id);
+
+    if (vrf->m_users[1].find(user) != vrf->m_users[1].end()) {
+	return 0;
+    }
+
+    int ret = vpp_ip_vrf_ref(vr_id, true, user);
+
+    if (ret != 0) {
+	return ret;
+    }
+
+    ret = set_interface_vrf(hwif_name, vlan_id, vrf->m_vrf_id, true);
+
+    if (ret != 0) {
+	SWSS_LOG_ERROR("Failed to bind %s in ipv6 table %u (%d)", user.c_str(), vrf->m_vrf_id, ret);
+	vpp_ip_vrf_unref(vr_id, true, user);
+    }
+
+    return ret;
+}
+
 std::shared_ptr<IpVrfInfo> SwitchStateBase::vpp_get_ip_vrf (_In_ sai_object_id_t objectId)
 {
     auto it = vrf_objMap.find(objectId);
@@ -760,12 +907,18 @@ std::shared_ptr<IpVrfInfo> SwitchStateBase::vpp_get_ip_vrf (_In_ sai_object_id_t
 /*
  * VPP uses linux's vrf table id when linux_nl is active
  */
-int SwitchStateBase::vpp_get_vrf_id (const char *linux_ifname, uint32_t *vrf_id)
+/*
+ * Linux VRF table id of every interface enslaved to a VRF, read with one ip
+ * command for all interfaces.
+ */
+int SwitchStateBase::vpp_get_vrf_ids (_Out_ std::map<std::string, uint32_t>& vrf_ids)
 {
+    SWSS_LOG_ENTER();
+
     std::stringstream cmd;
     std::string res;
 
-    cmd << IP_CMD << " link show dev " << linux_ifname;
+    cmd << IP_CMD << " -d -o link show";
     int ret = swss::exec(cmd.str(), res);
     if (ret)
     {
@@ -773,29 +926,86 @@ int SwitchStateBase::vpp_get_vrf_id (const char *linux_ifname, uint32_t *vrf_id)
         return -1;
     }
 
-    std::stringstream table_cmd;
+    const std::string vrf_slave = "vrf_slave table ";
+
+    std::istringstream lines(res);
+    std::string line;
+
+    while (std::getline(lines, line))
+    {
+	/* <index>: <ifname>[@<parent>]: <flags> ... vrf_slave table <id> ... */
+
+	auto name_begin = line.find(": ");
+	auto table = line.find(vrf_slave);
+
+	if (name_begin == std::string::npos || table == std::string::npos) {
+	    continue;
+	}
+
+	name_begin += 2;
+
+	auto name_end = line.find_first_of("@:", name_begin);
+
+	table += vrf_slave.length();
+
+	if (name_end == std::string::npos || table >= line.length() || !isdigit(line[table])) {
+	    continue;
+	}
+
+	vrf_ids[line.substr(name_begin, name_end - name_begin)] = (uint32_t)std::stoul(line.substr(table));
+    }
+
+    return 0;
+}
+
+/*
+ * Global addresses of all host interfaces, read with one ip command
+ */
+int SwitchStateBase::vpp_get_host_addresses (_Out_ std::vector<std::string>& addresses)
+{
+    SWSS_LOG_ENTER();
 
-    table_cmd << IP_CMD << " -d link show dev " << linux_ifname << " | grep -o 'vrf_slave table [0-9]\\+' | cut -d' ' -f3";
-    ret = swss::exec(table_cmd.str(), res);
+    std::stringstream cmd;
+    std::string res;
+
+    cmd << IP_CMD << " -o addr show scope global";
+    int ret = swss::exec(cmd.str(), res);
     if (ret)
     {
-        SWSS_LOG_ERROR("Command '%s' failed with rc %d", table_cmd.str().c_str(), ret);
+        SWSS_LOG_ERROR("Command '%s' failed with rc %d", cmd.str().c_str(), ret);
         return -1;
     }
 
-    if (res.length() != 0)
+    std::istringstream lines(res);
+    std::string line;
+
+    while (std::getline(lines, line))
     {
-	*vrf_id = std::stoi(res);
-    } else {
-	*vrf_id = 0;
+	/* <index>: <ifname> inet[6] <address>/<len> ... */
+
+	std::istringstream tokens(line);
+	std::string token;
+
+	while (tokens >> token)
+	{
+	    if (token != "inet" && token != "inet6") {
+		continue;
+	    }
+
+	    if (tokens >> token) {
+		addresses.push_back(token.substr(0, token.find('/')));
+	    }
+	    break;
+	}
     }
 
     return 0;
 }
 
-sai_status_t SwitchStateBase::vpp_create_router_interface(
+sai_status_t SwitchStateBase::vpp_get_router_interface_config(
         _In_ uint32_t attr_count,
-        _In_ const sai_attribute_t *attr_list)
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ std::vector<RifVppConfig>& configs)
 {
     SWSS_LOG_ENTER();
 
@@ -865,27 +1075,20 @@ sai_status_t SwitchStateBase::vpp_create_router_interface(
 	return SAI_STATUS_FAILURE;
     }
 
-    const char *dev = if_name.c_str();
-    const char *linux_ifname;
-    char host_subifname[32];
+    RifVppConfig config;
+
+    config.m_hwifName = tap_to_hwif_name(if_name.c_str());
 
     if (attr_type->value.s32 == SAI_ROUTER_INTERFACE_TYPE_SUB_PORT)
     {
-	snprintf(host_subifname, sizeof(host_subifname), "%s.%u", dev, vlan_id);
-
-	init_vpp_client();
-
-	/* The host(tap) subinterface is also created as part of the vpp subinterface creation */
-	create_sub_interface(tap_to_hwif_name(dev), vlan_id, vlan_id);
-
-	/* Get new list of physical interfaces from VPP */
-	refresh_interfaces_list();
-
-	linux_ifname = host_subifname;
+	config.m_vlanId = vlan_id;
+	config.m_linuxIfname = if_name + "." + std::to_string(vlan_id);
     } else {
-	linux_ifname = dev;
+	config.m_vlanId = 0;
+	config.m_linuxIfname = if_name;
     }
-    sai_object_id_t vrf_obj_id = 0;
+
+    config.m_vrfObjId = 0;
 
     auto attr_vrf_id = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID, attr_count, attr_list);
 
@@ -893,47 +1096,184 @@ sai_status_t SwitchStateBase::vpp_create_router_interface(
     {
         SWSS_LOG_NOTICE("attr SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID was not passed");
     } else {
-	vrf_obj_id = attr_vrf_id->value.oid;
+	config.m_vrfObjId = attr_vrf_id->value.oid;
         SWSS_LOG_NOTICE("attr SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID %s is passed",
-			sai_serialize_object_id(vrf_obj_id).c_str());
+			sai_serialize_object_id(config.m_vrfObjId).c_str());
     }
 
-    uint32_t vrf_id;
-    int ret = vpp_get_vrf_id(linux_ifname, &vrf_id);
+    auto attr_type_mtu = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_MTU, attr_count, attr_list);
+
+    config.m_mtu = (attr_type_mtu != NULL) ? attr_type_mtu->value.u32 : 0;
+
+    auto attr_type_v4 = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_ADMIN_V4_STATE, attr_count, attr_list);
+    auto attr_type_v6 = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_ADMIN_V6_STATE, attr_count, attr_list);
+
+    if (attr_type_v4 != NULL || attr_type_v6 != NULL)
+    {
+	bool v4_is_up = (attr_type_v4 != NULL) && attr_type_v4->value.booldata;
+	bool v6_is_up = (attr_type_v6 != NULL) && attr_type_v6->value.booldata;
 
-    if (ret == 0 && vrf_id != 0) {
-	vpp_add_ip_vrf(vrf_obj_id, vrf_id);
-	set_interface_vrf(tap_to_hwif_name(dev), vlan_id, vrf_id, false);
+	config.m_adminUp = (v4_is_up || v6_is_up) ? 1 : 0;
+    } else {
+	config.m_adminUp = -1;
     }
-    auto attr_type_mtu = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_MTU, attr_count, attr_list);
 
-    if (attr_type_mtu != NULL)
+    configs.push_back(config);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::vpp_create_router_interfaces(
+        _In_ const std::vector<RifVppConfig>& configs,
+        _Out_ std::vector<sai_status_t>& statuses)
+{
+    SWSS_LOG_ENTER();
+
+    statuses.assign(configs.size(), SAI_STATUS_SUCCESS);
+
+    if (configs.empty())
     {
-        vpp_set_interface_mtu(obj_id, vlan_id, attr_type_mtu->value.u32, AF_INET);
-	vpp_set_interface_mtu(obj_id, vlan_id, attr_type_mtu->value.u32, AF_INET6);
+        return SAI_STATUS_SUCCESS;
     }
 
-    bool v4_is_up = false, v6_is_up = false;
+    std::vector<vpp_rif_config_t> rifs(configs.size());
 
-    auto attr_type_v4 = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_ADMIN_V4_STATE, attr_count, attr_list);
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+	memset(&rifs[i], 0, sizeof(rifs[i]));
 
-    if (attr_type_v4 != NULL)
+	rifs[i].hwif_name = configs[i].m_hwifName.c_str();
+	rifs[i].vlan_id = configs[i].m_vlanId;
+	rifs[i].admin_up = -1;
+    }
+
+    /*
+     * The VPP table of a VRF is its linux table id. It is known once the VRF
+     * has a router interface, and linux is read once for the whole batch only
+     * when one of the VRFs is new.
+     */
+    sai_attribute_t attr;
+
+    attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+
+    sai_object_id_t default_vr_id = SAI_NULL_OBJECT_ID;
+
+    if (get(SAI_OBJECT_TYPE_SWITCH, m_switch_id, 1, &attr) == SAI_STATUS_SUCCESS) {
+	default_vr_id = attr.value.oid;
+    }
+
+    auto in_vrf = [&](const RifVppConfig& config) {
+	return config.m_vrfObjId != SAI_NULL_OBJECT_ID && config.m_vrfObjId != default_vr_id;
+    };
+
+    std::map<std::string, uint32_t> linux_vrf_ids;
+
+    for (auto& config: configs)
     {
-	v4_is_up = attr_type_v4->value.booldata;
+	if (in_vrf(config) && vpp_get_ip_vrf(config.m_vrfObjId) == nullptr) {
+	    vpp_get_vrf_ids(linux_vrf_ids);
+	    break;
+	}
     }
-    auto attr_type_v6 = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_ADMIN_V6_STATE, attr_count, attr_list);
 
-    if (attr_type_v6 != NULL)
+    init_vpp_client();
+
+    /*
+     * The host(tap) subinterfaces are also created as part of the vpp
+     * subinterface creation, and their sw_if_index comes back in the reply.
+     */
+    create_sub_interfaces(rifs.data(), (uint32_t)rifs.size());
+
+    std::vector<bool> created(configs.size());
+
+    for (size_t i = 0; i < configs.size(); i++)
     {
-	v6_is_up = attr_type_v6->value.booldata;
+	auto& config = configs[i];
+	auto& rif = rifs[i];
+
+	created[i] = (rif.retval == 0);
+
+	if (!created[i])
+	{
+	    SWSS_LOG_ERROR("Failed to create VPP interface %s.%u (%d)",
+			   config.m_hwifName.c_str(), config.m_vlanId, rif.retval);
+	    continue;
+	}
+
+	uint32_t vrf_id = 0;
+
+	if (in_vrf(config)) {
+	    auto vrf = vpp_get_ip_vrf(config.m_vrfObjId);
+
+	    if (vrf != nullptr) {
+		vrf_id = vrf->m_vrf_id;
+	    } else {
+		auto it = linux_vrf_ids.find(config.m_linuxIfname);
+
+		if (it != linux_vrf_ids.end()) {
+		    vrf_id = it->second;
+		}
+	    }
+	}
+
+	if (vrf_id != 0) {
+	    vpp_add_ip_vrf(config.m_vrfObjId, vrf_id);
+
+	    /*
+	     * The interface is bound in the ipv4 table, which must exist in VPP
+	     * first. The ipv6 one is bound with its first ipv6 address.
+	     */
+	    std::string user = rif_vrf_user(config.m_hwifName, config.m_vlanId);
+
+	    if (vpp_ip_vrf_ref(config.m_vrfObjId, false, user) == 0) {
+		rif.vrf_id = vrf_id;
+	    }
+	}
+
+	rif.mtu = config.m_mtu;
+	rif.admin_up = config.m_adminUp;
     }
 
-    if (attr_type_v4 != NULL || attr_type_v6 != NULL)
+    configure_router_interfaces(rifs.data(), (uint32_t)rifs.size());
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    for (size_t i = 0; i < configs.size(); i++)
     {
-        return vpp_set_interface_state(obj_id, vlan_id, (v4_is_up || v6_is_up));
-    } else {
-	return SAI_STATUS_SUCCESS;
+	if (rifs[i].retval == 0)
+	{
+	    SWSS_LOG_NOTICE("Configured router interface %s.%u sw_if_index %u vrf %u mtu %u admin %d",
+			    configs[i].m_hwifName.c_str(), configs[i].m_vlanId, rifs[i].sw_if_index,
+			    rifs[i].vrf_id, rifs[i].mtu, rifs[i].admin_up);
+	    continue;
+	}
+
+	SWSS_LOG_ERROR("Failed to configure VPP router interface %s.%u (%d)",
+		       configs[i].m_hwifName.c_str(), configs[i].m_vlanId, rifs[i].retval);
+
+	statuses[i] = SAI_STATUS_FAILURE;
+	status = SAI_STATUS_FAILURE;
+
+	/* Undo what was done for this interface, the caller rolls back its SAI object */
+
+	if (created[i] && configs[i].m_vlanId)
+	{
+	    delete_sub_interface(configs[i].m_hwifName.c_str(), configs[i].m_vlanId);
+	}
+	else if (created[i] && rifs[i].vrf_id)
+	{
+	    set_interface_vrf(configs[i].m_hwifName.c_str(), 0, 0, false);
+	}
+
+	if (rifs[i].vrf_id)
+	{
+	    std::string user = rif_vrf_user(configs[i].m_hwifName, configs[i].m_vlanId);
+
+	    vpp_ip_vrf_unref(configs[i].m_vrfObjId, false, user);
+	}
     }
+
+    return status;
 }
 
 sai_status_t SwitchStateBase::vpp_update_router_interface(
@@ -1057,8 +1397,39 @@ sai_status_t SwitchStateBase::vpp_router_interface_remove_vrf(
     SWSS_LOG_NOTICE("Resetting to default vrf for interface %s", linux_ifname);
 
     uint32_t vrf_id = 0;
-    /* For now support is only for ipv4 tables */
     set_interface_vrf(hwif_name, 0, vrf_id, false);
+    set_interface_vrf(hwif_name, 0, vrf_id, true);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::vpp_router_interface_vrf_unref(
+        _In_ sai_object_id_t rif_id,
+        _In_ sai_object_id_t port_id,
+        _In_ uint16_t vlan_id)
+{
+    SWSS_LOG_ENTER();
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_ROUTER_INTERFACE_ATTR_VIRTUAL_ROUTER_ID;
+
+    if (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, rif_id, 1, &attr) != SAI_STATUS_SUCCESS)
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    std::string if_name;
+
+    if (!getTapNameFromPortId(port_id, if_name))
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    std::string user = rif_vrf_user(tap_to_hwif_name(if_name.c_str()), vlan_id);
+
+    vpp_ip_vrf_unref(attr.value.oid, false, user);
+    vpp_ip_vrf_unref(attr.value.oid, true, user);
 
     return SAI_STATUS_SUCCESS;
 }
@@ -1113,6 +1484,7 @@ sai_status_t SwitchStateBase::vpp_remove_router_interface(sai_object_id_t rif_id
     if (rif_type != SAI_ROUTER_INTERFACE_TYPE_SUB_PORT)
     {
         vpp_router_interface_remove_vrf(obj_id);
+        vpp_router_interface_vrf_unref(rif_id, obj_id, 0);
 
         return SAI_STATUS_SUCCESS;
     }
@@ -1140,9 +1512,10 @@ sai_status_t SwitchStateBase::vpp_remove_router_interface(sai_object_id_t rif_id
     const char *dev = if_name.c_str();
 
     init_vpp_client();
+    /* The deleted sub interface is dropped from the interface table on success */
     delete_sub_interface(tap_to_hwif_name(dev), vlan_id);
-    /* Get new list of physical interfaces from VPP */
-    refresh_interfaces_list();
+
+    vpp_router_interface_vrf_unref(rif_id, obj_id, vlan_id);
 
 /*
     char host_subifname[32], hwif_name[32];
@@ -1162,24 +1535,169 @@ sai_status_t SwitchStateBase::createRouterif(
 {
     SWSS_LOG_ENTER();
 
-    if (m_switchConfig->m_useTapDevice == true)
+    std::vector<std::string> ids = { sai_serialize_object_id(object_id) };
+
+    sai_status_t object_status;
+
+    createRouterifs(switch_id, ids, &attr_count, &attr_list, SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, &object_status);
+
+    return object_status;
+}
+
+/*
+ * Router interfaces are committed to the switch state first, then the new
+ * ones are configured in VPP as one batch and rolled back if VPP fails. In
+ * stop on error mode each one is configured in VPP before the next one is
+ * created, so nothing after a failed interface exists.
+ */
+sai_status_t SwitchStateBase::createRouterifs(
+        _In_ sai_object_id_t switch_id,
+        _In_ const std::vector<std::string>& serialized_object_ids,
+        _In_ const uint32_t *attr_count,
+        _In_ const sai_attribute_t **attr_list,
+        _In_ sai_bulk_op_error_mode_t mode,
+        _Out_ sai_status_t *object_statuses)
+{
+    SWSS_LOG_ENTER();
+
+    uint32_t object_count = (uint32_t)serialized_object_ids.size();
+
+    bool stop_on_error = (mode == SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR);
+
+    std::vector<bool> is_sub_port(object_count, false);
+
+    // committed new router interfaces waiting for their VPP configuration
+    std::vector<RifVppConfig> configs;
+    std::vector<uint32_t> config_idx;
+
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    auto rollback = [&](uint32_t idx) {
+
+        remove_internal(SAI_OBJECT_TYPE_ROUTER_INTERFACE, serialized_object_ids[idx]);
+
+        if (is_sub_port[idx])
+        {
+            update_sub_port_usage(-1);
+        }
+    };
+
+    auto configure = [&]() {
+
+        std::vector<sai_status_t> statuses;
+
+        vpp_create_router_interfaces(configs, statuses);
+
+        for (size_t i = 0; i < config_idx.size(); i++)
+        {
+            if (statuses[i] != SAI_STATUS_SUCCESS)
+            {
+                rollback(config_idx[i]);
+
+                object_statuses[config_idx[i]] = statuses[i];
+                status = SAI_STATUS_FAILURE;
+            }
+        }
+
+        configs.clear();
+        config_idx.clear();
+    };
+
+    uint32_t it;
+
+    for (it = 0; it < object_count; it++)
     {
-	sai_attribute_t tattr;
+        auto& sid = serialized_object_ids[it];
 
-	tattr.id = SAI_ROUTER_INTERFACE_ATTR_TYPE;
-	if (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, object_id, 1, &tattr) == SAI_STATUS_ITEM_NOT_FOUND)
-	{
-	    vpp_create_router_interface(attr_count, attr_list);
-	} else {
-	    vpp_update_router_interface(object_id, attr_count, attr_list);
-	}
+        sai_object_id_t object_id;
+        sai_deserialize_object_id(sid, object_id);
+
+        sai_attribute_t tattr;
+
+        tattr.id = SAI_ROUTER_INTERFACE_ATTR_TYPE;
+
+        bool is_new = (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, object_id, 1, &tattr) == SAI_STATUS_ITEM_NOT_FOUND);
+
+        auto attr_type = sai_metadata_get_attr_by_id(SAI_ROUTER_INTERFACE_ATTR_TYPE, attr_count[it], attr_list[it]);
+
+        is_sub_port[it] = is_new && attr_type && attr_type->value.s32 == SAI_ROUTER_INTERFACE_TYPE_SUB_PORT;
+
+        object_statuses[it] = is_sub_port[it] ? check_sub_port_admission() : SAI_STATUS_SUCCESS;
+
+        if (object_statuses[it] == SAI_STATUS_SUCCESS)
+        {
+            object_statuses[it] = create_internal(SAI_OBJECT_TYPE_ROUTER_INTERFACE, sid, switch_id, attr_count[it], attr_list[it]);
+        }
+
+        if (object_statuses[it] == SAI_STATUS_SUCCESS && is_sub_port[it])
+        {
+            update_sub_port_usage(1);
+        }
+
+        if (object_statuses[it] == SAI_STATUS_SUCCESS && m_switchConfig->m_useTapDevice == true)
+        {
+            if (is_new)
+            {
+                size_t count = configs.size();
+
+                object_statuses[it] = vpp_get_router_interface_config(attr_count[it], attr_list[it], configs);
+
+                if (object_statuses[it] != SAI_STATUS_SUCCESS)
+                {
+                    rollback(it);
+                }
+                else if (configs.size() != count)
+                {
+                    config_idx.push_back(it);
+                }
+            }
+            else
+            {
+                vpp_update_router_interface(object_id, attr_count[it], attr_list[it]);
+            }
+        }
+
+        if (stop_on_error && object_statuses[it] == SAI_STATUS_SUCCESS)
+        {
+            configure();
+        }
+
+        if (object_statuses[it] != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to create router interface %s", sid.c_str());
+
+            status = SAI_STATUS_FAILURE;
+
+            if (stop_on_error)
+            {
+                break;
+            }
+        }
     }
 
-    auto sid = sai_serialize_object_id(object_id);
+    while (++it < object_count)
+    {
+        object_statuses[it] = SAI_STATUS_NOT_EXECUTED;
+    }
 
-    CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_ROUTER_INTERFACE, sid, switch_id, attr_count, attr_list));
+    configure();
 
-    return SAI_STATUS_SUCCESS;
+    for (it = 0; it < object_count; it++)
+    {
+        if (object_statuses[it] == SAI_STATUS_SUCCESS)
+        {
+            sai_object_id_t object_id;
+            sai_deserialize_object_id(serialized_object_ids[it], object_id);
+
+            drain_pending_routes(PendingRoutes::ROUTE_DEP_RIF, object_id);
+        }
+    }
+
+    // the router interface may have brought up a host interface address
+
+    drain_pending_address_routes("router interface create");
+
+    return status;
 }
 
 sai_status_t SwitchStateBase::removeRouterif(
@@ -1187,6 +1705,13 @@ sai_status_t SwitchStateBase::removeRouterif(
 {
     SWSS_LOG_ENTER();
 
+    sai_attribute_t tattr;
+
+    tattr.id = SAI_ROUTER_INTERFACE_ATTR_TYPE;
+
+    bool is_sub_port = (get(SAI_OBJECT_TYPE_ROUTER_INTERFACE, objectId, 1, &tattr) == SAI_STATUS_SUCCESS &&
+            tattr.value.s32 == SAI_ROUTER_INTERFACE_TYPE_SUB_PORT);
+
     if (m_switchConfig->m_useTapDevice == true)
     {
         vpp_remove_router_interface(objectId);
@@ -1196,6 +1721,11 @@ sai_status_t SwitchStateBase::removeRouterif(
 
     CHECK_STATUS(remove_internal(SAI_OBJECT_TYPE_ROUTER_INTERFACE, sid));
 
+    if (is_sub_port)
+    {
+        update_sub_port_usage(-1);
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -1204,9 +1734,10 @@ sai_status_t SwitchStateBase::removeVrf(
 {
     SWSS_LOG_ENTER();
 
-    if (m_switchConfig->m_useTapDevice == true)
+    if (m_switchConfig->m_useTapDevice == true &&
+            vpp_del_ip_vrf(objectId) != 0)
     {
-        vpp_del_ip_vrf(objectId);
+        return SAI_STATUS_OBJECT_IN_USE;
     }
 
     auto sid = sai_serialize_object_id(objectId);
@@ -91,7 +91,7 @@ sai_status_t SwitchStateBase::IpRouteNexthopEntry(
 
     CHECK_STATUS(get(SAI_OBJECT_TYPE_NEXT_HOP, next_hop_oid, 1, &attr));
     if (attr.value.s32 != SAI_NEXT_HOP_TYPE_IP) {
-	return SAI_STATUS_SUCCESS;
+	return SAI_STATUS_NOT_SUPPORTED;
     }
     attr.id = SAI_NEXT_HOP_ATTR_IP;
     if (get(SAI_OBJECT_TYPE_NEXT_HOP, next_hop_oid, 1, &attr) == SAI_STATUS_SUCCESS)
@@ -174,7 +174,7 @@ sai_status_t SwitchStateBase::IpRouteAddRemove(
     {
 	status = find_attrib_in_list(attr_count, attr_list, SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION, &next_hop, &next_hop_index);
 	if (status == SAI_STATUS_SUCCESS && SAI_PACKET_ACTION_FORWARD == next_hop->s32) {
-	    vpp_add_del_intf_ip_addr_norif(serializedObjectId, route_entry, is_add);    
+	    ret = vpp_add_del_intf_ip_addr_norif(serializedObjectId, route_entry, is_add);
 	}
     }
     else if (SAI_OBJECT_TYPE_NEXT_HOP == sai_object_type_query(next_hop_oid))
@@ -190,14 +190,24 @@ sai_status_t SwitchStateBase::IpRouteAddRemove(
 	std::shared_ptr<IpVrfInfo> vrf;
 	uint32_t vrf_id;
 
+	bool is_ipv6 = (route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV6);
+
 	vrf = vpp_get_ip_vrf(route_entry.vr_id);
 	if (vrf == nullptr) {
 	    vrf_id = 0;
 	} else {
 	    vrf_id = vrf->m_vrf_id;
+
+	    /* The table of the route family is created with its first route */
+	    if (is_add && vpp_ip_vrf_ref(route_entry.vr_id, is_ipv6, serializedObjectId) != 0) {
+		return SAI_STATUS_FAILURE;
+	    }
 	}
 	vpp_ip_route_t *ip_route = (vpp_ip_route_t *) calloc(1, sizeof(vpp_ip_route_t) + sizeof(vpp_ip_nexthop_t));
 	if (!ip_route) {
+	    if (vrf != nullptr && is_add) {
+		vpp_ip_vrf_unref(route_entry.vr_id, is_ipv6, serializedObjectId);
+	    }
 	    return SAI_STATUS_FAILURE;
 	}
 	create_route_prefix_entry(&route_entry, ip_route);
@@ -210,6 +220,17 @@ sai_status_t SwitchStateBase::IpRouteAddRemove(
 	init_vpp_client();
 
 	ret = ip_route_add_del(ip_route, is_add);
+
+	if (vrf != nullptr && (!is_add || ret != 0))
+	{
+	    vpp_ip_vrf_unref(route_entry.vr_id, is_ipv6, serializedObjectId);
+	}
+
+	if (ret == 0)
+	{
+	    update_route_stats_index(serializedObjectId, route_entry.vr_id, is_add ? ip_route->stats_index : ~0);
+	}
+
 	free(ip_route);
 
 	SWSS_LOG_NOTICE("%s ip route in VPP %s status %d table %u", (is_add ? "Add" : "Remove"),
@@ -229,12 +250,51 @@ sai_status_t SwitchStateBase::addIpRoute(
 {
     SWSS_LOG_ENTER();
 
+    sai_route_entry_t route_entry;
+
+    sai_deserialize_route_entry(serializedObjectId, route_entry);
+
+    auto &objectHash = m_objectHash.at(SAI_OBJECT_TYPE_ROUTE_ENTRY);
+
+    bool exists = (objectHash.find(serializedObjectId) != objectHash.end());
+
+    if (!exists)
+    {
+        // reject before anything is programmed in VPP
+
+        CHECK_STATUS(check_route_admission(route_entry));
+    }
+
+    auto dep = PendingRoutes::ROUTE_DEP_NONE;
+    sai_object_id_t dep_id = SAI_NULL_OBJECT_ID;
+
     if (is_ip_nbr_active() == true) {
-	IpRouteAddRemove(serializedObjectId, attr_count, attr_list, true);
+	dep = route_missing_dependency(route_entry, attr_count, attr_list, dep_id);
+
+	if (dep == PendingRoutes::ROUTE_DEP_NONE &&
+	    IpRouteAddRemove(serializedObjectId, attr_count, attr_list, true) == SAI_STATUS_ADDR_NOT_FOUND)
+	{
+	    // no host interface has the prefix address yet
+	    dep = PendingRoutes::ROUTE_DEP_ADDRESS;
+	}
     }
 
     CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, switch_id, attr_count, attr_list));
 
+    update_route_usage(route_entry, 1);
+
+    if (dep != PendingRoutes::ROUTE_DEP_NONE)
+    {
+        defer_route(serializedObjectId, route_entry, dep, dep_id);
+    }
+
+    auto counter = sai_metadata_get_attr_by_id(SAI_ROUTE_ENTRY_ATTR_COUNTER_ID, attr_count, attr_list);
+
+    if (counter)
+    {
+        bind_route_counter(serializedObjectId, counter->value.oid);
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
@@ -243,26 +303,389 @@ sai_status_t SwitchStateBase::removeIpRoute(
 {
     SWSS_LOG_ENTER();
 
-    if (is_ip_nbr_active() == true) {
-        sai_attribute_t attr[2];
+    // a pending route was never programmed in VPP
+
+    bool pending = cancel_pending_route(serializedObjectId);
 
-	attr[0].id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+    if (is_ip_nbr_active() == true && !pending) {
+	IpRouteAddRemoveStored(serializedObjectId, false);
+    }
+
+    CHECK_STATUS(remove_internal(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId));
 
-	if (get(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, 1, &attr[0]) == SAI_STATUS_SUCCESS) {
-	    uint32_t attr_count = 1;
+    sai_route_entry_t route_entry;
+
+    sai_deserialize_route_entry(serializedObjectId, route_entry);
+
+    update_route_usage(route_entry, -1);
+
+    bind_route_counter(serializedObjectId, SAI_NULL_OBJECT_ID);
+
+    update_route_stats_index(serializedObjectId, route_entry.vr_id, ~0);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::IpRouteAddRemoveStored(
+        _In_ const std::string &serializedObjectId,
+        _In_ bool is_add)
+{
+    SWSS_LOG_ENTER();
+
+    sai_attribute_t attr[2];
+
+    attr[0].id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+
+    if (get(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, 1, &attr[0]) != SAI_STATUS_SUCCESS) {
+	return SAI_STATUS_SUCCESS;
+    }
+
+    uint32_t attr_count = 1;
+
+    attr[1].id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+    if (get(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, 1, &attr[1]) == SAI_STATUS_SUCCESS)
+    {
+	attr_count++;
+    }
 
-	    attr[1].id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
-	    if (get(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, 1, &attr[1]) == SAI_STATUS_SUCCESS)
-	    {
-		attr_count++;
+    return IpRouteAddRemove(serializedObjectId, attr_count, attr, is_add);
+}
+
+void SwitchStateBase::warm_update_route_counters()
+{
+    SWSS_LOG_ENTER();
+
+    auto &objectHash = m_objectHash.at(SAI_OBJECT_TYPE_ROUTE_ENTRY);
+
+    for (auto& kvp: objectHash)
+    {
+        auto counter = kvp.second.find("SAI_ROUTE_ENTRY_ATTR_COUNTER_ID");
+
+        if (counter != kvp.second.end())
+        {
+            bind_route_counter(kvp.first, counter->second->getAttr()->value.oid);
+        }
+    }
+
+    if (is_ip_nbr_active() == false)
+    {
+        return;
+    }
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+
+    sai_object_id_t default_vr_id = (get(SAI_OBJECT_TYPE_SWITCH, m_switch_id, 1, &attr) == SAI_STATUS_SUCCESS) ? attr.value.oid : SAI_NULL_OBJECT_ID;
+
+    size_t found = 0;
+    size_t missing = 0;
+
+    init_vpp_client();
+
+    for (auto& kvp: objectHash)
+    {
+	// only routes via IP next hops have a FIB entry of their own
+
+	auto next_hop = kvp.second.find("SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID");
+
+	if (next_hop == kvp.second.end() ||
+	    sai_object_type_query(next_hop->second->getAttr()->value.oid) != SAI_OBJECT_TYPE_NEXT_HOP) {
+	    continue;
+	}
+
+	sai_route_entry_t route_entry;
+
+	sai_deserialize_route_entry(kvp.first, route_entry);
+
+	vpp_ip_route_t ip_route;
+
+	memset(&ip_route, 0, sizeof(ip_route));
+
+	create_route_prefix_entry(&route_entry, &ip_route);
+
+	if (route_entry.vr_id != default_vr_id) {
+	    auto vrf = vpp_get_ip_vrf(route_entry.vr_id);
+
+	    if (vrf == nullptr) {
+		missing++;
+		continue;
 	    }
+	    ip_route.vrf_id = vrf->m_vrf_id;
+	}
 
-	    IpRouteAddRemove(serializedObjectId, attr_count, attr, false);
+	if (ip_route_lookup(&ip_route) != 0 || ip_route.stats_index == (uint32_t)~0) {
+	    missing++;
+	    continue;
 	}
+
+	update_route_stats_index(kvp.first, route_entry.vr_id, ip_route.stats_index);
+
+	found++;
     }
 
-    CHECK_STATUS(remove_internal(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId));
+    SWSS_LOG_NOTICE("route counters after warm boot: %zu bound, %zu FIB entries found, %zu not found",
+            m_routeCounter.size(), found, missing);
+}
+
+PendingRoutes::route_dep_t SwitchStateBase::route_missing_dependency(
+        _In_ const sai_route_entry_t& route_entry,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list,
+        _Out_ sai_object_id_t& dep_id)
+{
+    SWSS_LOG_ENTER();
+
+    dep_id = SAI_NULL_OBJECT_ID;
+
+    sai_attribute_t attr;
+
+    /*
+     * Without the VPP table id a route in a non default VRF would end up in
+     * table 0, the id is learnt with the first router interface in it.
+     */
+
+    attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+
+    if (route_entry.vr_id != SAI_NULL_OBJECT_ID &&
+        get(SAI_OBJECT_TYPE_SWITCH, m_switch_id, 1, &attr) == SAI_STATUS_SUCCESS &&
+        attr.value.oid != route_entry.vr_id &&
+        vpp_get_ip_vrf(route_entry.vr_id) == nullptr)
+    {
+        dep_id = route_entry.vr_id;
+
+        return PendingRoutes::ROUTE_DEP_VRF;
+    }
+
+    auto next_hop = sai_metadata_get_attr_by_id(SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID, attr_count, attr_list);
+
+    if (next_hop == NULL || next_hop->value.oid == SAI_NULL_OBJECT_ID)
+    {
+        return PendingRoutes::ROUTE_DEP_NONE;
+    }
+
+    auto ot = sai_object_type_query(next_hop->value.oid);
+
+    /*
+     * Only IP next hops are programmed, a route via a next hop group or
+     * another next hop type waits until it is set to an IP next hop.
+     */
+
+    if (ot == SAI_OBJECT_TYPE_NEXT_HOP_GROUP)
+    {
+        dep_id = next_hop->value.oid;
+
+        return PendingRoutes::ROUTE_DEP_NEXT_HOP;
+    }
+
+    if (ot != SAI_OBJECT_TYPE_NEXT_HOP)
+    {
+        return PendingRoutes::ROUTE_DEP_NONE;
+    }
+
+    attr.id = SAI_NEXT_HOP_ATTR_TYPE;
+
+    if (get(SAI_OBJECT_TYPE_NEXT_HOP, next_hop->value.oid, 1, &attr) != SAI_STATUS_SUCCESS ||
+        attr.value.s32 != SAI_NEXT_HOP_TYPE_IP)
+    {
+        dep_id = next_hop->value.oid;
+
+        return PendingRoutes::ROUTE_DEP_NEXT_HOP;
+    }
+
+    attr.id = SAI_NEXT_HOP_ATTR_ROUTER_INTERFACE_ID;
+
+    if (get(SAI_OBJECT_TYPE_NEXT_HOP, next_hop->value.oid, 1, &attr) == SAI_STATUS_SUCCESS)
+    {
+        auto &rifHash = m_objectHash.at(SAI_OBJECT_TYPE_ROUTER_INTERFACE);
+
+        if (rifHash.find(sai_serialize_object_id(attr.value.oid)) == rifHash.end())
+        {
+            dep_id = attr.value.oid;
+
+            return PendingRoutes::ROUTE_DEP_RIF;
+        }
+    }
+
+    return PendingRoutes::ROUTE_DEP_NONE;
+}
+
+void SwitchStateBase::defer_route(
+        _In_ const std::string &serializedObjectId,
+        _In_ const sai_route_entry_t& route_entry,
+        _In_ PendingRoutes::route_dep_t dep,
+        _In_ sai_object_id_t dep_id)
+{
+    SWSS_LOG_ENTER();
+
+    if (dep == PendingRoutes::ROUTE_DEP_ADDRESS)
+    {
+        m_pendingRoutes.deferAddress(serializedObjectId, route_entry.destination);
+
+        SWSS_LOG_NOTICE("Deferring VPP ip route %s until a host interface has its address",
+                serializedObjectId.c_str());
+
+        return;
+    }
+
+    m_pendingRoutes.defer(serializedObjectId, dep, dep_id);
+
+    SWSS_LOG_NOTICE("Deferring VPP ip route %s until %s %s is available",
+            serializedObjectId.c_str(),
+            PendingRoutes::depName(dep),
+            sai_serialize_object_id(dep_id).c_str());
+}
+
+bool SwitchStateBase::cancel_pending_route(
+        _In_ const std::string &serializedObjectId)
+{
+    SWSS_LOG_ENTER();
+
+    return m_pendingRoutes.cancel(serializedObjectId);
+}
+
+void SwitchStateBase::retry_pending_routes(
+        _In_ const std::set<std::string>& routes,
+        _In_ const std::string& event)
+{
+    SWSS_LOG_ENTER();
+
+    if (routes.empty())
+    {
+        return;
+    }
+
+    size_t programmed = 0;
+
+    for (auto& serializedObjectId: routes)
+    {
+        sai_route_entry_t route_entry;
+
+        sai_deserialize_route_entry(serializedObjectId, route_entry);
+
+        sai_attribute_t attr;
+
+        attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+
+        uint32_t attr_count = (get(SAI_OBJECT_TYPE_ROUTE_ENTRY, serializedObjectId, 1, &attr) == SAI_STATUS_SUCCESS) ? 1 : 0;
+
+        // the route may be waiting for more than one dependency
+
+        sai_object_id_t dep_id;
+
+        auto dep = route_missing_dependency(route_entry, attr_count, &attr, dep_id);
+
+        if (dep == PendingRoutes::ROUTE_DEP_NONE &&
+            IpRouteAddRemoveStored(serializedObjectId, true) == SAI_STATUS_ADDR_NOT_FOUND)
+        {
+            dep = PendingRoutes::ROUTE_DEP_ADDRESS;
+        }
+
+        if (dep != PendingRoutes::ROUTE_DEP_NONE)
+        {
+            defer_route(serializedObjectId, route_entry, dep, dep_id);
+            continue;
+        }
+
+        programmed++;
+    }
+
+    SWSS_LOG_NOTICE("Programmed %zu of %zu pending VPP ip routes on %s",
+            programmed,
+            routes.size(),
+            event.c_str());
+}
+
+void SwitchStateBase::drain_pending_routes(
+        _In_ PendingRoutes::route_dep_t dep,
+        _In_ sai_object_id_t dep_id)
+{
+    SWSS_LOG_ENTER();
+
+    retry_pending_routes(m_pendingRoutes.take(dep, dep_id),
+            std::string(PendingRoutes::depName(dep)) + " " + sai_serialize_object_id(dep_id));
+}
+
+void SwitchStateBase::drain_pending_address_routes(
+        _In_ const std::vector<std::string>& addresses,
+        _In_ const std::string& event)
+{
+    SWSS_LOG_ENTER();
+
+    std::set<std::string> routes;
+
+    for (auto& address: addresses)
+    {
+        sai_ip_address_t ip;
+
+        try
+        {
+            sai_deserialize_ip_address(address, ip);
+        }
+        catch (const std::exception& e)
+        {
+            SWSS_LOG_WARN("Ignoring host interface address %s: %s", address.c_str(), e.what());
+            continue;
+        }
+
+        // only the routes whose prefix has the address are retried
+
+        auto taken = m_pendingRoutes.takeForAddress(ip);
+
+        routes.insert(taken.begin(), taken.end());
+    }
+
+    retry_pending_routes(routes, event);
+}
+
+void SwitchStateBase::drain_pending_address_routes(
+        _In_ const std::string& event)
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_pendingRoutes.hasAddressRoutes())
+    {
+        return;
+    }
+
+    std::vector<std::string> addresses;
+
+    if (vpp_get_host_addresses(addresses) != 0)
+    {
+        return;
+    }
+
+    drain_pending_address_routes(addresses, event);
+}
+
+sai_status_t SwitchStateBase::createNextHop(
+        _In_ const std::string &serializedObjectId,
+        _In_ sai_object_id_t switch_id,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list)
+{
+    SWSS_LOG_ENTER();
+
+    CHECK_STATUS(create_internal(SAI_OBJECT_TYPE_NEXT_HOP, serializedObjectId, switch_id, attr_count, attr_list));
+
+    sai_object_id_t object_id;
+
+    sai_deserialize_object_id(serializedObjectId, object_id);
+
+    drain_pending_routes(PendingRoutes::ROUTE_DEP_NEXT_HOP, object_id);
 
     return SAI_STATUS_SUCCESS;
 }
 
+void SwitchStateBase::rekey_pending_route(
+        _In_ const std::string &serializedObjectId)
+{
+    SWSS_LOG_ENTER();
+
+    // a pending route may not wait for the same dependency after a set
+
+    if (m_pendingRoutes.cancel(serializedObjectId))
+    {
+        retry_pending_routes({ serializedObjectId }, "route set");
+    }
+}
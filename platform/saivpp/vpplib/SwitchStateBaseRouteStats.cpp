@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SwitchStateBase.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+#include <inttypes.h>
+
+using namespace saivpp;
+
+void SwitchStateBase::bind_route_counter(
+        _In_ const std::string& serializedObjectId,
+        _In_ sai_object_id_t counter_id)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_routeCounter.find(serializedObjectId);
+
+    if (it != m_routeCounter.end())
+    {
+        m_counterRoute.erase(it->second);
+        m_routeCounter.erase(it);
+    }
+
+    if (counter_id == SAI_NULL_OBJECT_ID)
+    {
+        return;
+    }
+
+    m_routeCounter[serializedObjectId] = counter_id;
+    m_counterRoute[counter_id] = serializedObjectId;
+}
+
+void SwitchStateBase::update_route_stats_index(
+        _In_ const std::string& serializedObjectId,
+        _In_ sai_object_id_t vr_id,
+        _In_ uint32_t stats_index)
+{
+    SWSS_LOG_ENTER();
+
+    if (stats_index == (uint32_t)~0)
+    {
+        m_routeStatsIndex.erase(serializedObjectId);
+        return;
+    }
+
+    m_routeStatsIndex[serializedObjectId] = { vr_id, stats_index };
+}
+
+sai_status_t SwitchStateBase::setRouteCounterStats(
+        _In_ sai_object_id_t counter_id)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_counterRoute.find(counter_id);
+
+    if (it == m_counterRoute.end())
+    {
+        // not bound to a route
+
+        return SAI_STATUS_SUCCESS;
+    }
+
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+
+    auto idx = m_routeStatsIndex.find(it->second);
+
+    if (idx != m_routeStatsIndex.end())
+    {
+        auto snapshot = get_stats_snapshot(true);
+
+        if (snapshot == nullptr)
+        {
+            // keep last values
+
+            return SAI_STATUS_SUCCESS;
+        }
+
+        auto& routeStats = snapshot->getRouteCounters();
+
+        if (idx->second.m_index < routeStats.size())
+        {
+            packets = routeStats[idx->second.m_index].packets;
+            bytes = routeStats[idx->second.m_index].bytes;
+        }
+    }
+
+    std::map<sai_stat_id_t, uint64_t> stats;
+
+    stats[SAI_COUNTER_STAT_PACKETS] = packets;
+    stats[SAI_COUNTER_STAT_BYTES] = bytes;
+
+    debugSetStats(counter_id, stats);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchStateBase::getVrfRouteSummary(
+        _In_ sai_object_id_t vr_id,
+        _Out_ VrfRouteSummary& summary)
+{
+    SWSS_LOG_ENTER();
+
+    auto count = m_vrfRouteCount.find(vr_id);
+
+    summary.m_routes = (count == m_vrfRouteCount.end()) ? 0 : count->second;
+    summary.m_packets = 0;
+    summary.m_bytes = 0;
+
+    auto snapshot = get_stats_snapshot(true);
+
+    if (snapshot == nullptr)
+    {
+        return SAI_STATUS_FAILURE;
+    }
+
+    auto& routeStats = snapshot->getRouteCounters();
+
+    for (auto& kvp: m_routeStatsIndex)
+    {
+        if (kvp.second.m_vrId != vr_id || kvp.second.m_index >= routeStats.size())
+        {
+            continue;
+        }
+
+        summary.m_packets += routeStats[kvp.second.m_index].packets;
+        summary.m_bytes += routeStats[kvp.second.m_index].bytes;
+    }
+
+    SWSS_LOG_INFO("virtual router %s: %zu routes, %" PRIu64 " packets, %" PRIu64 " bytes",
+            sai_serialize_object_id(vr_id).c_str(),
+            summary.m_routes,
+            summary.m_packets,
+            summary.m_bytes);
+
+    return SAI_STATUS_SUCCESS;
+}
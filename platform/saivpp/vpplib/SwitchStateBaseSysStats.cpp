@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SwitchStateBase.h"
+#include "saivpp.h"
+
+#include "swss/logger.h"
+
+#include "meta/sai_serialize.h"
+
+using namespace saivpp;
+
+namespace
+{
+    // gauges, a clear has no meaning for them
+    const std::vector<sai_stat_id_t> switchGaugeStats = {
+        SAI_VPP_SWITCH_STAT_WORKER_THREADS,
+        SAI_VPP_SWITCH_STAT_VECTOR_RATE,
+        SAI_VPP_SWITCH_STAT_MAX_WORKER_VECTOR_RATE,
+        SAI_VPP_SWITCH_STAT_LOOPS_PER_SEC,
+        SAI_VPP_SWITCH_STAT_MIN_WORKER_LOOPS_PER_SEC,
+        SAI_VPP_SWITCH_STAT_BUFFERS_USED,
+        SAI_VPP_SWITCH_STAT_BUFFERS_AVAILABLE,
+        SAI_VPP_SWITCH_STAT_BUFFERS_CACHED,
+        SAI_VPP_SWITCH_STAT_MAIN_HEAP_USED,
+        SAI_VPP_SWITCH_STAT_MAIN_HEAP_TOTAL,
+    };
+
+    // interface counters of packets the NIC dropped before VPP polled them
+    const std::vector<const char*> inputQueueDropCounters = { "rx-miss", "rx-no-buf" };
+}
+
+sai_status_t SwitchStateBase::setSwitchStats(
+        _In_ sai_object_id_t switch_id)
+{
+    SWSS_LOG_ENTER();
+
+    vpp_sys_stats_t sys;
+
+    if (vpp_sys_stats_query(&sys) != 0)
+    {
+        SWSS_LOG_WARN("failed to read VPP system stats of switch %s",
+                sai_serialize_object_id(switch_id).c_str());
+
+        // keep last values
+
+        return SAI_STATUS_FAILURE;
+    }
+
+    std::map<sai_stat_id_t, uint64_t> stats = {
+        { SAI_VPP_SWITCH_STAT_WORKER_THREADS,           sys.num_worker_threads },
+        { SAI_VPP_SWITCH_STAT_VECTOR_RATE,              sys.vector_rate },
+        { SAI_VPP_SWITCH_STAT_MAX_WORKER_VECTOR_RATE,   sys.max_worker_vector_rate },
+        { SAI_VPP_SWITCH_STAT_LOOPS_PER_SEC,            sys.loops_per_sec },
+        { SAI_VPP_SWITCH_STAT_MIN_WORKER_LOOPS_PER_SEC, sys.min_worker_loops_per_sec },
+        { SAI_VPP_SWITCH_STAT_BUFFERS_USED,             sys.buffers_used },
+        { SAI_VPP_SWITCH_STAT_BUFFERS_AVAILABLE,        sys.buffers_available },
+        { SAI_VPP_SWITCH_STAT_BUFFERS_CACHED,           sys.buffers_cached },
+        { SAI_VPP_SWITCH_STAT_MAIN_HEAP_USED,           sys.main_heap_used },
+        { SAI_VPP_SWITCH_STAT_MAIN_HEAP_TOTAL,          sys.main_heap_total },
+    };
+
+    auto snapshot = get_stats_snapshot(false);
+
+    if (snapshot)
+    {
+        uint64_t drops = 0;
+
+        for (auto& kvp: snapshot->getInterfaces())
+        {
+            for (auto name: inputQueueDropCounters)
+            {
+                auto c = kvp.second.m_vpp.find(name);
+
+                if (c != kvp.second.m_vpp.end())
+                {
+                    drops += c->second.packets;
+                }
+            }
+        }
+
+        stats[SAI_VPP_SWITCH_STAT_INPUT_QUEUE_DROPS] = drops;
+    }
+
+    debugSetStats(switch_id, stats);
+
+    for (auto id: switchGaugeStats)
+    {
+        m_statsBaseline.set(switch_id, id, 0);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void SwitchStateBase::switchStatsCapability(
+        _Inout_ std::map<sai_stat_id_t, uint32_t>& supported) const
+{
+    SWSS_LOG_ENTER();
+
+    for (auto id: switchGaugeStats)
+    {
+        supported[id] = SAI_STATS_MODE_READ;
+    }
+
+    supported[SAI_VPP_SWITCH_STAT_INPUT_QUEUE_DROPS] = SAI_STATS_MODE_READ | SAI_STATS_MODE_READ_AND_CLEAR;
+}
@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SwitchVPP.h"
+
+#include "swss/logger.h"
+#include "meta/sai_serialize.h"
+
+#include "vppxlate/SaiVppXlate.h"
+
+#include <algorithm>
+
+#define SAI_VPP_MAX_HW_INTERFACES 1024
+
+// used when VPP does not report link speed (af_packet, tap)
+#define SAI_VPP_DEFAULT_PORT_SPEED (40 * 1000)
+
+// SONiC qos/buffer templates address traffic classes 0..7
+#define SAI_VPP_MIN_PORT_QUEUES 8
+
+#define SAI_VPP_CPU_QUEUES 8
+
+using namespace saivpp;
+
+SwitchVPP::SwitchVPP(
+        _In_ sai_object_id_t switch_id,
+        _In_ std::shared_ptr<RealObjectIdManager> manager,
+        _In_ std::shared_ptr<SwitchConfig> config):
+    SwitchStateBase(switch_id, manager, config)
+{
+    SWSS_LOG_ENTER();
+
+    // empty
+}
+
+SwitchVPP::SwitchVPP(
+        _In_ sai_object_id_t switch_id,
+        _In_ std::shared_ptr<RealObjectIdManager> manager,
+        _In_ std::shared_ptr<SwitchConfig> config,
+        _In_ std::shared_ptr<WarmBootState> warmBootState):
+    SwitchStateBase(switch_id, manager, config, warmBootState)
+{
+    SWSS_LOG_ENTER();
+
+    // empty
+}
+
+void SwitchVPP::discover_hw_interfaces()
+{
+    SWSS_LOG_ENTER();
+
+    m_hwif_info.clear();
+
+    if (init_vpp_client() != 0)
+    {
+        SWSS_LOG_WARN("VPP client not available, using default port sizing");
+
+        return;
+    }
+
+    std::vector<vpp_hw_interface_t> hwifs(SAI_VPP_MAX_HW_INTERFACES);
+
+    uint32_t count = 0;
+
+    if (hw_interfaces_dump(hwifs.data(), (uint32_t)hwifs.size(), &count) != 0)
+    {
+        SWSS_LOG_WARN("failed to dump VPP hardware interfaces, using default port sizing");
+
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const auto &hwif = hwifs.at(i);
+
+        HwIfInfo info;
+
+        info.m_name = hwif.hwif_name;
+        info.m_speed = hwif.link_speed / 1000;
+        info.m_queues = hwif.num_tx_queues;
+
+        SWSS_LOG_NOTICE("VPP hw interface %s sw_if_index %u: speed %u Mbps, %u rx %u tx queues",
+                hwif.hwif_name,
+                hwif.sw_if_index,
+                info.m_speed,
+                hwif.num_rx_queues,
+                hwif.num_tx_queues);
+
+        m_hwif_info[info.m_name] = info;
+    }
+}
+
+uint32_t SwitchVPP::get_port_queues_count(
+        _In_ sai_object_id_t port_id) const
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_port_queues_count.find(port_id);
+
+    if (it == m_port_queues_count.end())
+    {
+        // port created after init, no VPP interface known yet
+
+        return SAI_VPP_MIN_PORT_QUEUES;
+    }
+
+    return it->second;
+}
+
+void SwitchVPP::add_port_queues_attrs(
+        _In_ sai_object_id_t port_id,
+        _In_ sai_queue_type_t queue_type,
+        _In_ uint32_t queues_count,
+        _Inout_ std::vector<std::vector<sai_attribute_t>>& attr_lists) const
+{
+    SWSS_LOG_ENTER();
+
+    for (uint32_t i = 0; i < queues_count; ++i)
+    {
+        std::vector<sai_attribute_t> attrs(3);
+
+        attrs[0].id = SAI_QUEUE_ATTR_TYPE;
+        attrs[0].value.s32 = queue_type;
+
+        attrs[1].id = SAI_QUEUE_ATTR_INDEX;
+        attrs[1].value.u8 = (uint8_t)i;
+
+        attrs[2].id = SAI_QUEUE_ATTR_PORT;
+        attrs[2].value.oid = port_id;
+
+        attr_lists.push_back(attrs);
+    }
+}
+
+sai_status_t SwitchVPP::set_port_queues(
+        _In_ sai_object_id_t port_id,
+        _In_ sai_object_id_t *queues,
+        _In_ uint32_t queues_count)
+{
+    SWSS_LOG_ENTER();
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
+    attr.value.u32 = queues_count;
+
+    CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+
+    attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
+    attr.value.objlist.count = queues_count;
+    attr.value.objlist.list = queues;
+
+    return set(SAI_OBJECT_TYPE_PORT, port_id, &attr);
+}
+
+std::string SwitchVPP::get_lanes_hwif_name(
+        _In_ const LaneMap& laneMap,
+        _In_ const std::map<std::string, std::string>& hostifHwifMap,
+        _In_ const std::vector<uint32_t>& lanes)
+{
+    SWSS_LOG_ENTER();
+
+    if (lanes.empty())
+    {
+        return "";
+    }
+
+    auto ifname = laneMap.getInterfaceFromLaneNumber(lanes[0]);
+
+    if (ifname.empty())
+    {
+        return "";
+    }
+
+    auto it = hostifHwifMap.find(ifname);
+
+    if (it == hostifHwifMap.end())
+    {
+        SWSS_LOG_WARN("port %s has no VPP interface in the interface map", ifname.c_str());
+
+        return "";
+    }
+
+    return it->second;
+}
+
+sai_status_t SwitchVPP::create_ports()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("create ports");
+
+    auto map = m_switchConfig->m_laneMap;
+
+    if (!map)
+    {
+        SWSS_LOG_ERROR("lane map for switch %s is NULL",
+                sai_serialize_object_id(m_switch_id).c_str());
+
+        return SAI_STATUS_FAILURE;
+    }
+
+    auto lanesVector = map->getLaneVector();
+
+    if (m_switchConfig->m_useTapDevice)
+    {
+        SWSS_LOG_DEBUG("Check available lane");
+
+        CHECK_STATUS(filter_available_lanes(lanesVector));
+    }
+
+    discover_hw_interfaces();
+
+    populate_if_mapping();
+
+    std::vector<std::string> hwifs;
+
+    for (auto& lanes: lanesVector)
+    {
+        hwifs.push_back(get_lanes_hwif_name(*map, m_hostif_hwif_map, lanes));
+    }
+
+    uint32_t port_count = (uint32_t)lanesVector.size();
+
+    m_port_list.clear();
+    m_port_queues_count.clear();
+
+    for (uint32_t i = 0; i < port_count; i++)
+    {
+        SWSS_LOG_DEBUG("create port index %u", i);
+
+        uint32_t speed = SAI_VPP_DEFAULT_PORT_SPEED;
+        uint32_t queues = SAI_VPP_MIN_PORT_QUEUES;
+
+        if (!hwifs.at(i).empty())
+        {
+            auto it = m_hwif_info.find(hwifs.at(i));
+
+            if (it != m_hwif_info.end())
+            {
+                if (it->second.m_speed)
+                {
+                    speed = it->second.m_speed;
+                }
+
+                queues = std::max(queues, it->second.m_queues);
+            }
+            else
+            {
+                SWSS_LOG_WARN("port index %u: VPP interface %s not found, using defaults",
+                        i, hwifs.at(i).c_str());
+            }
+        }
+
+        std::vector<uint32_t> lanes = lanesVector.at(i);
+
+        // all port attributes are set on create, no follow up set calls
+
+        sai_attribute_t attrs[7];
+
+        attrs[0].id = SAI_PORT_ATTR_ADMIN_STATE;
+        attrs[0].value.booldata = false;     /* default admin state is down as defined in SAI */
+
+        attrs[1].id = SAI_PORT_ATTR_MTU;
+        attrs[1].value.u32 = 1514;     /* default MTU is 1514 as defined in SAI */
+
+        attrs[2].id = SAI_PORT_ATTR_SPEED;
+        attrs[2].value.u32 = speed;
+
+        attrs[3].id = SAI_PORT_ATTR_HW_LANE_LIST;
+        attrs[3].value.u32list.count = (uint32_t)lanes.size();
+        attrs[3].value.u32list.list = lanes.data();
+
+        attrs[4].id = SAI_PORT_ATTR_TYPE;
+        attrs[4].value.s32 = SAI_PORT_TYPE_LOGICAL;
+
+        attrs[5].id = SAI_PORT_ATTR_OPER_STATUS;
+        attrs[5].value.s32 = SAI_PORT_OPER_STATUS_DOWN;
+
+        attrs[6].id = SAI_PORT_ATTR_PORT_VLAN_ID;
+        attrs[6].value.u32 = DEFAULT_VLAN_NUMBER;
+
+        sai_object_id_t port_id;
+
+        CHECK_STATUS(create(SAI_OBJECT_TYPE_PORT, &port_id, m_switch_id, 7, attrs));
+
+        m_port_list.push_back(port_id);
+
+        m_port_queues_count[port_id] = queues;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchVPP::create_qos_queues_per_port(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    // VPP has no separate multicast queues, only unicast are created
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    add_port_queues_attrs(port_id, SAI_QUEUE_TYPE_UNICAST, get_port_queues_count(port_id), attr_lists);
+
+    std::vector<sai_object_id_t> queues;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_QUEUE, attr_lists, queues));
+
+    return set_port_queues(port_id, queues.data(), (uint32_t)queues.size());
+}
+
+sai_status_t SwitchVPP::create_cpu_qos_queues(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    // CPU queues are of type multicast queues
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    add_port_queues_attrs(port_id, SAI_QUEUE_TYPE_MULTICAST, SAI_VPP_CPU_QUEUES, attr_lists);
+
+    std::vector<sai_object_id_t> queues;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_QUEUE, attr_lists, queues));
+
+    return set_port_queues(port_id, queues.data(), (uint32_t)queues.size());
+}
+
+sai_status_t SwitchVPP::create_qos_queues()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("create qos queues");
+
+    // queues of all ports are built in one pass
+
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    for (auto &port_id: m_port_list)
+    {
+        add_port_queues_attrs(port_id, SAI_QUEUE_TYPE_UNICAST, get_port_queues_count(port_id), attr_lists);
+    }
+
+    std::vector<sai_object_id_t> queues;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_QUEUE, attr_lists, queues));
+
+    size_t offset = 0;
+
+    for (auto &port_id: m_port_list)
+    {
+        uint32_t count = get_port_queues_count(port_id);
+
+        CHECK_STATUS(set_port_queues(port_id, queues.data() + offset, count));
+
+        offset += count;
+    }
+
+    CHECK_STATUS(create_cpu_qos_queues(m_cpu_port_id));
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchVPP::create_port_serdes()
+{
+    SWSS_LOG_ENTER();
+
+    // VPP interfaces don't expose serdes, no objects are created
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchVPP::create_port_serdes_per_port(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchVPP::create_scheduler_group_tree(
+        _In_ const std::vector<sai_object_id_t>& sgs,
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    // single level tree, all port queues are children of the port
+    // scheduler group, matching VPP's one tx scheduler per interface
+
+    uint32_t queues_count = get_port_queues_count(port_id);
+
+    std::vector<sai_object_id_t> queues(queues_count);
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
+    attr.value.objlist.count = queues_count;
+    attr.value.objlist.list = queues.data();
+
+    CHECK_STATUS(get(SAI_OBJECT_TYPE_PORT, port_id, 1, &attr));
+
+    queues.resize(attr.value.objlist.count);
+
+    sai_object_id_t sg_0 = sgs.at(0);
+
+    attr.id = SAI_SCHEDULER_GROUP_ATTR_CHILD_COUNT;
+    attr.value.u32 = (uint32_t)queues.size();
+
+    CHECK_STATUS(set(SAI_OBJECT_TYPE_SCHEDULER_GROUP, sg_0, &attr));
+
+    attr.id = SAI_SCHEDULER_GROUP_ATTR_CHILD_LIST;
+    attr.value.objlist.count = (uint32_t)queues.size();
+    attr.value.objlist.list = queues.data();
+
+    return set(SAI_OBJECT_TYPE_SCHEDULER_GROUP, sg_0, &attr);
+}
+
+sai_status_t SwitchVPP::create_scheduler_groups_per_port(
+        _In_ sai_object_id_t port_id)
+{
+    SWSS_LOG_ENTER();
+
+    const uint32_t port_sgs_count = 1;
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_SCHEDULER_GROUP_ATTR_PORT_ID;
+    attr.value.oid = port_id;
+
+    std::vector<sai_object_id_t> sgs(port_sgs_count);
+
+    CHECK_STATUS(create(SAI_OBJECT_TYPE_SCHEDULER_GROUP, &sgs[0], m_switch_id, 1, &attr));
+
+    attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_SCHEDULER_GROUPS;
+    attr.value.u32 = port_sgs_count;
+
+    CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+
+    attr.id = SAI_PORT_ATTR_QOS_SCHEDULER_GROUP_LIST;
+    attr.value.objlist.count = port_sgs_count;
+    attr.value.objlist.list = sgs.data();
+
+    CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+
+    return create_scheduler_group_tree(sgs, port_id);
+}
+
+sai_status_t SwitchVPP::create_scheduler_groups()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("create scheduler groups");
+
+    // one scheduler group per port, built in one pass
+
+    std::vector<std::vector<sai_attribute_t>> attr_lists;
+
+    for (auto &port_id: m_port_list)
+    {
+        std::vector<sai_attribute_t> attrs(1);
+
+        attrs[0].id = SAI_SCHEDULER_GROUP_ATTR_PORT_ID;
+        attrs[0].value.oid = port_id;
+
+        attr_lists.push_back(attrs);
+    }
+
+    std::vector<sai_object_id_t> sgs;
+
+    CHECK_STATUS(create_objects(SAI_OBJECT_TYPE_SCHEDULER_GROUP, attr_lists, sgs));
+
+    for (size_t idx = 0; idx < m_port_list.size(); idx++)
+    {
+        sai_object_id_t port_id = m_port_list[idx];
+
+        sai_attribute_t attr;
+
+        attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_SCHEDULER_GROUPS;
+        attr.value.u32 = 1;
+
+        CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+
+        attr.id = SAI_PORT_ATTR_QOS_SCHEDULER_GROUP_LIST;
+        attr.value.objlist.count = 1;
+        attr.value.objlist.list = &sgs[idx];
+
+        CHECK_STATUS(set(SAI_OBJECT_TYPE_PORT, port_id, &attr));
+
+        CHECK_STATUS(create_scheduler_group_tree({ sgs[idx] }, port_id));
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t SwitchVPP::set_maximum_number_of_childs_per_scheduler_group()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("set maximum number of childs per scheduler group");
+
+    uint32_t max_childs = SAI_VPP_MIN_PORT_QUEUES;
+
+    for (const auto &kvp: m_port_queues_count)
+    {
+        max_childs = std::max(max_childs, kvp.second);
+    }
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_SWITCH_ATTR_QOS_MAX_NUMBER_OF_CHILDS_PER_SCHEDULER_GROUP;
+    attr.value.u32 = max_childs;
+
+    return set(SAI_OBJECT_TYPE_SWITCH, m_switch_id, &attr);
+}
+
+sai_status_t SwitchVPP::refresh_bridge_port_list(
+        _In_ const sai_attr_metadata_t *meta,
+        _In_ sai_object_id_t bridge_id)
+{
+    SWSS_LOG_ENTER();
+
+    // XXX possible issues with vxlan and lag.
+
+    /*
+     * Bridge ports are indexed on create in port id order, bridge ports of
+     * type PORT missing BRIDGE_ID are put on the default 1Q bridge.
+     */
+
+    std::vector<sai_object_id_t> bridge_port_list;
+
+    if (!m_bridgePortIndex.fetchChanged(bridge_id, bridge_port_list))
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    uint32_t bridge_port_list_count = (uint32_t)bridge_port_list.size();
+
+    SWSS_LOG_NOTICE("recalculated %s: %u", meta->attridname, bridge_port_list_count);
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_BRIDGE_ATTR_PORT_LIST;
+    attr.value.objlist.count = bridge_port_list_count;
+    attr.value.objlist.list = bridge_port_list.data();
+
+    return set(SAI_OBJECT_TYPE_BRIDGE, bridge_id, &attr);
+}
+
+sai_status_t SwitchVPP::warm_update_queues()
+{
+    SWSS_LOG_ENTER();
+
+    for (auto port: m_port_list)
+    {
+        sai_attribute_t attr;
+
+        std::vector<sai_object_id_t> list(MAX_OBJLIST_LEN);
+
+        // get all queues list on current port
+
+        attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
+
+        attr.value.objlist.count = MAX_OBJLIST_LEN;
+        attr.value.objlist.list = list.data();
+
+        CHECK_STATUS(get(SAI_OBJECT_TYPE_PORT, port , 1, &attr));
+
+        list.resize(attr.value.objlist.count);
+
+        m_port_queues_count[port] = (uint32_t)list.size();
+
+        uint8_t index = 0;
+
+        for (auto queue: list)
+        {
+            attr.id = SAI_QUEUE_ATTR_PORT;
+
+            if (get(SAI_OBJECT_TYPE_QUEUE, queue, 1, &attr) != SAI_STATUS_SUCCESS)
+            {
+                attr.value.oid = port;
+
+                CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue, &attr));
+            }
+
+            attr.id = SAI_QUEUE_ATTR_INDEX;
+
+            if (get(SAI_OBJECT_TYPE_QUEUE, queue, 1, &attr) != SAI_STATUS_SUCCESS)
+            {
+                attr.value.u8 = index; // warn, we are guessing index here if it was not defined
+
+                CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue, &attr));
+            }
+
+            attr.id = SAI_QUEUE_ATTR_TYPE;
+
+            if (get(SAI_OBJECT_TYPE_QUEUE, queue, 1, &attr) != SAI_STATUS_SUCCESS)
+            {
+                attr.value.s32 = SAI_QUEUE_TYPE_UNICAST;
+
+                CHECK_STATUS(set(SAI_OBJECT_TYPE_QUEUE, queue, &attr));
+            }
+
+            index++;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
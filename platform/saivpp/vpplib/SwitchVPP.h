@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "SwitchStateBase.h"
+
+namespace saivpp
+{
+    /**
+     * @brief Switch profile backed by the VPP dataplane.
+     *
+     * Instead of emulating a fixed ASIC, ports are sized from the hardware
+     * interfaces VPP reports at init (speed and queues), and each default
+     * object is created with its full attribute list in a single call.
+     */
+    class SwitchVPP:
+        public SwitchStateBase
+    {
+        public:
+
+            SwitchVPP(
+                    _In_ sai_object_id_t switch_id,
+                    _In_ std::shared_ptr<RealObjectIdManager> manager,
+                    _In_ std::shared_ptr<SwitchConfig> config);
+
+            SwitchVPP(
+                    _In_ sai_object_id_t switch_id,
+                    _In_ std::shared_ptr<RealObjectIdManager> manager,
+                    _In_ std::shared_ptr<SwitchConfig> config,
+                    _In_ std::shared_ptr<WarmBootState> warmBootState);
+
+            virtual ~SwitchVPP() = default;
+
+        public:
+
+            /**
+             * @brief VPP hardware interface of the port on the given lanes.
+             *
+             * The port name comes from the lane map and is looked up in the
+             * SONiC to VPP interface map, so ports are paired by name and
+             * not by their position in either file.
+             *
+             * @return VPP interface name or empty string if not mapped.
+             */
+            static std::string get_lanes_hwif_name(
+                    _In_ const LaneMap& laneMap,
+                    _In_ const std::map<std::string, std::string>& hostifHwifMap,
+                    _In_ const std::vector<uint32_t>& lanes);
+
+        protected:
+
+            virtual sai_status_t create_ports() override;
+
+            virtual sai_status_t create_cpu_qos_queues(
+                    _In_ sai_object_id_t port_id) override;
+
+            virtual sai_status_t create_qos_queues_per_port(
+                    _In_ sai_object_id_t port_id) override;
+
+            virtual sai_status_t create_qos_queues() override;
+
+            virtual sai_status_t create_scheduler_group_tree(
+                    _In_ const std::vector<sai_object_id_t>& sgs,
+                    _In_ sai_object_id_t port_id) override;
+
+            virtual sai_status_t create_scheduler_groups_per_port(
+                    _In_ sai_object_id_t port_id) override;
+
+            virtual sai_status_t create_scheduler_groups() override;
+
+            virtual sai_status_t set_maximum_number_of_childs_per_scheduler_group() override;
+
+            virtual sai_status_t refresh_bridge_port_list(
+                    _In_ const sai_attr_metadata_t *meta,
+                    _In_ sai_object_id_t bridge_id) override;
+
+            virtual sai_status_t warm_update_queues() override;
+
+            virtual sai_status_t create_port_serdes() override;
+
+            virtual sai_status_t create_port_serdes_per_port(
+                    _In_ sai_object_id_t port_id) override;
+
+        private:
+
+            struct HwIfInfo
+            {
+                std::string m_name;
+
+                uint32_t m_speed; // Mbps
+
+                uint32_t m_queues;
+            };
+
+            void discover_hw_interfaces();
+
+            uint32_t get_port_queues_count(
+                    _In_ sai_object_id_t port_id) const;
+
+            void add_port_queues_attrs(
+                    _In_ sai_object_id_t port_id,
+                    _In_ sai_queue_type_t queue_type,
+                    _In_ uint32_t queues_count,
+                    _Inout_ std::vector<std::vector<sai_attribute_t>>& attr_lists) const;
+
+            sai_status_t set_port_queues(
+                    _In_ sai_object_id_t port_id,
+                    _In_ sai_object_id_t *queues,
+                    _In_ uint32_t queues_count);
+
+        private:
+
+            /*
+             * VPP hardware interfaces discovered at init, by VPP name.
+             */
+            std::map<std::string, HwIfInfo> m_hwif_info;
+
+            /*
+             * Number of unicast queues created for each port.
+             */
+            std::map<sai_object_id_t, uint32_t> m_port_queues_count;
+    };
+}
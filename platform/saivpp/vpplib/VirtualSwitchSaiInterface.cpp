@@ -30,14 +30,9 @@
 #include "SwitchBCM56850.h"
 #include "SwitchBCM56971B0.h"
 #include "SwitchMLNX2700.h"
+#include "SwitchVPP.h"
 
 #include <inttypes.h>
-#include "vppxlate/SaiIntfStats.h"
-
-/*
- * Max number of counters used in 1 api call
- */
-#define VPP_MAX_COUNTERS 128
 
 #define MAX_HARDWARE_INFO_LENGTH 0x1000
 
@@ -50,15 +45,7 @@ bool VirtualSwitchSaiInterface::port_to_hostif_list(sai_object_id_t port_id, std
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t switch_id = switchIdQuery(port_id);
-    if (switch_id == SAI_NULL_OBJECT_ID) {
-	return false;
-    }
-    auto it = m_switchStateMap.find(switch_id);
-    if (it == m_switchStateMap.end()) {
-	return false;
-    }
-    auto sw = it->second;
+    auto sw = trySelectSwitchState(switchIdQuery(port_id));
     if (sw == nullptr) {
 	return false;
     }
@@ -69,15 +56,7 @@ bool VirtualSwitchSaiInterface::port_to_hwifname(sai_object_id_t port_id, std::s
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t switch_id = switchIdQuery(port_id);
-    if (switch_id == SAI_NULL_OBJECT_ID) {
-	return false;
-    }
-    auto it = m_switchStateMap.find(switch_id);
-    if (it == m_switchStateMap.end()) {
-	return false;
-    }
-    auto sw = it->second;
+    auto sw = trySelectSwitchState(switchIdQuery(port_id));
     if (sw == nullptr) {
 	return false;
     }
@@ -86,33 +65,112 @@ bool VirtualSwitchSaiInterface::port_to_hwifname(sai_object_id_t port_id, std::s
 
 void VirtualSwitchSaiInterface::setPortStats(sai_object_id_t oid)
 {
-    std::map<sai_stat_id_t, uint64_t> stats;
+    SWSS_LOG_ENTER();
+
+    auto sw = trySelectSwitchState(switchIdQuery(oid));
+    if (sw == nullptr) {
+	return;
+    }
+    sw->setPortStats(oid);
+}
+
+void VirtualSwitchSaiInterface::setCounterStats(sai_object_id_t oid)
+{
+    SWSS_LOG_ENTER();
+
+    auto sw = trySelectSwitchState(switchIdQuery(oid));
+    if (sw == nullptr) {
+	return;
+    }
+    sw->setRouteCounterStats(oid);
+}
+
+void VirtualSwitchSaiInterface::setSwitchStats(sai_object_id_t oid)
+{
+    SWSS_LOG_ENTER();
 
-    std::string if_name;
-    if (port_to_hwifname(oid, if_name) == false) {
+    auto sw = trySelectSwitchState(oid);
+    if (sw == nullptr) {
 	return;
     }
+    sw->setSwitchStats(oid);
+}
+
+void VirtualSwitchSaiInterface::collectPortCounters(
+        _Inout_ std::vector<CounterStream::ObjectCounters>& counters)
+{
+    SWSS_LOG_ENTER();
 
-    vpp_interface_stats_t port_stats;
+    for (auto& it: m_switchStateMap)
+    {
+        auto sw = trySelectSwitchState(it.first);
 
-    if (vpp_intf_stats_query(if_name.c_str(), &port_stats) == 0) {
-	stats[SAI_PORT_STAT_IF_IN_OCTETS] = port_stats.rx_bytes;
-	stats[SAI_PORT_STAT_IF_IN_UCAST_PKTS] = port_stats.rx;
-	stats[SAI_PORT_STAT_IF_IN_BROADCAST_PKTS] = port_stats.rx_broadcast;
-	stats[SAI_PORT_STAT_IF_IN_MULTICAST_PKTS] = port_stats.rx_multicast;
-	stats[SAI_PORT_STAT_IF_IN_DISCARDS] = port_stats.drops;
-	stats[SAI_PORT_STAT_IF_OUT_OCTETS] = port_stats.tx_bytes;
-	stats[SAI_PORT_STAT_IF_OUT_UCAST_PKTS] = port_stats.tx;
-	stats[SAI_PORT_STAT_IF_OUT_BROADCAST_PKTS] = port_stats.tx_broadcast;
-	stats[SAI_PORT_STAT_IF_OUT_MULTICAST_PKTS] = port_stats.tx_multicast;
+        if (sw == nullptr)
+            continue;
 
-	stats[SAI_PORT_STAT_IN_DROPPED_PKTS] = port_stats.rx_no_buf;
-	stats[SAI_PORT_STAT_IF_IN_ERRORS] = port_stats.rx_error;
-	stats[SAI_PORT_STAT_IF_OUT_ERRORS] = port_stats.tx_error;
-	stats[SAI_PORT_STAT_IP_IN_RECEIVES] = port_stats.ip4;
-	stats[SAI_PORT_STAT_IPV6_IN_RECEIVES] = port_stats.ip6;
+        sw->collectPortCounters(counters);
     }
-    debugSetStats(oid, stats);
+}
+
+sai_status_t VirtualSwitchSaiInterface::sendHostifPacket(
+        _In_ sai_object_id_t hostifId,
+        _In_ sai_size_t bufferSize,
+        _In_ const void *buffer,
+        _In_ uint32_t attrCount,
+        _In_ const sai_attribute_t *attrList)
+{
+    SWSS_LOG_ENTER();
+
+    // switch of the host interface, or of the egress port
+
+    sai_object_id_t switchId = SAI_NULL_OBJECT_ID;
+
+    if (hostifId != SAI_NULL_OBJECT_ID)
+    {
+        if (objectTypeQuery(hostifId) != SAI_OBJECT_TYPE_HOSTIF)
+        {
+            SWSS_LOG_ERROR("%s is not a host interface", sai_serialize_object_id(hostifId).c_str());
+
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+
+        switchId = switchIdQuery(hostifId);
+    }
+    else
+    {
+        auto attr = sai_metadata_get_attr_by_id(SAI_HOSTIF_PACKET_ATTR_EGRESS_PORT_OR_LAG, attrCount, attrList);
+
+        if (attr)
+        {
+            switchId = switchIdQuery(attr->value.oid);
+        }
+        else if (m_switchStateMap.size() == 1)
+        {
+            switchId = m_switchStateMap.begin()->first;
+        }
+    }
+
+    auto sw = trySelectSwitchState(switchId);
+
+    if (sw == nullptr)
+    {
+        SWSS_LOG_ERROR("no switch to send the packet on");
+
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return sw->sendHostifPacket(hostifId, bufferSize, buffer, attrCount, attrList);
+}
+
+void VirtualSwitchSaiInterface::setMACsecStats(sai_object_type_t object_type, sai_object_id_t oid)
+{
+    SWSS_LOG_ENTER();
+
+    auto sw = trySelectSwitchState(switchIdQuery(oid));
+    if (sw == nullptr) {
+	return;
+    }
+    sw->setMACsecStats(object_type, oid);
 }
 
 VirtualSwitchSaiInterface::VirtualSwitchSaiInterface(
@@ -239,7 +297,14 @@ void VirtualSwitchSaiInterface::update_local_metadata(
      * called, we could check the actual state.
      */
 
-    const auto &objectHash = m_switchStateMap.at(switch_id)->m_objectHash;//.at(object_type);
+    auto ss = findSwitchState(switch_id);
+
+    if (!ss)
+    {
+        return;
+    }
+
+    const auto &objectHash = ss->m_objectHash;//.at(object_type);
 
     // first create switch
     // first we need to create all "oid" objects to have reference base
@@ -588,6 +653,11 @@ std::shared_ptr<SwitchStateBase> VirtualSwitchSaiInterface::init_switch(
 
             break;
 
+        case SAI_VPP_SWITCH_TYPE_VPP:
+
+            m_switchStateMap[switch_id] = std::make_shared<SwitchVPP>(switch_id, m_realObjectIdManager, config, warmBootState);
+            break;
+
         default:
 
             SWSS_LOG_WARN("unknown switch type: %d", config->m_switchType);
@@ -595,7 +665,7 @@ std::shared_ptr<SwitchStateBase> VirtualSwitchSaiInterface::init_switch(
             return nullptr;
     }
 
-    auto ss = m_switchStateMap.at(switch_id);
+    auto ss = selectSwitchState(switch_id);
 
     ss->setMeta(meta);
 
@@ -691,7 +761,7 @@ sai_status_t VirtualSwitchSaiInterface::create(
         }
     }
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->create(object_type, serializedObjectId, switchId, attr_count, attr_list);
 }
@@ -718,7 +788,7 @@ sai_status_t VirtualSwitchSaiInterface::remove(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     // Perform db dump if warm restart was requested.
 
@@ -774,7 +844,7 @@ sai_status_t VirtualSwitchSaiInterface::set(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->set(objectType, serializedObjectId, attr);
 }
@@ -788,7 +858,7 @@ sai_status_t VirtualSwitchSaiInterface::get(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->get(objectType, serializedObjectId, attr_count, attr_list);
 }
@@ -929,7 +999,7 @@ sai_status_t VirtualSwitchSaiInterface::queryAattributeEnumValuesCapability(
 
         return SAI_STATUS_SUCCESS;
     }
-    auto ss = m_switchStateMap.at(switch_id);
+    auto ss = selectSwitchState(switch_id);
     return ss->queryAttrEnumValuesCapability(switch_id, object_type, attr_id, enum_values_capability);
 
 }
@@ -943,9 +1013,6 @@ sai_status_t VirtualSwitchSaiInterface::getStats(
 {
     SWSS_LOG_ENTER();
 
-    if (object_type == SAI_OBJECT_TYPE_PORT) {
-	setPortStats(object_id);
-    }
     /*
      * Get stats is the same as get stats ext with mode == SAI_STATS_MODE_READ.
      */
@@ -973,7 +1040,7 @@ sai_status_t VirtualSwitchSaiInterface::queryStatsCapability(
         return SAI_STATUS_FAILURE;
     }
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->queryStatsCapability(
             switchId,
@@ -991,22 +1058,13 @@ sai_status_t VirtualSwitchSaiInterface::getStatsExt(
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t switch_id = SAI_NULL_OBJECT_ID;
-
     if (m_switchStateMap.size() == 0)
     {
         SWSS_LOG_ERROR("no switch!, was removed but some function still call");
         return SAI_STATUS_FAILURE;
     }
 
-    if (m_switchStateMap.size() == 1)
-    {
-        switch_id = m_switchStateMap.begin()->first;
-    }
-    else
-    {
-        SWSS_LOG_THROW("multiple switches not supported, FIXME");
-    }
+    sai_object_id_t switch_id = switchIdQuery(object_id);
 
     if (m_switchStateMap.find(switch_id) == m_switchStateMap.end())
     {
@@ -1015,7 +1073,19 @@ sai_status_t VirtualSwitchSaiInterface::getStatsExt(
         return SAI_STATUS_FAILURE;
     }
 
-    auto ss = m_switchStateMap.at(switch_id);
+    // refresh from VPP first, so a clear takes the current value as baseline
+
+    if (object_type == SAI_OBJECT_TYPE_PORT) {
+	setPortStats(object_id);
+    } else if (object_type == SAI_OBJECT_TYPE_COUNTER) {
+	setCounterStats(object_id);
+    } else if (object_type == SAI_OBJECT_TYPE_SWITCH) {
+	setSwitchStats(object_id);
+    } else if (object_type == SAI_OBJECT_TYPE_MACSEC_SA || object_type == SAI_OBJECT_TYPE_MACSEC_SC) {
+	setMACsecStats(object_type, object_id);
+    }
+
+    auto ss = selectSwitchState(switch_id);
 
     return ss->getStatsExt(
             object_type,
@@ -1040,7 +1110,7 @@ sai_status_t VirtualSwitchSaiInterface::clearStats(
      * discard them, in that way.
      */
 
-    uint64_t counters[VPP_MAX_COUNTERS];
+    std::vector<uint64_t> counters(number_of_counters);
 
     return getStatsExt(
             object_type,
@@ -1048,7 +1118,7 @@ sai_status_t VirtualSwitchSaiInterface::clearStats(
             number_of_counters,
             counter_ids,
             SAI_STATS_MODE_READ_AND_CLEAR,
-            counters);
+            counters.data());
 }
 
 sai_status_t VirtualSwitchSaiInterface::bulkGetStats(
@@ -1064,7 +1134,25 @@ sai_status_t VirtualSwitchSaiInterface::bulkGetStats(
 {
     SWSS_LOG_ENTER();
 
-    return SAI_STATUS_NOT_IMPLEMENTED;
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    for (uint32_t idx = 0; idx < object_count; idx++)
+    {
+        object_statuses[idx] = getStatsExt(
+                object_type,
+                object_key[idx].key.object_id,
+                number_of_counters,
+                counter_ids,
+                mode,
+                &counters[(size_t)idx * number_of_counters]);
+
+        if (object_statuses[idx] != SAI_STATUS_SUCCESS)
+        {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    return status;
 }
 
 sai_status_t VirtualSwitchSaiInterface::bulkClearStats(
@@ -1079,7 +1167,23 @@ sai_status_t VirtualSwitchSaiInterface::bulkClearStats(
 {
     SWSS_LOG_ENTER();
 
-    return SAI_STATUS_NOT_IMPLEMENTED;
+    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    for (uint32_t idx = 0; idx < object_count; idx++)
+    {
+        object_statuses[idx] = clearStats(
+                object_type,
+                object_key[idx].key.object_id,
+                number_of_counters,
+                counter_ids);
+
+        if (object_statuses[idx] != SAI_STATUS_SUCCESS)
+        {
+            status = SAI_STATUS_FAILURE;
+        }
+    }
+
+    return status;
 }
 
 sai_status_t VirtualSwitchSaiInterface::bulkRemove(
@@ -1091,7 +1195,7 @@ sai_status_t VirtualSwitchSaiInterface::bulkRemove(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->bulkRemove(object_type, serialized_object_ids, mode, object_statuses);
 }
@@ -1371,7 +1475,7 @@ sai_status_t VirtualSwitchSaiInterface::bulkSet(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->bulkSet(object_type, serialized_object_ids, attr_list, mode, object_statuses);
 }
@@ -1418,7 +1522,7 @@ sai_status_t VirtualSwitchSaiInterface::bulkCreate(
 {
     SWSS_LOG_ENTER();
 
-    auto ss = m_switchStateMap.at(switchId);
+    auto ss = selectSwitchState(switchId);
 
     return ss->bulkCreate(switchId, object_type, serialized_object_ids, attr_count, attr_list, mode, object_statuses);;
 }
@@ -1613,6 +1717,67 @@ sai_object_id_t VirtualSwitchSaiInterface::switchIdQuery(
     return m_realObjectIdManager->saiSwitchIdQuery(objectId);
 }
 
+std::shared_ptr<SwitchStateBase> VirtualSwitchSaiInterface::findSwitchState(
+        _In_ sai_object_id_t switchId)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_switchStateMap.find(switchId);
+
+    if (it == m_switchStateMap.end())
+    {
+        SWSS_LOG_ERROR("failed to find switch %s in switch state map",
+                sai_serialize_object_id(switchId).c_str());
+
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+std::shared_ptr<SwitchStateBase> VirtualSwitchSaiInterface::selectSwitchState(
+        _In_ sai_object_id_t switchId)
+{
+    SWSS_LOG_ENTER();
+
+    auto ss = m_switchStateMap.at(switchId);
+
+    activateSwitchState(ss);
+
+    return ss;
+}
+
+std::shared_ptr<SwitchStateBase> VirtualSwitchSaiInterface::trySelectSwitchState(
+        _In_ sai_object_id_t switchId)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_switchStateMap.find(switchId);
+
+    if (it == m_switchStateMap.end() || it->second == nullptr)
+    {
+        return nullptr;
+    }
+
+    activateSwitchState(it->second);
+
+    return it->second;
+}
+
+void VirtualSwitchSaiInterface::activateSwitchState(
+        _In_ const std::shared_ptr<SwitchStateBase>& ss)
+{
+    SWSS_LOG_ENTER();
+
+    // each switch may be backed by its own VPP instance
+
+    if (ss->vpp_client_activate() != 0)
+    {
+        SWSS_LOG_ERROR("failed to select VPP instance of switch %s",
+                sai_serialize_object_id(ss->getSwitchId()).c_str());
+    }
+}
+
 sai_status_t VirtualSwitchSaiInterface::logSet(
         _In_ sai_api_t api,
         _In_ sai_log_level_t log_level)
@@ -1733,6 +1898,32 @@ bool VirtualSwitchSaiInterface::readWarmBootFile(
             continue;
         }
 
+        if (strObjectType == SAI_VPP_STATS_BASELINE)
+        {
+            sai_object_id_t oid;
+            sai_stat_id_t statId;
+            uint64_t baseline;
+
+            sai_deserialize_object_id(strObjectId, oid);
+
+            iss >> statId >> baseline;
+
+            auto switchId = switchIdQuery(oid);
+
+            if (switchId == SAI_NULL_OBJECT_ID || iss.fail())
+            {
+                SWSS_LOG_WARN("skipping invalid counter baseline: %s", line.c_str());
+
+                continue;
+            }
+
+            m_warmBootState[switchId].m_switchId = switchId;
+
+            m_warmBootState[switchId].m_statsBaselines.emplace_back(oid, statId, baseline);
+
+            continue;
+        }
+
         iss >> strAttrId >> strAttrValue;
 
         sai_object_meta_key_t metaKey;
@@ -1858,6 +2049,8 @@ void VirtualSwitchSaiInterface::syncProcessEventPacket(
 
     auto& buffer = payload->getBuffer();
 
+    activateSwitchState(it->second);
+
     it->second->process_packet_for_fdb_event(
             port,
             payload->getIfName(),
@@ -1882,5 +2075,7 @@ void VirtualSwitchSaiInterface::syncProcessEventNetLinkMsg(
         return;
     }
 
+    activateSwitchState(it->second);
+
     it->second->syncOnLinkMsg(payload);
 }
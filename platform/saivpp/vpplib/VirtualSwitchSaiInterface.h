@@ -259,6 +259,9 @@ namespace saivpp
                     _In_ sai_object_id_t objectId,
                     _In_ const sai_attribute_t *attr);
             void setPortStats(sai_object_id_t oid);
+            void setCounterStats(sai_object_id_t oid);
+            void setSwitchStats(sai_object_id_t oid);
+            void setMACsecStats(sai_object_type_t object_type, sai_object_id_t oid);
 	    bool port_to_hostif_list(sai_object_id_t oid, std::string& if_name);
       	    bool port_to_hwifname(sai_object_id_t oid, std::string& if_name);
 
@@ -309,6 +312,16 @@ namespace saivpp
 
             void ageFdbs();
 
+            void collectPortCounters(
+                    _Inout_ std::vector<CounterStream::ObjectCounters>& counters);
+
+            sai_status_t sendHostifPacket(
+                    _In_ sai_object_id_t hostifId,
+                    _In_ sai_size_t bufferSize,
+                    _In_ const void *buffer,
+                    _In_ uint32_t attrCount,
+                    _In_ const sai_attribute_t *attrList);
+
             void debugSetStats(
                     _In_ sai_object_id_t oid,
                     _In_ const std::map<sai_stat_id_t, uint64_t>& stats);
@@ -333,5 +346,31 @@ namespace saivpp
             std::shared_ptr<RealObjectIdManager> m_realObjectIdManager;
 
             SwitchStateBase::SwitchStateMap m_switchStateMap;
+
+        private:
+
+            /**
+             * @brief Returns switch state, or nullptr if switch doesn't exist.
+             */
+            std::shared_ptr<SwitchStateBase> findSwitchState(
+                    _In_ sai_object_id_t switchId);
+
+            /**
+             * @brief Returns switch state and selects its VPP instance.
+             *
+             * Throws if switch doesn't exist.
+             */
+            std::shared_ptr<SwitchStateBase> selectSwitchState(
+                    _In_ sai_object_id_t switchId);
+
+            /**
+             * @brief Returns switch state and selects its VPP instance, or
+             * nullptr if switch doesn't exist.
+             */
+            std::shared_ptr<SwitchStateBase> trySelectSwitchState(
+                    _In_ sai_object_id_t switchId);
+
+            void activateSwitchState(
+                    _In_ const std::shared_ptr<SwitchStateBase>& ss);
     };
 }
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VppStatsSnapshot.h"
+
+#include "swss/logger.h"
+
+#include <cstring>
+#include <inttypes.h>
+
+// VPP interface counters, as /interfaces/<interface>/<counter>
+#define SAI_VPP_IF_STATS_DIR "/interfaces/"
+
+// DPDK extended stats of the device, as /if/xstats/<interface>/<xstat>
+#define SAI_VPP_XSTATS_DIR "/if/xstats/"
+
+// FIB entry counters by load balance index
+#define SAI_VPP_ROUTE_STATS_PATH "/net/route/to"
+
+using namespace saivpp;
+
+namespace
+{
+    /*
+     * Splits /<dir>/<interface>/<counter> after prefix, interface names may
+     * contain '/' so the counter is what follows the last one.
+     */
+    bool split_stat_name(
+            _In_ const char *name,
+            _In_ const char *prefix,
+            _Out_ std::string& ifname,
+            _Out_ std::string& counter)
+    {
+        SWSS_LOG_ENTER();
+
+        size_t len = strlen(prefix);
+
+        if (strncmp(name, prefix, len) != 0)
+        {
+            return false;
+        }
+
+        const char *sep = strrchr(name + len, '/');
+
+        if (sep == NULL || sep == name + len)
+        {
+            return false;
+        }
+
+        ifname.assign(name + len, sep - (name + len));
+        counter.assign(sep + 1);
+
+        return true;
+    }
+}
+
+void VppStatsSnapshot::onCounter(
+        _In_ const char *name,
+        _In_ uint32_t index,
+        _In_ uint64_t packets,
+        _In_ uint64_t bytes,
+        _In_ int is_combined,
+        _In_ void *data)
+{
+    SWSS_LOG_ENTER();
+
+    auto *snapshot = static_cast<VppStatsSnapshot*>(data);
+
+    std::string ifname;
+    std::string counter;
+
+    if (strcmp(name, SAI_VPP_ROUTE_STATS_PATH) == 0)
+    {
+        if (index >= snapshot->m_routes.size())
+        {
+            snapshot->m_routes.resize(index + 1);
+        }
+
+        snapshot->m_routes[index].packets = packets;
+        snapshot->m_routes[index].bytes = bytes;
+    }
+    else if (split_stat_name(name, SAI_VPP_IF_STATS_DIR, ifname, counter))
+    {
+        // symlinks, one entry per counter
+
+        auto& c = snapshot->m_interfaces[ifname].m_vpp[counter];
+
+        c.packets = packets;
+        c.bytes = bytes;
+    }
+    else if (split_stat_name(name, SAI_VPP_XSTATS_DIR, ifname, counter))
+    {
+        snapshot->m_interfaces[ifname].m_xstats[counter] = packets;
+    }
+}
+
+std::shared_ptr<const VppStatsSnapshot> VppStatsSnapshot::take(
+        _In_ bool withRoutes)
+{
+    SWSS_LOG_ENTER();
+
+    auto snapshot = std::make_shared<VppStatsSnapshot>();
+
+    const char *paths[] = {
+        "^" SAI_VPP_IF_STATS_DIR,
+        "^" SAI_VPP_XSTATS_DIR,
+        "^" SAI_VPP_ROUTE_STATS_PATH "$"
+    };
+
+    uint32_t count = withRoutes ? 3 : 2;
+
+    if (vpp_stats_snapshot(paths, count, onCounter, snapshot.get(), &snapshot->m_epoch) != 0)
+    {
+        SWSS_LOG_WARN("failed to read a consistent VPP stats snapshot");
+
+        return nullptr;
+    }
+
+    snapshot->m_hasRoutes = withRoutes;
+    snapshot->m_time = std::chrono::steady_clock::now();
+
+    SWSS_LOG_DEBUG("VPP stats snapshot at epoch %" PRIu64 ": %zu interfaces, %zu route counters",
+            snapshot->m_epoch,
+            snapshot->m_interfaces.size(),
+            snapshot->m_routes.size());
+
+    return snapshot;
+}
+
+const VppStatsSnapshot::InterfaceCounters* VppStatsSnapshot::getInterface(
+        _In_ const std::string& ifname) const
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_interfaces.find(ifname);
+
+    return (it == m_interfaces.end()) ? nullptr : &it->second;
+}
+
+const std::unordered_map<std::string, VppStatsSnapshot::InterfaceCounters>& VppStatsSnapshot::getInterfaces() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_interfaces;
+}
+
+bool VppStatsSnapshot::hasRoutes() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_hasRoutes;
+}
+
+const std::vector<vpp_combined_counter_t>& VppStatsSnapshot::getRouteCounters() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_routes;
+}
+
+uint64_t VppStatsSnapshot::getEpoch() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_epoch;
+}
+
+std::chrono::steady_clock::time_point VppStatsSnapshot::getTime() const
+{
+    SWSS_LOG_ENTER();
+
+    return m_time;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "vppxlate/SaiVppStats.h"
+
+#include "swss/sal.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace saivpp
+{
+    /*
+     * Immutable copy of the VPP stats segment counters, read within one
+     * stat segment epoch. All counter reads of a poll cycle are served from
+     * the same snapshot, so counters of different objects are consistent
+     * with each other.
+     */
+    class VppStatsSnapshot
+    {
+        public:
+
+            typedef struct _InterfaceCounters
+            {
+                // /interfaces/<interface>/<counter>, simple counters only set packets
+                std::map<std::string, vpp_combined_counter_t> m_vpp;
+
+                // extended stats of the device by xstat name
+                std::map<std::string, uint64_t> m_xstats;
+
+            } InterfaceCounters;
+
+        public:
+
+            VppStatsSnapshot() = default;
+
+            virtual ~VppStatsSnapshot() = default;
+
+        public:
+
+            /*
+             * Reads interface counters and device xstats, and the FIB route
+             * counters if withRoutes is set. Returns nullptr on failure.
+             */
+            static std::shared_ptr<const VppStatsSnapshot> take(
+                    _In_ bool withRoutes);
+
+        public:
+
+            const InterfaceCounters* getInterface(
+                    _In_ const std::string& ifname) const;
+
+            const std::unordered_map<std::string, InterfaceCounters>& getInterfaces() const;
+
+            bool hasRoutes() const;
+
+            // /net/route/to by load balance index
+            const std::vector<vpp_combined_counter_t>& getRouteCounters() const;
+
+            uint64_t getEpoch() const;
+
+            std::chrono::steady_clock::time_point getTime() const;
+
+        private:
+
+            static void onCounter(
+                    _In_ const char *name,
+                    _In_ uint32_t index,
+                    _In_ uint64_t packets,
+                    _In_ uint64_t bytes,
+                    _In_ int is_combined,
+                    _In_ void *data);
+
+        private:
+
+            std::unordered_map<std::string, InterfaceCounters> m_interfaces;
+
+            bool m_hasRoutes = false;
+
+            std::vector<vpp_combined_counter_t> m_routes;
+
+            uint64_t m_epoch = 0;
+
+            std::chrono::steady_clock::time_point m_time;
+    };
+}
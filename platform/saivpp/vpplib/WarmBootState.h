@@ -23,6 +23,8 @@ extern "C" {
 #include "FdbInfo.h"
 
 #include <set>
+#include <tuple>
+#include <vector>
 
 namespace saivpp
 {
@@ -35,5 +37,8 @@ namespace saivpp
             std::set<FdbInfo> m_fdbInfoSet;
 
             SwitchState::ObjectHash m_objectHash;
+
+            // object, stat id, baseline
+            std::vector<std::tuple<sai_object_id_t, sai_stat_id_t, uint64_t>> m_statsBaselines;
     };
 }
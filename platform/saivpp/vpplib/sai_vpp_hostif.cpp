@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "sai_vpp.h"
+#include "Sai.h"
 
 static sai_status_t vpp_recv_hostif_packet(
         _In_ sai_object_id_t hif_id,
@@ -36,7 +37,19 @@ static sai_status_t vpp_send_hostif_packet(
 {
     SWSS_LOG_ENTER();
 
-    return SAI_STATUS_NOT_IMPLEMENTED;
+    auto sai = std::dynamic_pointer_cast<saivpp::Sai>(vpp_sai);
+
+    if (sai == nullptr)
+    {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    return sai->sendHostifPacket(
+            hif_id,
+            buffer_size,
+            buffer,
+            attr_count,
+            attr_list);
 }
 
 static sai_status_t vpp_allocate_hostif_packet(
@@ -71,6 +71,19 @@ extern "C" {
  */
 #define SAI_KEY_VPP_HOSTIF_USE_TAP_DEVICE      "SAI_VPP_HOSTIF_USE_TAP_DEVICE"
 
+/**
+ * @def SAI_KEY_VPP_HOSTIF_OFFLOAD
+ *
+ * Optional. Offloads enabled on the host TAP of a port, one of
+ * SAI_VALUE_VPP_HOSTIF_OFFLOAD_*. Default is none.
+ *
+ * With csum the kernel leaves checksums of host originated packets to VPP,
+ * with gso it also hands VPP TCP segments larger than the MTU, which VPP
+ * segments on egress. VPP negotiates the offloads with the kernel
+ * (TUNSETOFFLOAD) on every queue of the TAP, one rx queue per worker.
+ */
+#define SAI_KEY_VPP_HOSTIF_OFFLOAD             "SAI_VPP_HOSTIF_OFFLOAD"
+
 /**
  * @def SAI_KEY_VPP_CORE_PORT_INDEX_MAP_FILE
  *
@@ -84,6 +97,60 @@ extern "C" {
  */
 #define SAI_KEY_VPP_CORE_PORT_INDEX_MAP_FILE  "SAI_VPP_CORE_PORT_INDEX_MAP_FILE"
 
+/**
+ * @def SAI_KEY_VPP_API_SOCKET
+ *
+ * Optional. VPP binary API socket used by switches which do not set
+ * "vpp_api_socket" in context_config.json. Default is /run/vpp/api.sock.
+ */
+#define SAI_KEY_VPP_API_SOCKET                 "SAI_VPP_API_SOCKET"
+
+/**
+ * @def SAI_KEY_VPP_STATS_SOCKET
+ *
+ * Optional. VPP stats segment socket used by switches which do not set
+ * "vpp_stats_socket" in context_config.json. Default is /run/vpp/stats.sock.
+ */
+#define SAI_KEY_VPP_STATS_SOCKET               "SAI_VPP_STATS_SOCKET"
+
+/**
+ * @def SAI_KEY_VPP_PUNT_SOCKET
+ *
+ * Optional. VPP punt socket, "punt { socket <path> }" in the VPP startup
+ * config, used by switches which do not set "vpp_punt_socket" in
+ * context_config.json. Default is /run/vpp/punt.sock.
+ *
+ * Packets sent with sai_send_hostif_packet are injected into VPP through
+ * it, and packets of traps bound to a genetlink host interface are punted
+ * by VPP to a socket next to it.
+ */
+#define SAI_KEY_VPP_PUNT_SOCKET                "SAI_VPP_PUNT_SOCKET"
+
+/**
+ * @def SAI_KEY_VPP_COUNTER_STREAM_INTERVAL
+ *
+ * Optional. Interval in milliseconds at which port counters are written to
+ * COUNTERS_DB directly, without flex counter polling. Minimum is 100.
+ * Default is 0, streaming disabled.
+ */
+#define SAI_KEY_VPP_COUNTER_STREAM_INTERVAL    "SAI_VPP_COUNTER_STREAM_INTERVAL"
+
+/**
+ * @def SAI_KEY_VPP_COUNTER_STREAM_RATE_LIMIT
+ *
+ * Optional. Maximum number of ports written per second by counter
+ * streaming. Default is 0, unlimited.
+ */
+#define SAI_KEY_VPP_COUNTER_STREAM_RATE_LIMIT  "SAI_VPP_COUNTER_STREAM_RATE_LIMIT"
+
+/**
+ * @def SAI_KEY_VPP_COUNTER_STREAM_CPU_BUDGET
+ *
+ * Optional. Percentage of one CPU the counter streaming thread may use,
+ * cycles are spaced out when over it. Default is 10.
+ */
+#define SAI_KEY_VPP_COUNTER_STREAM_CPU_BUDGET  "SAI_VPP_COUNTER_STREAM_CPU_BUDGET"
+
 /**
  * @brief Context config.
  *
@@ -105,6 +172,7 @@ extern "C" {
 #define SAI_VALUE_VPP_SWITCH_TYPE_BCM56971B0   "SAI_VPP_SWITCH_TYPE_BCM56971B0"
 #define SAI_VALUE_VPP_SWITCH_TYPE_BCM81724     "SAI_VPP_SWITCH_TYPE_BCM81724"
 #define SAI_VALUE_VPP_SWITCH_TYPE_MLNX2700     "SAI_VPP_SWITCH_TYPE_MLNX2700"
+#define SAI_VALUE_VPP_SWITCH_TYPE_VPP          "SAI_VPP_SWITCH_TYPE_VPP"
 
 /*
  * Values for SAI_KEY_BOOT_TYPE (defined in saiswitch.h)
@@ -114,6 +182,10 @@ extern "C" {
 #define SAI_VALUE_VPP_BOOT_TYPE_WARM "1"
 #define SAI_VALUE_VPP_BOOT_TYPE_FAST "2"
 
+#define SAI_VALUE_VPP_HOSTIF_OFFLOAD_NONE      "none"
+#define SAI_VALUE_VPP_HOSTIF_OFFLOAD_CSUM      "csum"
+#define SAI_VALUE_VPP_HOSTIF_OFFLOAD_GSO       "gso"
+
 /**
  * @def SAI_VPP_UNITTEST_CHANNEL
  *
@@ -166,3 +238,46 @@ typedef enum _sai_vpp_switch_attr_t
     SAI_VPP_SWITCH_ATTR_META_ALLOW_READ_ONLY_ONCE,
 
 } sau_vpp_switch_attr_t;
+
+/**
+ * @brief VPP dataplane load and resource usage, as switch stats.
+ *
+ * Gauges read from the VPP stats segment, they are not affected by a
+ * stats clear.
+ */
+typedef enum _sai_vpp_switch_stat_t
+{
+    /** Number of VPP worker threads, /sys/num_worker_threads */
+    SAI_VPP_SWITCH_STAT_WORKER_THREADS = SAI_SWITCH_STAT_CUSTOM_RANGE_BASE,
+
+    /** Average vectors per graph loop, /sys/vector_rate */
+    SAI_VPP_SWITCH_STAT_VECTOR_RATE,
+
+    /** Vector rate of the busiest worker, /sys/vector_rate_per_worker */
+    SAI_VPP_SWITCH_STAT_MAX_WORKER_VECTOR_RATE,
+
+    /** Graph loops per second averaged over workers, /sys/loops_per_worker */
+    SAI_VPP_SWITCH_STAT_LOOPS_PER_SEC,
+
+    /** Graph loops per second of the busiest worker */
+    SAI_VPP_SWITCH_STAT_MIN_WORKER_LOOPS_PER_SEC,
+
+    /** Packets dropped at device input queues (rx-miss and rx-no-buf), all ports */
+    SAI_VPP_SWITCH_STAT_INPUT_QUEUE_DROPS,
+
+    /** Buffers in use, /buffer-pools/<pool>/used, all pools */
+    SAI_VPP_SWITCH_STAT_BUFFERS_USED,
+
+    /** Free buffers, /buffer-pools/<pool>/available, all pools */
+    SAI_VPP_SWITCH_STAT_BUFFERS_AVAILABLE,
+
+    /** Buffers in per thread caches, /buffer-pools/<pool>/cached, all pools */
+    SAI_VPP_SWITCH_STAT_BUFFERS_CACHED,
+
+    /** Bytes used in the VPP main heap, /mem/main heap */
+    SAI_VPP_SWITCH_STAT_MAIN_HEAP_USED,
+
+    /** Size in bytes of the VPP main heap */
+    SAI_VPP_SWITCH_STAT_MAIN_HEAP_TOTAL,
+
+} sai_vpp_switch_stat_t;
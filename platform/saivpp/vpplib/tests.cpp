@@ -19,6 +19,11 @@
 
 #include <unistd.h>
 
+#include <chrono>
+#include <algorithm>
+#include <set>
+#include <thread>
+
 #include "swss/logger.h"
 #include "swss/dbconnector.h"
 #include "swss/schema.h"
@@ -31,6 +36,9 @@ extern "C" {
 }
 
 #include "saivpp.h"
+#include "SaiAttrWrap.h"
+#include "PendingRoutes.h"
+#include "SwitchVPP.h"
 
 const char* profile_get_value(
         _In_ sai_switch_profile_id_t profile_id,
@@ -794,6 +802,397 @@ void test_get_stats()
     ASSERT_TRUE(values[1] == 77);
 }
 
+void test_create_switch_latency()
+{
+    SWSS_LOG_ENTER();
+
+    const int iterations = 5;
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+    attr.value.booldata = true;
+
+    double total_ms = 0;
+    double max_ms = 0;
+
+    for (int i = 0; i < iterations; i++)
+    {
+        sai_reinit();
+
+        sai_object_id_t switch_id;
+
+        auto start = std::chrono::steady_clock::now();
+
+        SUCCESS(sai_metadata_sai_switch_api->create_switch(&switch_id, 1, &attr));
+
+        auto end = std::chrono::steady_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+        total_ms += ms;
+        max_ms = std::max(max_ms, ms);
+
+        SUCCESS(sai_metadata_sai_switch_api->remove_switch(switch_id));
+    }
+
+    printf("create_switch latency: avg %.3f ms, max %.3f ms over %d runs\n",
+            total_ms / iterations, max_ms, iterations);
+
+    SWSS_LOG_NOTICE("create_switch latency: avg %.3f ms, max %.3f ms over %d runs",
+            total_ms / iterations, max_ms, iterations);
+}
+
+/*
+ * Default queues and priority groups are created in bulk at switch init,
+ * they must carry the same attributes the per object create set.
+ */
+void test_default_port_objects()
+{
+    SWSS_LOG_ENTER();
+
+    sai_reinit();
+
+    sai_attribute_t attr;
+
+    sai_object_id_t switch_id;
+
+    attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+    attr.value.booldata = true;
+
+    SUCCESS(sai_metadata_sai_switch_api->create_switch(&switch_id, 1, &attr));
+
+    std::vector<sai_object_id_t> ports(1024);
+
+    attr.id = SAI_SWITCH_ATTR_PORT_LIST;
+    attr.value.objlist.count = (uint32_t)ports.size();
+    attr.value.objlist.list = ports.data();
+
+    SUCCESS(sai_metadata_sai_switch_api->get_switch_attribute(switch_id, 1, &attr));
+
+    ports.resize(attr.value.objlist.count);
+
+    ASSERT_TRUE(ports.size() != 0);
+
+    std::set<sai_object_id_t> seen;
+
+    for (auto port_id: ports)
+    {
+        std::vector<sai_object_id_t> pgs(64);
+
+        attr.id = SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST;
+        attr.value.objlist.count = (uint32_t)pgs.size();
+        attr.value.objlist.list = pgs.data();
+
+        SUCCESS(sai_metadata_sai_port_api->get_port_attribute(port_id, 1, &attr));
+
+        pgs.resize(attr.value.objlist.count);
+
+        attr.id = SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS;
+
+        SUCCESS(sai_metadata_sai_port_api->get_port_attribute(port_id, 1, &attr));
+
+        ASSERT_TRUE(attr.value.u32 == pgs.size());
+        ASSERT_TRUE(pgs.size() == 8);
+
+        for (uint32_t i = 0; i < pgs.size(); i++)
+        {
+            ASSERT_TRUE(seen.insert(pgs[i]).second);
+
+            sai_attribute_t pg_attrs[3];
+
+            pg_attrs[0].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE;
+            pg_attrs[1].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_PORT;
+            pg_attrs[2].id = SAI_INGRESS_PRIORITY_GROUP_ATTR_INDEX;
+
+            SUCCESS(sai_metadata_sai_buffer_api->get_ingress_priority_group_attribute(pgs[i], 3, pg_attrs));
+
+            ASSERT_TRUE(pg_attrs[0].value.oid == SAI_NULL_OBJECT_ID);
+            ASSERT_TRUE(pg_attrs[1].value.oid == port_id);
+            ASSERT_TRUE(pg_attrs[2].value.u8 == i);
+        }
+
+        std::vector<sai_object_id_t> queues(256);
+
+        attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
+        attr.value.objlist.count = (uint32_t)queues.size();
+        attr.value.objlist.list = queues.data();
+
+        SUCCESS(sai_metadata_sai_port_api->get_port_attribute(port_id, 1, &attr));
+
+        queues.resize(attr.value.objlist.count);
+
+        attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
+
+        SUCCESS(sai_metadata_sai_port_api->get_port_attribute(port_id, 1, &attr));
+
+        ASSERT_TRUE(attr.value.u32 == queues.size());
+
+        for (auto queue_id: queues)
+        {
+            ASSERT_TRUE(seen.insert(queue_id).second);
+
+            attr.id = SAI_QUEUE_ATTR_PORT;
+
+            SUCCESS(sai_metadata_sai_queue_api->get_queue_attribute(queue_id, 1, &attr));
+
+            ASSERT_TRUE(attr.value.oid == port_id);
+        }
+    }
+
+    SUCCESS(sai_metadata_sai_switch_api->remove_switch(switch_id));
+}
+
+static long get_rss_kb()
+{
+    SWSS_LOG_ENTER();
+
+    long pages = 0, rss = 0;
+
+    FILE *fp = fopen("/proc/self/statm", "r");
+
+    if (fp)
+    {
+        if (fscanf(fp, "%ld %ld", &pages, &rss) != 2)
+        {
+            rss = 0;
+        }
+
+        fclose(fp);
+    }
+
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void test_attr_create_latency()
+{
+    SWSS_LOG_ENTER();
+
+    sai_reinit();
+
+    const uint32_t vlan_count = 3000;
+
+    sai_attribute_t attr;
+
+    sai_object_id_t switch_id;
+
+    attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+    attr.value.booldata = true;
+
+    SUCCESS(sai_metadata_sai_switch_api->create_switch(&switch_id, 1, &attr));
+
+    std::vector<sai_object_id_t> vlans(vlan_count);
+
+    long rss_before = get_rss_kb();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < vlan_count; i++)
+    {
+        attr.id = SAI_VLAN_ATTR_VLAN_ID;
+        attr.value.u16 = (uint16_t)(i + 2);
+
+        SUCCESS(sai_metadata_sai_vlan_api->create_vlan(&vlans[i], switch_id, 1, &attr));
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    long rss_after = get_rss_kb();
+
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / vlan_count;
+
+    printf("create_vlan latency: %.3f us per object, rss +%ld kB for %u objects\n",
+            us, rss_after - rss_before, vlan_count);
+
+    SWSS_LOG_NOTICE("create_vlan latency: %.3f us per object, rss +%ld kB for %u objects",
+            us, rss_after - rss_before, vlan_count);
+
+    for (auto vlan: vlans)
+    {
+        SUCCESS(sai_metadata_sai_vlan_api->remove_vlan(vlan));
+    }
+}
+
+void test_attr_wrap_copy()
+{
+    SWSS_LOG_ENTER();
+
+    // list values are copied, the copy must not share memory with the input
+
+    std::vector<uint32_t> lanes = { 1, 2, 3, 4 };
+
+    sai_attribute_t attr;
+
+    attr.id = SAI_PORT_ATTR_HW_LANE_LIST;
+    attr.value.u32list.count = (uint32_t)lanes.size();
+    attr.value.u32list.list = lanes.data();
+
+    auto meta = sai_metadata_get_attr_metadata(SAI_OBJECT_TYPE_PORT, attr.id);
+
+    std::string serialized = sai_serialize_attr_value(*meta, attr, false);
+
+    saivpp::SaiAttrWrap wrap(SAI_OBJECT_TYPE_PORT, &attr);
+
+    lanes[0] = 100;
+    lanes[3] = 400;
+
+    auto copy = wrap.getAttr();
+
+    ASSERT_TRUE(copy->value.u32list.list != lanes.data());
+    ASSERT_TRUE(copy->value.u32list.count == 4);
+    ASSERT_TRUE(copy->value.u32list.list[0] == 1);
+    ASSERT_TRUE(copy->value.u32list.list[3] == 4);
+
+    // the lazily serialized value is the one of the original attribute
+
+    std::vector<std::string> values(8);
+    std::vector<std::thread> readers;
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        readers.emplace_back([&wrap, &values, i] { values[i] = wrap.getAttrStrValue(); });
+    }
+
+    for (auto& r: readers)
+    {
+        r.join();
+    }
+
+    for (auto& v: values)
+    {
+        ASSERT_TRUE(v == serialized);
+    }
+
+    saivpp::SaiAttrWrap deserialized(meta->attridname, serialized);
+
+    ASSERT_TRUE(deserialized.getAttrStrValue() == serialized);
+    ASSERT_TRUE(deserialized.getAttr()->value.u32list.count == 4);
+    ASSERT_TRUE(deserialized.getAttr()->value.u32list.list[3] == 4);
+
+    // scalar value
+
+    attr.id = SAI_PORT_ATTR_MTU;
+    attr.value.u32 = 9100;
+
+    saivpp::SaiAttrWrap mtu(SAI_OBJECT_TYPE_PORT, &attr);
+
+    attr.value.u32 = 1500;
+
+    ASSERT_TRUE(mtu.getAttr()->value.u32 == 9100);
+    ASSERT_TRUE(mtu.getAttrStrValue() == "9100");
+}
+
+void test_pending_routes()
+{
+    SWSS_LOG_ENTER();
+
+    sai_route_entry_t entry;
+
+    auto route = [&entry](const char *prefix, sai_object_id_t vr_id) {
+
+        entry.switch_id = 0x21000000000000;
+        entry.vr_id = vr_id;
+
+        sai_deserialize_ip_prefix(prefix, entry.destination);
+
+        return sai_serialize_route_entry(entry);
+    };
+
+    sai_object_id_t vr_id = 0x3000000000001;
+    sai_object_id_t rif_id = 0x6000000000001;
+
+    auto r1 = route("10.0.0.5/32", vr_id);
+    auto d1 = entry.destination;
+    auto r2 = route("10.1.0.0/24", vr_id);
+    auto d2 = entry.destination;
+    auto r3 = route("2001:db8::/64", vr_id);
+
+    saivpp::PendingRoutes pending;
+
+    pending.deferAddress(r1, d1);
+    pending.deferAddress(r2, d2);
+    pending.defer(r3, saivpp::PendingRoutes::ROUTE_DEP_VRF, vr_id);
+
+    ASSERT_TRUE(pending.size() == 3);
+    ASSERT_TRUE(pending.hasAddressRoutes());
+
+    // an address only resolves the routes whose prefix has it
+
+    sai_ip_address_t ip;
+
+    sai_deserialize_ip_address("10.0.0.5", ip);
+
+    auto routes = pending.takeForAddress(ip);
+
+    ASSERT_TRUE(routes.size() == 1 && routes.count(r1));
+    ASSERT_TRUE(!pending.isPending(r1) && pending.isPending(r2));
+
+    sai_deserialize_ip_address("2001:db8::1", ip);
+
+    ASSERT_TRUE(pending.takeForAddress(ip).empty());
+
+    // deferring again moves the route to the new dependency
+
+    pending.defer(r2, saivpp::PendingRoutes::ROUTE_DEP_RIF, rif_id);
+
+    ASSERT_TRUE(!pending.hasAddressRoutes());
+
+    sai_deserialize_ip_address("10.1.0.1", ip);
+
+    ASSERT_TRUE(pending.takeForAddress(ip).empty());
+    ASSERT_TRUE(pending.size() == 2);
+
+    ASSERT_TRUE(pending.take(saivpp::PendingRoutes::ROUTE_DEP_NEXT_HOP, rif_id).empty());
+
+    routes = pending.take(saivpp::PendingRoutes::ROUTE_DEP_RIF, rif_id);
+
+    ASSERT_TRUE(routes.size() == 1 && routes.count(r2));
+
+    routes = pending.take(saivpp::PendingRoutes::ROUTE_DEP_VRF, vr_id);
+
+    ASSERT_TRUE(routes.size() == 1 && routes.count(r3));
+    ASSERT_TRUE(pending.size() == 0);
+
+    // a removed route is not retried
+
+    pending.deferAddress(r2, d2);
+
+    ASSERT_TRUE(pending.cancel(r2));
+    ASSERT_TRUE(!pending.cancel(r2));
+    ASSERT_TRUE(!pending.hasAddressRoutes());
+
+    ASSERT_TRUE(pending.takeForAddress(ip).empty());
+}
+
+void test_vpp_port_hwif_mapping()
+{
+    SWSS_LOG_ENTER();
+
+    saivpp::LaneMap laneMap(0);
+
+    ASSERT_TRUE(laneMap.add("Ethernet0", {0, 1, 2, 3}));
+    ASSERT_TRUE(laneMap.add("Ethernet4", {4, 5, 6, 7}));
+    ASSERT_TRUE(laneMap.add("Ethernet8", {8, 9, 10, 11}));
+
+    // interface map in another order than the lane map and with a gap
+
+    std::map<std::string, std::string> hostifHwifMap = {
+        { "Ethernet8", "bobm2" },
+        { "Ethernet0", "bobm0" },
+    };
+
+    auto hwif = [&](const std::vector<uint32_t>& lanes) {
+
+        return saivpp::SwitchVPP::get_lanes_hwif_name(laneMap, hostifHwifMap, lanes);
+    };
+
+    ASSERT_TRUE(hwif({0, 1, 2, 3}) == "bobm0");
+    ASSERT_TRUE(hwif({8, 9, 10, 11}) == "bobm2");
+    ASSERT_TRUE(hwif({4, 5, 6, 7}) == "");
+    ASSERT_TRUE(hwif({12, 13, 14, 15}) == "");
+    ASSERT_TRUE(hwif({}) == "");
+}
+
 void test_supported_obj_types()
 {
     SWSS_LOG_ENTER();
@@ -852,6 +1251,18 @@ int main()
 
     test_set_stats_via_redis();
 
+    test_create_switch_latency();
+
+    test_default_port_objects();
+
+    test_attr_create_latency();
+
+    test_attr_wrap_copy();
+
+    test_pending_routes();
+
+    test_vpp_port_hwif_mapping();
+
     // make proper uninitialize to close unittest thread
     sai_api_uninitialize();
 
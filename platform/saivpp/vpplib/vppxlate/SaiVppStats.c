@@ -17,6 +17,7 @@
  *------------------------------------------------------------------
  */
 
+#include <stdio.h>
 #include <vpp-api/client/stat_client.h>
 #include <vlib/vlib.h>
 #include "SaiVppStats.h"
@@ -24,6 +25,16 @@
 static int is_stats_inited = 0;
 static __thread stat_client_main_t vpp_stat_client_main;
 
+/* Stats segment socket of the VPP instance selected by vpp_client_select */
+static char vpp_stat_socket_name[256] = STAT_SEGMENT_SOCKET_FILE;
+
+void
+vpp_stats_set_socket (const char *path)
+{
+  snprintf (vpp_stat_socket_name, sizeof (vpp_stat_socket_name), "%s",
+	    (path && path[0]) ? path : STAT_SEGMENT_SOCKET_FILE);
+}
+
 static int vpp_stats_init()
 {
   if (is_stats_inited) return 0;
@@ -32,6 +43,51 @@ static int vpp_stats_init()
   return 0;
 }
 
+/* Bound on directory rebuilds raced by one read */
+#define VPP_STATS_MAX_RETRIES 8
+
+/*
+ * ls and dump of patterns within one stat segment epoch. The directory is
+ * rebuilt when counters are added or removed (interface add/delete), which
+ * invalidates the indexes returned by ls, so the whole read is retried when
+ * the epoch moved or a rebuild was in progress.
+ */
+static stat_segment_data_t *
+vpp_stats_read (u8 **patterns, uint64_t *epoch)
+{
+  stat_client_main_t *sm = &vpp_stat_client_main;
+  stat_segment_access_t sa;
+  stat_segment_data_t *res;
+  u32 *dir;
+  int retry;
+
+  for (retry = 0; retry < VPP_STATS_MAX_RETRIES; retry++)
+    {
+      if (stat_segment_access_start (&sa, sm))
+	continue;
+
+      dir = stat_segment_ls_r (patterns, sm);
+      res = dir ? stat_segment_dump_r (dir, sm) : 0;
+      vec_free (dir);
+
+      if (stat_segment_access_end (&sa, sm))
+	{
+	  /* nothing matched if res is 0 here */
+	  if (epoch)
+	    *epoch = sa.epoch;
+	  return res;
+	}
+
+      if (res)
+	stat_segment_data_free (res);
+    }
+
+  SAIVPP_STAT_ERR("stats segment changed during %d reads, giving up\n",
+		  VPP_STATS_MAX_RETRIES);
+
+  return 0;
+}
+
 int
 vpp_stats_dump (const char *query_path, vpp_stat_one one, vpp_stat_two two, void *data)
 {
@@ -41,7 +97,7 @@ vpp_stats_dump (const char *query_path, vpp_stat_one one, vpp_stat_two two, void
 
   vpp_stats_init();
 
-  stat_segment_name = (u8 *) STAT_SEGMENT_SOCKET_FILE;
+  stat_segment_name = (u8 *) vpp_stat_socket_name;
 
   pattern = (u8 *) query_path;
   vec_add1 (patterns, pattern);
@@ -54,18 +110,14 @@ vpp_stats_dump (const char *query_path, vpp_stat_one one, vpp_stat_two two, void
       return -1;
     }
 
-  u32 *dir;
   int i, j, k;
   stat_segment_data_t *res;
 
-  dir = stat_segment_ls_r (patterns, &vpp_stat_client_main);
-  if (!dir)
-    {
-      return -1;
-    }
-  res = stat_segment_dump_r (dir, &vpp_stat_client_main);
+  res = vpp_stats_read (patterns, 0);
+  vec_free (patterns);
   if (!res)
     {
+      stat_segment_disconnect_r (&vpp_stat_client_main);
       return -1;
     }
 
@@ -137,6 +189,315 @@ vpp_stats_dump (const char *query_path, vpp_stat_one one, vpp_stat_two two, void
   return 0;
 }
 
+/* Layout of the /mem/<heap> counter vector */
+#define VPP_STAT_MEM_TOTAL 0
+#define VPP_STAT_MEM_USED  1
+
+int
+vpp_heap_usage_query (const char *heap_name, vpp_heap_usage_t *usage)
+{
+  u8 *stat_segment_name, *pattern, **patterns = 0;
+  stat_segment_data_t *res;
+  int rv = -1;
+  int i;
+
+  vpp_stats_init();
+
+  stat_segment_name = (u8 *) vpp_stat_socket_name;
+
+  if (stat_segment_connect_r ((char *) stat_segment_name, &vpp_stat_client_main))
+    {
+      SAIVPP_STAT_ERR("Couldn't connect to vpp, does %s exist?\n",
+		      stat_segment_name);
+      return -1;
+    }
+
+  pattern = format (0, "^/mem/%s$%c", heap_name, 0);
+  vec_add1 (patterns, pattern);
+
+  res = vpp_stats_read (patterns, 0);
+
+  for (i = 0; res && i < vec_len (res); i++)
+    {
+      if (res[i].type != STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ||
+	  vec_len (res[i].simple_counter_vec) == 0 ||
+	  vec_len (res[i].simple_counter_vec[0]) <= VPP_STAT_MEM_USED)
+	continue;
+
+      usage->total = res[i].simple_counter_vec[0][VPP_STAT_MEM_TOTAL];
+      usage->used = res[i].simple_counter_vec[0][VPP_STAT_MEM_USED];
+      rv = 0;
+      break;
+    }
+
+  if (res)
+    stat_segment_data_free (res);
+  vec_free (pattern);
+  vec_free (patterns);
+
+  stat_segment_disconnect_r (&vpp_stat_client_main);
+
+  return rv;
+}
+
+int
+vpp_combined_stats_query (const char *stat_path, vpp_combined_counter_t *counters,
+			  uint32_t max_count, uint32_t *count)
+{
+  u8 *stat_segment_name, *pattern, **patterns = 0;
+  stat_segment_data_t *res;
+  int rv = -1;
+  int i, j, k;
+
+  vpp_stats_init();
+
+  stat_segment_name = (u8 *) vpp_stat_socket_name;
+
+  if (stat_segment_connect_r ((char *) stat_segment_name, &vpp_stat_client_main))
+    {
+      SAIVPP_STAT_ERR("Couldn't connect to vpp, does %s exist?\n",
+		      stat_segment_name);
+      return -1;
+    }
+
+  pattern = format (0, "^%s$%c", stat_path, 0);
+  vec_add1 (patterns, pattern);
+
+  res = vpp_stats_read (patterns, 0);
+
+  for (i = 0; res && i < vec_len (res); i++)
+    {
+      uint32_t len = 0;
+
+      if (res[i].type != STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED ||
+	  res[i].combined_counter_vec == 0)
+	continue;
+
+      for (k = 0; k < vec_len (res[i].combined_counter_vec); k++)
+	if (vec_len (res[i].combined_counter_vec[k]) > len)
+	  len = vec_len (res[i].combined_counter_vec[k]);
+
+      memset (counters, 0, sizeof (*counters) * clib_min (len, max_count));
+
+      /* one vector per thread */
+      for (k = 0; k < vec_len (res[i].combined_counter_vec); k++)
+	for (j = 0; j < vec_len (res[i].combined_counter_vec[k]) && j < max_count; j++)
+	  {
+	    counters[j].packets += res[i].combined_counter_vec[k][j].packets;
+	    counters[j].bytes += res[i].combined_counter_vec[k][j].bytes;
+	  }
+
+      *count = len;
+      rv = 0;
+      break;
+    }
+
+  if (res)
+    stat_segment_data_free (res);
+  vec_free (pattern);
+  vec_free (patterns);
+
+  stat_segment_disconnect_r (&vpp_stat_client_main);
+
+  return rv;
+}
+
+int
+vpp_stats_snapshot (const char **query_paths, uint32_t count,
+		    vpp_stat_counter cb, void *data, uint64_t *epoch)
+{
+  u8 *stat_segment_name, **patterns = 0;
+  stat_segment_data_t *res;
+  uint32_t n;
+  int rv, i, j, k;
+
+  vpp_stats_init();
+
+  stat_segment_name = (u8 *) vpp_stat_socket_name;
+
+  if (stat_segment_connect_r ((char *) stat_segment_name, &vpp_stat_client_main))
+    {
+      SAIVPP_STAT_ERR("Couldn't connect to vpp, does %s exist?\n",
+		      stat_segment_name);
+      return -1;
+    }
+
+  for (n = 0; n < count; n++)
+    vec_add1 (patterns, format (0, "%s%c", query_paths[n], 0));
+
+  res = vpp_stats_read (patterns, epoch);
+  rv = res ? 0 : -1;
+
+  for (i = 0; res && i < vec_len (res); i++)
+    {
+      switch (res[i].type)
+	{
+	case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+	  if (res[i].simple_counter_vec == 0)
+	    continue;
+	  /* one vector per thread */
+	  for (j = 0; j < vec_len (res[i].simple_counter_vec[0]); j++)
+	    {
+	      uint64_t packets = 0;
+
+	      for (k = 0; k < vec_len (res[i].simple_counter_vec); k++)
+		if (j < vec_len (res[i].simple_counter_vec[k]))
+		  packets += res[i].simple_counter_vec[k][j];
+
+	      cb (res[i].name, j, packets, 0, 0, data);
+	    }
+	  break;
+
+	case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+	  if (res[i].combined_counter_vec == 0)
+	    continue;
+	  for (j = 0; j < vec_len (res[i].combined_counter_vec[0]); j++)
+	    {
+	      uint64_t packets = 0, bytes = 0;
+
+	      for (k = 0; k < vec_len (res[i].combined_counter_vec); k++)
+		if (j < vec_len (res[i].combined_counter_vec[k]))
+		  {
+		    packets += res[i].combined_counter_vec[k][j].packets;
+		    bytes += res[i].combined_counter_vec[k][j].bytes;
+		  }
+
+	      cb (res[i].name, j, packets, bytes, 1, data);
+	    }
+	  break;
+
+	case STAT_DIR_TYPE_SCALAR_INDEX:
+	  cb (res[i].name, 0, (uint64_t) res[i].scalar_value, 0, 0, data);
+	  break;
+
+	default:
+	  ;
+	}
+    }
+
+  if (res)
+    stat_segment_data_free (res);
+  for (n = 0; n < vec_len (patterns); n++)
+    vec_free (patterns[n]);
+  vec_free (patterns);
+
+  stat_segment_disconnect_r (&vpp_stat_client_main);
+
+  return rv;
+}
+
+static int
+vpp_stat_name_suffix (const char *name, const char *prefix, const char *suffix)
+{
+  size_t nlen = strlen (name), plen = strlen (prefix), slen = strlen (suffix);
+
+  return nlen > plen + slen && !strncmp (name, prefix, plen) &&
+	 !strcmp (name + nlen - slen, suffix);
+}
+
+int
+vpp_sys_stats_query (vpp_sys_stats_t *stats)
+{
+  u8 *stat_segment_name, **patterns = 0;
+  stat_segment_data_t *res;
+  u64 loops_sum = 0;
+  u32 forwarding = 0;
+  int i, k, rv;
+
+  vpp_stats_init();
+
+  stat_segment_name = (u8 *) vpp_stat_socket_name;
+
+  if (stat_segment_connect_r ((char *) stat_segment_name, &vpp_stat_client_main))
+    {
+      SAIVPP_STAT_ERR("Couldn't connect to vpp, does %s exist?\n",
+		      stat_segment_name);
+      return -1;
+    }
+
+  vec_add1 (patterns, format (0, "^/sys/%c", 0));
+  vec_add1 (patterns, format (0, "^/buffer-pools/%c", 0));
+  vec_add1 (patterns, format (0, "^/mem/%s$%c", "main heap", 0));
+
+  memset (stats, 0, sizeof (*stats));
+
+  res = vpp_stats_read (patterns, 0);
+
+  /* scalars first, per worker vectors skip the main thread when there are workers */
+  for (i = 0; res && i < vec_len (res); i++)
+    if (res[i].type == STAT_DIR_TYPE_SCALAR_INDEX &&
+	!strcmp (res[i].name, "/sys/num_worker_threads"))
+      stats->num_worker_threads = (uint64_t) res[i].scalar_value;
+
+  for (i = 0; res && i < vec_len (res); i++)
+    {
+      const char *name = res[i].name;
+
+      if (res[i].type == STAT_DIR_TYPE_SCALAR_INDEX)
+	{
+	  uint64_t value = (uint64_t) res[i].scalar_value;
+
+	  if (!strcmp (name, "/sys/vector_rate"))
+	    stats->vector_rate = value;
+	  else if (vpp_stat_name_suffix (name, "/buffer-pools/", "/used"))
+	    stats->buffers_used += value;
+	  else if (vpp_stat_name_suffix (name, "/buffer-pools/", "/available"))
+	    stats->buffers_available += value;
+	  else if (vpp_stat_name_suffix (name, "/buffer-pools/", "/cached"))
+	    stats->buffers_cached += value;
+	}
+      else if (res[i].type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE &&
+	       res[i].simple_counter_vec != 0)
+	{
+	  if (!strcmp (name, "/sys/vector_rate_per_worker"))
+	    {
+	      for (k = stats->num_worker_threads ? 1 : 0; k < vec_len (res[i].simple_counter_vec); k++)
+		if (vec_len (res[i].simple_counter_vec[k]) &&
+		    res[i].simple_counter_vec[k][0] > stats->max_worker_vector_rate)
+		  stats->max_worker_vector_rate = res[i].simple_counter_vec[k][0];
+	    }
+	  else if (!strcmp (name, "/sys/loops_per_worker"))
+	    {
+	      for (k = stats->num_worker_threads ? 1 : 0; k < vec_len (res[i].simple_counter_vec); k++)
+		{
+		  uint64_t loops;
+
+		  if (vec_len (res[i].simple_counter_vec[k]) == 0)
+		    continue;
+
+		  loops = res[i].simple_counter_vec[k][0];
+		  loops_sum += loops;
+		  forwarding++;
+
+		  if (stats->min_worker_loops_per_sec == 0 || loops < stats->min_worker_loops_per_sec)
+		    stats->min_worker_loops_per_sec = loops;
+		}
+	    }
+	  else if (vec_len (res[i].simple_counter_vec[0]) > VPP_STAT_MEM_USED)
+	    {
+	      stats->main_heap_total = res[i].simple_counter_vec[0][VPP_STAT_MEM_TOTAL];
+	      stats->main_heap_used = res[i].simple_counter_vec[0][VPP_STAT_MEM_USED];
+	    }
+	}
+    }
+
+  if (forwarding)
+    stats->loops_per_sec = loops_sum / forwarding;
+
+  /* res must not be looked at once it is freed */
+  rv = res ? 0 : -1;
+
+  if (res)
+    stat_segment_data_free (res);
+  for (i = 0; i < vec_len (patterns); i++)
+    vec_free (patterns[i]);
+  vec_free (patterns);
+
+  stat_segment_disconnect_r (&vpp_stat_client_main);
+
+  return rv;
+}
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
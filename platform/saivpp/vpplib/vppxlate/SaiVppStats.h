@@ -20,11 +20,75 @@
 #ifndef _SAI_VPP_STATS_H_
 #define _SAI_VPP_STATS_H_
 
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef  void (*vpp_stat_one)(const char *, uint64_t, void *);
 typedef  void (*vpp_stat_two)(const char *, uint64_t, uint64_t, void *);
 
+/* Stats segment socket used by the queries below, NULL or "" for the default */
+void vpp_stats_set_socket(const char *path);
+
 int vpp_stats_dump(const char *query_path, vpp_stat_one one, vpp_stat_two two, void *data);
 
+typedef struct vpp_heap_usage_ {
+  uint64_t total;
+  uint64_t used;
+} vpp_heap_usage_t;
+
+/* heap_name as in the stats segment, e.g. "main heap" */
+int vpp_heap_usage_query(const char *heap_name, vpp_heap_usage_t *usage);
+
+typedef struct vpp_combined_counter_ {
+  uint64_t packets;
+  uint64_t bytes;
+} vpp_combined_counter_t;
+
+/*
+ * Reads the combined counter vector at stat_path (e.g. "/net/route/to")
+ * summed over all threads into counters, up to max_count entries. count is
+ * set to the length of the vector, which may be more than max_count.
+ */
+int vpp_combined_stats_query(const char *stat_path, vpp_combined_counter_t *counters,
+			     uint32_t max_count, uint32_t *count);
+
+typedef struct vpp_sys_stats_ {
+  uint64_t num_worker_threads;      /* /sys/num_worker_threads */
+  uint64_t vector_rate;             /* /sys/vector_rate, vectors per loop */
+  uint64_t max_worker_vector_rate;  /* busiest worker in /sys/vector_rate_per_worker */
+  uint64_t loops_per_sec;           /* average over workers of /sys/loops_per_worker */
+  uint64_t min_worker_loops_per_sec;
+  uint64_t buffers_used;            /* /buffer-pools/<pool>/used, all pools */
+  uint64_t buffers_available;
+  uint64_t buffers_cached;
+  uint64_t main_heap_total;         /* /mem/main heap */
+  uint64_t main_heap_used;
+} vpp_sys_stats_t;
+
+/* Dataplane load and resource counters, read within one stat segment epoch */
+int vpp_sys_stats_query(vpp_sys_stats_t *stats);
+
+typedef void (*vpp_stat_counter)(const char *name, uint32_t index, uint64_t packets,
+				 uint64_t bytes, int is_combined, void *data);
+
+/*
+ * Reads every counter matching one of the query_paths regexes with a single
+ * stats segment dump within one stat segment epoch, retried a bounded number
+ * of times if the directory changes meanwhile. cb is called per counter
+ * index with the full stat name and the value summed over all threads,
+ * bytes is only set for combined counters. epoch, if not NULL, is set to
+ * the stat segment epoch the values belong to.
+ */
+int vpp_stats_snapshot(const char **query_paths, uint32_t count,
+		       vpp_stat_counter cb, void *data, uint64_t *epoch);
+
+#ifdef __cplusplus
+}
+#endif
+
 #define SAIVPP_STAT_DBG(format,args...) {}
 #define SAIVPP_STAT_ERR clib_error
 
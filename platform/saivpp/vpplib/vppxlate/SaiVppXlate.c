@@ -16,7 +16,9 @@
 #include <stdio.h>
 #include <endian.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <poll.h>
 #include <assert.h>
 
 #include <vat/vat.h>
@@ -25,6 +27,7 @@
 #include <vppinfra/error.h>
 
 #include "SaiVppXlate.h"
+#include "SaiVppStats.h"
 
 #include <vnet/ip/ip_types_api.h>
 
@@ -44,6 +47,13 @@
 #include <vpp_plugins/linux_cp/lcp.api_enum.h>
 #include <vpp_plugins/linux_cp/lcp.api_types.h>
 
+#include <vnet/ip/punt.api_enum.h>
+#include <vnet/ip/punt.api_types.h>
+
+#include <vnet/devices/tap/tapv2.api_enum.h>
+#include <vnet/devices/tap/tapv2.api_types.h>
+
+#include <vlibmemory/vlib.api_enum.h>
 #include <vlibmemory/vlib.api_types.h>
 #include <vlibmemory/memclnt.api_enum.h>
 
@@ -140,6 +150,60 @@
 #include <vpp_plugins/linux_cp/lcp.api.h>
 #undef vl_api_version
 
+/* punt API inclusion */
+
+#define vl_typedefs
+#include <vnet/ip/punt.api.h>
+#undef vl_typedefs
+
+#define  vl_endianfun
+#include <vnet/ip/punt.api.h>
+#undef vl_endianfun
+
+#define vl_calcsizefun
+#include <vnet/ip/punt.api.h>
+#undef vl_calcsizefun
+
+#define vl_api_version(n, v) static u32 punt_api_version = v;
+#include <vnet/ip/punt.api.h>
+#undef vl_api_version
+
+/* tapv2 API inclusion */
+
+#define vl_typedefs
+#include <vnet/devices/tap/tapv2.api.h>
+#undef vl_typedefs
+
+#define  vl_endianfun
+#include <vnet/devices/tap/tapv2.api.h>
+#undef vl_endianfun
+
+#define vl_calcsizefun
+#include <vnet/devices/tap/tapv2.api.h>
+#undef vl_calcsizefun
+
+#define vl_api_version(n, v) static u32 tapv2_api_version = v;
+#include <vnet/devices/tap/tapv2.api.h>
+#undef vl_api_version
+
+/* vlib API inclusion, for cli_inband */
+
+#define vl_typedefs
+#include <vlibmemory/vlib.api.h>
+#undef vl_typedefs
+
+#define  vl_endianfun
+#include <vlibmemory/vlib.api.h>
+#undef vl_endianfun
+
+#define vl_calcsizefun
+#include <vlibmemory/vlib.api.h>
+#undef vl_calcsizefun
+
+#define vl_api_version(n, v) static u32 vlib_api_version = v;
+#include <vlibmemory/vlib.api.h>
+#undef vl_api_version
+
 /* memclnt API inclusion */
 
 #define vl_typedefs /* define message structures */
@@ -176,6 +240,91 @@ void os_exit(int code) {}
 
 vat_main_t vat_main;
 
+/* hardware interfaces seen in the last sw_interface_dump */
+static vpp_hw_interface_t *hw_if_table;
+
+/*
+ * Router interfaces of the batch in flight, indexed by the context of the
+ * pipelined requests so that replies can be matched to their interface.
+ */
+static vpp_rif_config_t *rif_batch;
+static u32 rif_batch_len;
+
+/* sw_if_index from the last create_subif_reply */
+static u32 created_subif_sw_if_index = ~0;
+
+/* stats_index from the last ip_route_add_del_reply or ip_route_lookup_reply */
+static u32 route_stats_index = ~0;
+
+/* VPP side of the punt socket from the last punt_socket_register_reply */
+static char punt_server_path[108];
+
+/*
+ * Host TAP looked up by lcp_host_tap_set_offload, filled in from the
+ * sw_interface_tap_v2_details whose host_if_name matches.
+ */
+static struct {
+    const char *host_if_name;
+    u32 sw_if_index;
+    u32 tap_flags;
+    char dev_name[64];
+} tap_lookup;
+
+/*
+ * Interface names by sw_if_index. These are the keys of
+ * sw_if_index_by_interface_name, so that an interface can be removed from
+ * the name table when only its index is known (delete reply, interface
+ * event) without walking the table.
+ */
+static u8 **sw_if_name_by_index;
+
+static u32 get_swif_idx (vat_main_t *vam, const char *ifname)
+{
+    uword *p;
+
+    p = hash_get_mem (vam->sw_if_index_by_interface_name, ifname);
+    if (p == NULL) return ((u32) -1);
+
+    return (u32) p[0];
+}
+
+static void set_swif_idx (vat_main_t *vam, const char *ifname, u32 sw_if_index)
+{
+    hash_pair_t *hp;
+    u8 *key;
+
+    hp = hash_get_pair_mem (vam->sw_if_index_by_interface_name, ifname);
+    if (hp) {
+	u32 old_index = (u32) hp->value[0];
+
+	key = (u8 *) hp->key;
+	if (old_index < vec_len (sw_if_name_by_index) &&
+	    sw_if_name_by_index[old_index] == key)
+	    sw_if_name_by_index[old_index] = NULL;
+	hp->value[0] = sw_if_index;
+    } else {
+	key = format (0, "%s%c", ifname, 0);
+	hash_set_mem (vam->sw_if_index_by_interface_name, key, sw_if_index);
+    }
+
+    vec_validate_init_empty (sw_if_name_by_index, sw_if_index, NULL);
+    sw_if_name_by_index[sw_if_index] = key;
+}
+
+static void clear_swif_idx (vat_main_t *vam, u32 sw_if_index)
+{
+    u8 *key;
+
+    if (sw_if_index >= vec_len (sw_if_name_by_index)) return;
+
+    key = sw_if_name_by_index[sw_if_index];
+    if (key == NULL) return;
+
+    hash_unset_mem (vam->sw_if_index_by_interface_name, key);
+    sw_if_name_by_index[sw_if_index] = NULL;
+    vec_free (key);
+}
+
 f64
 vat_time_now (vat_main_t * vam)
 {
@@ -228,6 +377,15 @@ vl_noop_handler (void *mp)
 {
 }
 
+static void set_batch_reply_status (u32 context, int retval)
+{
+    if (rif_batch == NULL || context >= rif_batch_len)
+	return;
+
+    if (retval < 0 && rif_batch[context].retval == 0)
+	rif_batch[context].retval = retval;
+}
+
 static void set_reply_status (int retval)
 {
     vat_main_t *vam = &vat_main;
@@ -261,8 +419,23 @@ vl_api_sw_interface_details_t_handler (vl_api_sw_interface_details_t *mp)
   vat_main_t *vam = &vat_main;
   u8 *s = format (0, "%s%c", mp->interface_name, 0);
 
-  hash_set_mem (vam->sw_if_index_by_interface_name, s,
-		ntohl (mp->sw_if_index));
+  set_swif_idx (vam, (char *) s, ntohl (mp->sw_if_index));
+
+  /* Physical interfaces are recorded for switch port discovery */
+  if (mp->sw_if_index == mp->sup_sw_if_index &&
+      ntohl (mp->type) == IF_API_TYPE_HARDWARE)
+    {
+      vpp_hw_interface_t *hwif = NULL;
+
+      vec_add2 (hw_if_table, hwif, 1);
+
+      strncpy (hwif->hwif_name, (char *) mp->interface_name,
+	       sizeof (hwif->hwif_name) - 1);
+      hwif->sw_if_index = ntohl (mp->sw_if_index);
+      hwif->link_speed = ntohl (mp->link_speed);
+      hwif->link_mtu = ntohs (mp->link_mtu);
+      clib_memcpy (hwif->l2_address, mp->l2_address, sizeof (hwif->l2_address));
+    }
 
   /* In sub interface case, fill the sub interface table entry */
   if (mp->sw_if_index != mp->sup_sw_if_index)
@@ -289,14 +462,41 @@ vl_api_sw_interface_details_t_handler (vl_api_sw_interface_details_t *mp)
       sub->vtr_tag1 = ntohl (mp->vtr_tag1);
       sub->vtr_tag2 = ntohl (mp->vtr_tag2);
     }
+
+  vec_free (s);
+}
+
+static void
+vl_api_sw_interface_rx_placement_details_t_handler (vl_api_sw_interface_rx_placement_details_t *mp)
+{
+    vpp_hw_interface_t *hwif;
+    u32 sw_if_index = ntohl(mp->sw_if_index);
+
+    vec_foreach (hwif, hw_if_table)
+    {
+	if (hwif->sw_if_index == sw_if_index) {
+	    hwif->num_rx_queues++;
+	    break;
+	}
+    }
 }
 
 static void
 vl_api_create_subif_reply_t_handler (vl_api_create_subif_reply_t *msg)
 {
-    vat_main_t *vam = &vat_main;
+    u32 context = ntohl(msg->context);
+    int retval = ntohl(msg->retval);
 
-    set_reply_status(ntohl(msg->retval));
+    set_reply_status(retval);
+
+    created_subif_sw_if_index = (retval == 0) ? ntohl(msg->sw_if_index) : ~0;
+
+    if (rif_batch && context < rif_batch_len)
+    {
+	rif_batch[context].retval = retval;
+	if (retval == 0)
+	    rif_batch[context].sw_if_index = created_subif_sw_if_index;
+    }
 
     SAIVPP_DEBUG("subinterface creation %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
@@ -309,10 +509,28 @@ vl_api_delete_subif_reply_t_handler (vl_api_delete_subif_reply_t *msg)
     SAIVPP_DEBUG("subinterface deletion %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
 
+/* Received on the event connection, must not touch the command reply state */
+static void
+vl_api_want_interface_events_reply_t_handler (vl_api_want_interface_events_reply_t *msg)
+{
+    SAIVPP_DEBUG("interface events registration %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
+}
+
+static void
+vl_api_sw_interface_event_t_handler (vl_api_sw_interface_event_t *msg)
+{
+    vat_main_t *vam = &vat_main;
+
+    /* Keep the name table in sync with interfaces deleted behind our back */
+    if (msg->deleted)
+	clear_swif_idx(vam, ntohl(msg->sw_if_index));
+}
+
 static void
 vl_api_sw_interface_set_table_reply_t_handler (vl_api_sw_interface_set_table_reply_t *msg)
 {
     set_reply_status(ntohl(msg->retval));
+    set_batch_reply_status(ntohl(msg->context), ntohl(msg->retval));
 
     SAIVPP_DEBUG("sw interface vrf set %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
@@ -329,6 +547,7 @@ static void
 vl_api_sw_interface_set_flags_reply_t_handler (vl_api_sw_interface_set_flags_reply_t *msg)
 {
     set_reply_status(ntohl(msg->retval));
+    set_batch_reply_status(ntohl(msg->context), ntohl(msg->retval));
 
     SAIVPP_DEBUG("sw interface state set %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
@@ -337,6 +556,7 @@ static void
 vl_api_sw_interface_set_mtu_reply_t_handler (vl_api_sw_interface_set_mtu_reply_t *msg)
 {
     set_reply_status(ntohl(msg->retval));
+    set_batch_reply_status(ntohl(msg->context), ntohl(msg->retval));
 
     SAIVPP_DEBUG("sw interface mtu set %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
@@ -362,9 +582,21 @@ vl_api_ip_route_add_del_reply_t_handler (vl_api_ip_route_add_del_reply_t *msg)
 {
     set_reply_status(ntohl(msg->retval));
 
+    route_stats_index = (msg->retval == 0) ? ntohl(msg->stats_index) : ~0;
+
     SAIVPP_DEBUG("ip vrf add %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
 
+static void
+vl_api_ip_route_lookup_reply_t_handler (vl_api_ip_route_lookup_reply_t *msg)
+{
+    set_reply_status(ntohl(msg->retval));
+
+    route_stats_index = (msg->retval == 0) ? ntohl(msg->route.stats_index) : ~0;
+
+    SAIVPP_DEBUG("ip route lookup %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
+}
+
 static void
 vl_api_ip_neighbor_add_del_reply_t_handler (vl_api_ip_neighbor_add_del_reply_t *msg)
 {
@@ -412,8 +644,11 @@ static void vpp_base_vpe_init(void)
 
 #define foreach_vpe_ext_api_reply_msg                                   \
     _(INTERFACE_MSG_ID(SW_INTERFACE_DETAILS), sw_interface_details)     \
+    _(INTERFACE_MSG_ID(SW_INTERFACE_RX_PLACEMENT_DETAILS), sw_interface_rx_placement_details) \
     _(INTERFACE_MSG_ID(CREATE_SUBIF_REPLY), create_subif_reply) \
     _(INTERFACE_MSG_ID(DELETE_SUBIF_REPLY), delete_subif_reply) \
+    _(INTERFACE_MSG_ID(WANT_INTERFACE_EVENTS_REPLY), want_interface_events_reply) \
+    _(INTERFACE_MSG_ID(SW_INTERFACE_EVENT), sw_interface_event) \
     _(INTERFACE_MSG_ID(SW_INTERFACE_SET_TABLE_REPLY), sw_interface_set_table_reply) \
     _(INTERFACE_MSG_ID(SW_INTERFACE_ADD_DEL_ADDRESS_REPLY), sw_interface_add_del_address_reply) \
     _(INTERFACE_MSG_ID(SW_INTERFACE_SET_FLAGS_REPLY), sw_interface_set_flags_reply) \
@@ -421,9 +656,10 @@ static void vpp_base_vpe_init(void)
     _(INTERFACE_MSG_ID(HW_INTERFACE_SET_MTU_REPLY), hw_interface_set_mtu_reply) \
     _(IP_MSG_ID(IP_TABLE_ADD_DEL_REPLY), ip_table_add_del_reply) \
     _(IP_MSG_ID(IP_ROUTE_ADD_DEL_REPLY), ip_route_add_del_reply) \
+    _(IP_MSG_ID(IP_ROUTE_LOOKUP_REPLY), ip_route_lookup_reply) \
     _(IP_NBR_MSG_ID(IP_NEIGHBOR_ADD_DEL_REPLY), ip_neighbor_add_del_reply)
 
-static u16 interface_msg_id_base, ip_msg_id_base, ip_nbr_msg_id_base, lcp_msg_id_base, memclnt_msg_id_base, __plugin_msg_base;
+static u16 interface_msg_id_base, ip_msg_id_base, ip_nbr_msg_id_base, lcp_msg_id_base, punt_msg_id_base, tapv2_msg_id_base, vlib_msg_id_base, memclnt_msg_id_base, __plugin_msg_base;
 
 static void vpp_ext_vpe_init(void)
 {
@@ -449,11 +685,65 @@ static void vl_api_lcp_itf_pair_add_del_reply_t_handler(vl_api_lcp_itf_pair_add_
     SAIVPP_DEBUG("linux_cp hostif creation %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
 }
 
+static void vl_api_sw_interface_tap_v2_details_t_handler(vl_api_sw_interface_tap_v2_details_t *msg)
+{
+    if (tap_lookup.host_if_name == NULL ||
+	strncmp((char *) msg->host_if_name, tap_lookup.host_if_name, sizeof(msg->host_if_name)) != 0)
+	return;
+
+    tap_lookup.sw_if_index = ntohl(msg->sw_if_index);
+    tap_lookup.tap_flags = ntohl(msg->tap_flags);
+    strncpy(tap_lookup.dev_name, (char *) msg->dev_name, sizeof(tap_lookup.dev_name) - 1);
+}
+
+static void vl_api_punt_socket_register_reply_t_handler(vl_api_punt_socket_register_reply_t *msg)
+{
+    set_reply_status(ntohl(msg->retval));
+
+    if (msg->retval == 0)
+	strncpy(punt_server_path, (char *) msg->pathname, sizeof(punt_server_path) - 1);
+
+    SAIVPP_DEBUG("punt socket register %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
+}
+
+static void vl_api_punt_socket_deregister_reply_t_handler(vl_api_punt_socket_deregister_reply_t *msg)
+{
+    set_reply_status(ntohl(msg->retval));
+
+    SAIVPP_DEBUG("punt socket deregister %s(%d)", msg->retval ? "failed" : "successful", msg->retval);
+}
+
+static void vl_api_cli_inband_reply_t_handler(vl_api_cli_inband_reply_t *msg)
+{
+    int retval = ntohl(msg->retval);
+    u32 len = vl_api_string_len(&msg->reply);
+
+    /* cli_inband succeeds whenever the command ran, errors are in the output */
+    if (retval == 0 && len > 0) {
+	SAIVPP_WARN("cli_inband: %.*s", len, vl_api_from_api_string(&msg->reply));
+	retval = -1;
+    }
+    set_reply_status(retval);
+}
+
 #define LCP_MSG_ID(id) \
     (VL_API_##id + lcp_msg_id_base)
 
+#define PUNT_MSG_ID(id) \
+    (VL_API_##id + punt_msg_id_base)
+
+#define TAPV2_MSG_ID(id) \
+    (VL_API_##id + tapv2_msg_id_base)
+
+#define VLIB_MSG_ID(id) \
+    (VL_API_##id + vlib_msg_id_base)
+
 #define foreach_vpe_plugin_api_reply_msg                                \
     _(LCP_MSG_ID(LCP_ITF_PAIR_ADD_DEL_REPLY), lcp_itf_pair_add_del_reply) \
+    _(PUNT_MSG_ID(PUNT_SOCKET_REGISTER_REPLY), punt_socket_register_reply) \
+    _(PUNT_MSG_ID(PUNT_SOCKET_DEREGISTER_REPLY), punt_socket_deregister_reply) \
+    _(TAPV2_MSG_ID(SW_INTERFACE_TAP_V2_DETAILS), sw_interface_tap_v2_details) \
+    _(VLIB_MSG_ID(CLI_INBAND_REPLY), cli_inband_reply) \
     
 static void vpp_plugin_vpe_init(void)
 {
@@ -490,25 +780,179 @@ static void get_base_msg_id()
     lcp_msg_id_base = vl_client_get_first_plugin_msg_id ((char *) msg_base_lookup_name);
     assert(lcp_msg_id_base != (u16) ~0);
 
+    msg_base_lookup_name = format (0, "punt_%08x%c", punt_api_version, 0);
+    punt_msg_id_base = vl_client_get_first_plugin_msg_id ((char *) msg_base_lookup_name);
+    assert(punt_msg_id_base != (u16) ~0);
+
+    msg_base_lookup_name = format (0, "tapv2_%08x%c", tapv2_api_version, 0);
+    tapv2_msg_id_base = vl_client_get_first_plugin_msg_id ((char *) msg_base_lookup_name);
+    assert(tapv2_msg_id_base != (u16) ~0);
+
+    msg_base_lookup_name = format (0, "vlib_%08x%c", vlib_api_version, 0);
+    vlib_msg_id_base = vl_client_get_first_plugin_msg_id ((char *) msg_base_lookup_name);
+    assert(vlib_msg_id_base != (u16) ~0);
+
     memclnt_msg_id_base = 0;
 }
 
 #define API_SOCKET_FILE "/run/vpp/api.sock"
 #define VPP_SOCKET_PATH API_SOCKET_FILE
 
+/*
+ * Per VPP instance client state. The VPP api library keeps a single
+ * connection in process globals (socket_client_main, vat_main, the message
+ * id bases, the message name table), so one client is kept per api socket
+ * and swapped into the globals by vpp_client_select. Reply handlers are
+ * registered by message id once for the process, so every instance must
+ * use the message ids of the first one connected; others are refused.
+ * Callers serialize on the SAI api lock.
+ */
 typedef struct _vsclient_main_ {
-    socket_client_main_t *socket_client_main;
-    char *socket_name;
+    socket_client_main_t socket_client_main;
+    vat_main_t vat_main;
+    u8 **sw_if_name_by_index;
+    vpp_hw_interface_t *hw_if_table;
+    uword *msg_index_by_name_and_crc;
+    char socket_name[256];
+    char stats_socket_name[256];
     u32 my_client_index;
+    u16 interface_msg_id_base;
+    u16 ip_msg_id_base;
+    u16 ip_nbr_msg_id_base;
+    u16 lcp_msg_id_base;
+    u16 punt_msg_id_base;
+    u16 tapv2_msg_id_base;
+    u16 vlib_msg_id_base;
+    int connected;
+    /* Message ids differ from the instance the handlers are registered for */
+    int msg_table_mismatch;
+    /* Second connection carrying only the interface events */
+    socket_client_main_t event_socket_client_main;
+    int events_connected;
 } vsclient_main_t;
 
+#define VSCLIENT_MAX 16
+
+static vsclient_main_t vsclient_table[VSCLIENT_MAX];
+static u32 vsclient_count;
+static vsclient_main_t *vsc_current;
+/* Instance whose message ids the reply handlers are registered with */
+static vsclient_main_t *vsc_msg_table_owner;
+static int vpp_process_init;
+
+static void vsc_save (vsclient_main_t *vsc)
+{
+    api_main_t *am = vlibapi_get_main ();
+
+    vsc->socket_client_main = socket_client_main;
+    vsc->vat_main = vat_main;
+    vsc->sw_if_name_by_index = sw_if_name_by_index;
+    vsc->hw_if_table = hw_if_table;
+    vsc->msg_index_by_name_and_crc = am->msg_index_by_name_and_crc;
+    vsc->interface_msg_id_base = interface_msg_id_base;
+    vsc->ip_msg_id_base = ip_msg_id_base;
+    vsc->ip_nbr_msg_id_base = ip_nbr_msg_id_base;
+    vsc->lcp_msg_id_base = lcp_msg_id_base;
+    vsc->punt_msg_id_base = punt_msg_id_base;
+    vsc->tapv2_msg_id_base = tapv2_msg_id_base;
+    vsc->vlib_msg_id_base = vlib_msg_id_base;
+}
+
+static void vsc_load (vsclient_main_t *vsc)
+{
+    api_main_t *am = vlibapi_get_main ();
+
+    socket_client_main = vsc->socket_client_main;
+    vat_main = vsc->vat_main;
+    sw_if_name_by_index = vsc->sw_if_name_by_index;
+    hw_if_table = vsc->hw_if_table;
+    interface_msg_id_base = vsc->interface_msg_id_base;
+    ip_msg_id_base = vsc->ip_msg_id_base;
+    ip_nbr_msg_id_base = vsc->ip_nbr_msg_id_base;
+    lcp_msg_id_base = vsc->lcp_msg_id_base;
+    punt_msg_id_base = vsc->punt_msg_id_base;
+    tapv2_msg_id_base = vsc->tapv2_msg_id_base;
+    vlib_msg_id_base = vsc->vlib_msg_id_base;
+
+    /*
+     * A new instance gets its own name table so that connecting it never
+     * rewrites the table of another instance.
+     */
+    if (vsc->msg_index_by_name_and_crc == NULL) {
+        vsc->msg_index_by_name_and_crc = hash_create_string (0, sizeof (uword));
+    }
+    am->msg_index_by_name_and_crc = vsc->msg_index_by_name_and_crc;
+
+    if (vsc->connected) {
+        vat_main.socket_client_main = &socket_client_main;
+        am->my_client_index = vsc->my_client_index;
+    }
+}
+
+static int vsc_msg_ids_match (vsclient_main_t *vsc)
+{
+    return vsc->interface_msg_id_base == interface_msg_id_base &&
+        vsc->ip_msg_id_base == ip_msg_id_base &&
+        vsc->ip_nbr_msg_id_base == ip_nbr_msg_id_base &&
+        vsc->lcp_msg_id_base == lcp_msg_id_base &&
+        vsc->punt_msg_id_base == punt_msg_id_base &&
+        vsc->tapv2_msg_id_base == tapv2_msg_id_base &&
+        vsc->vlib_msg_id_base == vlib_msg_id_base;
+}
+
+/*
+ * Makes the VPP instance behind api_socket the target of all following api
+ * and stats calls, connecting on the next init_vpp_client. NULL or "" select
+ * the default sockets.
+ */
+int vpp_client_select (const char *api_socket, const char *stats_socket)
+{
+    vsclient_main_t *vsc = NULL;
+    u32 i;
+
+    if (api_socket == NULL || api_socket[0] == 0) {
+        api_socket = API_SOCKET_FILE;
+    }
+
+    for (i = 0; i < vsclient_count; i++) {
+        if (strcmp(vsclient_table[i].socket_name, api_socket) == 0) {
+            vsc = &vsclient_table[i];
+            break;
+        }
+    }
+
+    if (vsc == NULL) {
+        if (vsclient_count >= VSCLIENT_MAX) {
+            SAIVPP_ERROR("too many vpp instances, %s not selected", api_socket);
+            return -1;
+        }
+        vsc = &vsclient_table[vsclient_count++];
+        clib_memset(vsc, 0, sizeof(*vsc));
+        snprintf(vsc->socket_name, sizeof(vsc->socket_name), "%s", api_socket);
+    }
+
+    snprintf(vsc->stats_socket_name, sizeof(vsc->stats_socket_name), "%s",
+             stats_socket ? stats_socket : "");
+    vpp_stats_set_socket(vsc->stats_socket_name);
+
+    if (vsc != vsc_current) {
+        if (vsc_current) {
+            vsc_save(vsc_current);
+        }
+        vsc_current = vsc;
+        vsc_load(vsc);
+    }
+
+    return vsc->msg_table_mismatch ? -1 : 0;
+}
+
 int
 vsc_socket_connect (vat_main_t * vam)
 {
     int rv;
     api_main_t *am = vlibapi_get_main ();
     vam->socket_client_main = &socket_client_main;
-    if ((rv = vl_socket_client_connect ((char *) vam->socket_name,
+    if ((rv = vl_socket_client_connect (vsc_current->socket_name,
                                         "sonic_vpp_api_client",
                                         0 /* default socket rx, tx buffer */ )))
         return rv;
@@ -516,6 +960,7 @@ vsc_socket_connect (vat_main_t * vam)
     /* vpp expects the client index in network order */
     vam->my_client_index = htonl (socket_client_main.client_index);
     am->my_client_index = vam->my_client_index;
+    vsc_current->my_client_index = vam->my_client_index;
     return 0;
 }
 
@@ -530,24 +975,17 @@ api_sw_interface_dump (vat_main_t *vam)
 {
     vl_api_sw_interface_dump_t *mp;
     vl_api_control_ping_t *mp_ping;
-    hash_pair_t *p;
-    name_sort_t *nses = 0, *ns;
     sw_interface_subif_t *sub = NULL;
+    u8 **name;
     int ret;
 
-    /* Toss the old name table */
-    hash_foreach_pair (p, vam->sw_if_index_by_interface_name, ({
-                vec_add2 (nses, ns, 1);
-                ns->name = (u8 *) (p->key);
-                ns->value = (u32) p->value[0];
-            }));
-
+    /* Toss the old name table, its keys are all in sw_if_name_by_index */
     hash_free (vam->sw_if_index_by_interface_name);
 
-    vec_foreach (ns, nses)
-        vec_free (ns->name);
+    vec_foreach (name, sw_if_name_by_index)
+        vec_free (*name);
 
-    vec_free (nses);
+    vec_reset_length (sw_if_name_by_index);
 
     vec_foreach (sub, vam->sw_if_subif_table)
     {
@@ -555,6 +993,8 @@ api_sw_interface_dump (vat_main_t *vam)
     }
     vec_free (vam->sw_if_subif_table);
 
+    vec_reset_length (hw_if_table);
+
     /* recreate the interface name hash table */
     vam->sw_if_index_by_interface_name = hash_create_string (0, sizeof (uword));
     __plugin_msg_base = interface_msg_id_base;
@@ -615,20 +1055,6 @@ dump_interface_table (vat_main_t *vam)
     return 0;
 }
 
-static u32 get_swif_idx (vat_main_t *vam, const char *ifname)
-{
-    hash_pair_t *p;
-    u8 *name;
-    u32 value;
-
-    hash_foreach_pair (p, vam->sw_if_index_by_interface_name, ({
-                name = (u8 *) (p->key);
-                value = (u32) p->value[0];
-                if (strcmp((char *) name, ifname) == 0) return value;
-            }));
-    return ((u32) -1);
-}
-
 static int config_lcp_hostif (vat_main_t *vam, vl_api_interface_index_t if_idx, const char *hostif_name)
 {
     vl_api_lcp_itf_pair_add_del_t *mp;
@@ -647,6 +1073,94 @@ static int config_lcp_hostif (vat_main_t *vam, vl_api_interface_index_t if_idx,
     return ret;
 }
 
+static void __punt_to_api (const vpp_punt_t *punt, vl_api_punt_t *api_punt)
+{
+    if (punt->port) {
+	api_punt->type = htonl(PUNT_API_TYPE_L4);
+	api_punt->punt.l4.af = punt->is_ipv6 ? ADDRESS_IP6 : ADDRESS_IP4;
+	api_punt->punt.l4.protocol = punt->protocol;
+	api_punt->punt.l4.port = htons(punt->port);
+    } else {
+	api_punt->type = htonl(PUNT_API_TYPE_IP_PROTO);
+	api_punt->punt.ip_proto.af = punt->is_ipv6 ? ADDRESS_IP6 : ADDRESS_IP4;
+	api_punt->punt.ip_proto.protocol = punt->protocol;
+    }
+}
+
+static int __punt_socket_register (vat_main_t *vam, const vpp_punt_t *punt, const char *client_path)
+{
+    vl_api_punt_socket_register_t *mp;
+    int ret;
+
+    __plugin_msg_base = punt_msg_id_base;
+
+    M (PUNT_SOCKET_REGISTER, mp);
+    mp->header_version = htonl(1);
+    __punt_to_api(punt, &mp->punt);
+    strncpy((char *) mp->pathname, client_path, sizeof(mp->pathname) - 1);
+    S (mp);
+
+    W (ret);
+    return ret;
+}
+
+static int __punt_socket_deregister (vat_main_t *vam, const vpp_punt_t *punt)
+{
+    vl_api_punt_socket_deregister_t *mp;
+    int ret;
+
+    __plugin_msg_base = punt_msg_id_base;
+
+    M (PUNT_SOCKET_DEREGISTER, mp);
+    __punt_to_api(punt, &mp->punt);
+    S (mp);
+
+    W (ret);
+    return ret;
+}
+
+static int __tap_v2_dump (vat_main_t *vam, const char *host_if_name)
+{
+    vl_api_sw_interface_tap_v2_dump_t *mp;
+    vl_api_control_ping_t *mp_ping;
+    int ret;
+
+    clib_memset(&tap_lookup, 0, sizeof(tap_lookup));
+    tap_lookup.host_if_name = host_if_name;
+    tap_lookup.sw_if_index = ~0;
+
+    __plugin_msg_base = tapv2_msg_id_base;
+
+    M (SW_INTERFACE_TAP_V2_DUMP, mp);
+    mp->sw_if_index = htonl(~0);
+    S (mp);
+
+    __plugin_msg_base = memclnt_msg_id_base;
+
+    PING (NULL, mp_ping);
+    S (mp_ping);
+
+    W (ret);
+    tap_lookup.host_if_name = NULL;
+    return ret;
+}
+
+static int __cli_inband (vat_main_t *vam, const char *cmd)
+{
+    vl_api_cli_inband_t *mp;
+    u32 len = strlen(cmd);
+    int ret;
+
+    __plugin_msg_base = vlib_msg_id_base;
+
+    M2 (CLI_INBAND, mp, len);
+    vl_api_to_api_string(len, cmd, &mp->cmd);
+    S (mp);
+
+    W (ret);
+    return ret;
+}
+
 static int __create_sub_interface (vat_main_t *vam, vl_api_interface_index_t if_idx, u32 sub_id, u16 vlan_id)
 {
     vl_api_create_subif_t *mp;
@@ -682,38 +1196,122 @@ static int __delete_sub_interface (vat_main_t *vam, vl_api_interface_index_t if_
     return ret;
 }
 
-static __thread int vpp_client_init;
+/*
+ * Interface events are unsolicited, so they are subscribed on a connection of
+ * their own: on the command socket they would be read by W() in place of the
+ * reply it waits for. The event connection is polled before each use of the
+ * client and is never blocked on.
+ */
+static int vsc_events_connect (vsclient_main_t *vsc)
+{
+    socket_client_main_t *scm = &vsc->event_socket_client_main;
+    vl_api_want_interface_events_t *mp;
+
+    if (vl_socket_client_connect2 (scm, vsc->socket_name,
+                                   "sonic_vpp_event_client",
+                                   0 /* default socket rx, tx buffer */ ))
+        return -1;
+
+    mp = vl_socket_client_msg_alloc2 (scm, sizeof (*mp));
+    clib_memset (mp, 0, sizeof (*mp));
+    mp->_vl_msg_id = htons (INTERFACE_MSG_ID(WANT_INTERFACE_EVENTS));
+    mp->client_index = htonl (scm->client_index);
+    mp->enable_disable = htonl (1);
+    mp->pid = htonl (getpid ());
+
+    if (vl_socket_client_write2 (scm) <= 0) {
+        vl_socket_client_disconnect2 (scm);
+        return -1;
+    }
+
+    vsc->events_connected = 1;
+    return 0;
+}
+
+/* Dispatches the interface events received since the last poll */
+static void vsc_events_poll (vsclient_main_t *vsc)
+{
+    socket_client_main_t *scm = &vsc->event_socket_client_main;
+    struct pollfd pfd;
+
+    if (!vsc->events_connected) return;
+
+    pfd.fd = scm->socket_fd;
+    pfd.events = POLLIN;
+
+    while (poll (&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        /* No pings are outstanding here, so this returns after one message */
+        if (vl_socket_client_read2 (scm, 0) < 0) {
+            SAIVPP_WARN("interface event connection lost");
+            vl_socket_client_disconnect2 (scm);
+            vsc->events_connected = 0;
+            return;
+        }
+    }
+}
 
 int init_vpp_client()
 {
-    if (vpp_client_init) return 0;
-    
     vat_main_t *vam = &vat_main;
-    clib_mem_init_thread_safe(0, 128 << 20);
-    vlib_main_init();
+
+    if (vsc_current == NULL) {
+        vpp_client_select(NULL, NULL);
+    }
+    if (vsc_current->msg_table_mismatch) {
+        return -1;
+    }
+    if (vsc_current->connected) {
+        vsc_events_poll(vsc_current);
+        return 0;
+    }
+
+    if (!vpp_process_init) {
+        clib_mem_init_thread_safe(0, 128 << 20);
+        vlib_main_init();
+        /* Set up the plugin message ID allocator right now... */
+        vl_msg_api_set_first_available_msg_id (VL_MSG_MEMCLNT_LAST + 1);
+        vpp_base_vpe_init();
+        vpp_process_init = 1;
+    }
+
     clib_time_init (&vam->clib_time);
-    /* Set up the plugin message ID allocator right now... */
-    vl_msg_api_set_first_available_msg_id (VL_MSG_MEMCLNT_LAST + 1);
+    if (vam->sw_if_index_by_interface_name == NULL) {
+        vam->sw_if_index_by_interface_name = hash_create_string (0, sizeof (uword));
+    }
 
-    vpp_base_vpe_init();
-    vam->socket_name = format (0, "%s%c", API_SOCKET_FILE, 0);
-    vam->sw_if_index_by_interface_name = hash_create_string (0, sizeof (uword));
-    
     if (vsc_socket_connect(vam) == 0) {
         int rc;
 
         SAIVPP_DEBUG("vpp socket connect successful\n");
         get_base_msg_id();
-        vpp_ext_vpe_init();
-        vpp_plugin_vpe_init();
+        if (vsc_msg_table_owner == NULL) {
+            vpp_ext_vpe_init();
+            vpp_plugin_vpe_init();
+            vsc_msg_table_owner = vsc_current;
+            vsc_save(vsc_current);
+        } else if (!vsc_msg_ids_match(vsc_msg_table_owner)) {
+            SAIVPP_ERROR("vpp %s uses other message ids than %s, not supported",
+                         vsc_current->socket_name, vsc_msg_table_owner->socket_name);
+            vl_socket_client_disconnect();
+            vsc_current->msg_table_mismatch = 1;
+            return -1;
+        }
 
         rc = api_sw_interface_dump(vam);
         if (rc == 0) {
             SAIVPP_DEBUG("Interface dump available");
         }
         dump_interface_table(vam);
+
+        /*
+         * From here on the name table is maintained from create/delete
+         * replies and the interface delete events of the event connection.
+         */
+        if (vsc_events_connect(vsc_current) != 0) {
+            SAIVPP_WARN("Interface events registration failed");
+        }
         // vl_socket_client_disconnect();
-	vpp_client_init = 1;
+	vsc_current->connected = 1;
 	return 0;
     } else {
         SAIVPP_ERROR("vpp socket connect failed\n");
@@ -721,6 +1319,10 @@ int init_vpp_client()
     return -1;
 }
 
+/*
+ * Full resync of the interface name table, only needed for reconciliation.
+ * Interface changes made through this client keep the table up to date.
+ */
 int refresh_interfaces_list ()
 {
     vat_main_t *vam = &vat_main;
@@ -730,11 +1332,71 @@ int refresh_interfaces_list ()
     if (rc == 0) {
 	SAIVPP_DEBUG("Interface dump available");
     }
-    dump_interface_table(vam);
 
     return rc;
 }
 
+static int api_sw_interface_rx_placement_dump (vat_main_t *vam)
+{
+    vl_api_sw_interface_rx_placement_dump_t *mp;
+    vl_api_control_ping_t *mp_ping;
+    int ret;
+
+    __plugin_msg_base = interface_msg_id_base;
+
+    M (SW_INTERFACE_RX_PLACEMENT_DUMP, mp);
+    mp->sw_if_index = htonl(~0);
+    S (mp);
+
+    /* Use a control ping for synchronization */
+    __plugin_msg_base = memclnt_msg_id_base;
+
+    PING (NULL, mp_ping);
+    S (mp_ping);
+
+    W (ret);
+    return ret;
+}
+
+int hw_interfaces_dump (vpp_hw_interface_t *hwifs, uint32_t max_hwifs, uint32_t *num_hwifs)
+{
+    vat_main_t *vam = &vat_main;
+    vpp_hw_interface_t *hwif;
+    uint32_t count = 0;
+    int rc;
+
+    rc = api_sw_interface_dump(vam);
+    if (rc != 0) {
+	SAIVPP_ERROR("Interface dump failed(%d)\n", rc);
+	return rc;
+    }
+
+    rc = api_sw_interface_rx_placement_dump(vam);
+    if (rc != 0) {
+	SAIVPP_WARN("Interface rx placement dump failed(%d)\n", rc);
+    }
+
+    vec_foreach (hwif, hw_if_table)
+    {
+	if (count >= max_hwifs) break;
+
+	hwifs[count] = *hwif;
+
+	/*
+	 * VPP allocates one tx queue per thread on every hardware interface
+	 * and spreads rx queues over the same threads, so rx queue count is
+	 * the best available estimate of the tx side.
+	 */
+	if (hwifs[count].num_rx_queues == 0) hwifs[count].num_rx_queues = 1;
+	hwifs[count].num_tx_queues = hwifs[count].num_rx_queues;
+
+	count++;
+    }
+    *num_hwifs = count;
+
+    return 0;
+}
+
 int configure_lcp_interface (const char *hwif_name, const char *hostif_name)
 {
     u32 idx;
@@ -746,15 +1408,91 @@ int configure_lcp_interface (const char *hwif_name, const char *hostif_name)
     return config_lcp_hostif(vam, idx, hostif_name);
 }
 
+/*
+ * Enables GSO (which implies checksum offload) or checksum offload alone on
+ * the linux-cp host TAP of hostif_name. VPP negotiates TUNSETOFFLOAD with the
+ * kernel and handles the virtio-net header on every queue of the TAP.
+ */
+int lcp_host_tap_set_offload (const char *hostif_name, bool gso, bool csum_offload)
+{
+    vat_main_t *vam = &vat_main;
+    char cmd[128];
+    u32 want;
+    int ret;
+
+    if (!gso && !csum_offload) return 0;
+
+    ret = __tap_v2_dump(vam, hostif_name);
+    if (ret != 0) return ret;
+
+    if (tap_lookup.sw_if_index == (u32) ~0) {
+	SAIVPP_WARN("no host tap for %s", hostif_name);
+	return -1;
+    }
+
+    want = gso ? TAP_API_FLAG_GSO : TAP_API_FLAG_CSUM_OFFLOAD;
+    if ((tap_lookup.tap_flags & want) == want) return 0;
+
+    snprintf(cmd, sizeof(cmd), "set tap offload %s %s",
+	     tap_lookup.dev_name, gso ? "gso" : "csum-offload");
+    SAIVPP_DEBUG("%s\n", cmd);
+
+    return __cli_inband(vam, cmd);
+}
+
+int get_sw_if_index (const char *hwif_name, u32 *sw_if_index)
+{
+    vat_main_t *vam = &vat_main;
+
+    *sw_if_index = get_swif_idx(vam, hwif_name);
+
+    return (*sw_if_index == (u32) ~0) ? -1 : 0;
+}
+
+/*
+ * Has VPP send the packets matching punt to the unix datagram socket at
+ * client_path, each preceded by a vpp_punt_desc_t. server_path is set to
+ * the socket VPP reads injected packets from, which needs
+ * "punt { socket <path> }" in the VPP startup config.
+ */
+int punt_socket_register (const vpp_punt_t *punt, const char *client_path,
+			  char *server_path, size_t server_path_len)
+{
+    vat_main_t *vam = &vat_main;
+    int ret;
+
+    punt_server_path[0] = 0;
+
+    ret = __punt_socket_register(vam, punt, client_path);
+    if (ret == 0 && server_path && server_path_len) {
+	snprintf(server_path, server_path_len, "%s", punt_server_path);
+    }
+    return ret;
+}
+
+int punt_socket_deregister (const vpp_punt_t *punt)
+{
+    vat_main_t *vam = &vat_main;
+
+    return __punt_socket_deregister(vam, punt);
+}
+
 int create_sub_interface (const char *hwif_name, u32 sub_id, u16 vlan_id)
 {
     u32 idx;
     vat_main_t *vam = &vat_main;
-    
+    char tmpbuf[64];
+    int ret;
+
     idx = get_swif_idx(vam, hwif_name);
     SAIVPP_DEBUG("swif index of interface %s is %u\n", hwif_name, idx);
 
-    return __create_sub_interface(vam, idx, sub_id, vlan_id);
+    ret = __create_sub_interface(vam, idx, sub_id, vlan_id);
+    if (ret == 0 && created_subif_sw_if_index != (u32) ~0) {
+	snprintf(tmpbuf, sizeof(tmpbuf), "%s.%u", hwif_name, sub_id);
+	set_swif_idx(vam, tmpbuf, created_subif_sw_if_index);
+    }
+    return ret;
 }
 
 int delete_sub_interface (const char *hwif_name, u32 sub_id)
@@ -762,11 +1500,17 @@ int delete_sub_interface (const char *hwif_name, u32 sub_id)
     u32 idx;
     vat_main_t *vam = &vat_main;
     char tmpbuf[64];
+    int ret;
 
     snprintf(tmpbuf, sizeof(tmpbuf), "%s.%u", hwif_name, sub_id);
     idx = get_swif_idx(vam, tmpbuf);
     SAIVPP_DEBUG("swif index of interface %s is %u\n", tmpbuf, idx);
-    return __delete_sub_interface(vam, idx);
+
+    ret = __delete_sub_interface(vam, idx);
+    if (ret == 0) {
+	clear_swif_idx(vam, idx);
+    }
+    return ret;
 }
 
 static int __set_interface_vrf (vat_main_t *vam, vl_api_interface_index_t if_idx,
@@ -804,6 +1548,149 @@ int set_interface_vrf (const char *hwif_name, u32 sub_id, u32 vrf_id, bool is_ip
     return __set_interface_vrf(vam, idx, vrf_id, is_ipv6);
 }
 
+/*
+ * Router interface batches are sent pipelined: all requests of a phase are
+ * written without waiting for their replies, and a single control ping at
+ * the end of the phase is used to collect them.
+ */
+static void rif_batch_begin (vat_main_t *vam, vpp_rif_config_t *rifs, u32 count)
+{
+    rif_batch = rifs;
+    rif_batch_len = count;
+
+    vam->async_mode = 1;
+    vam->async_errors = 0;
+}
+
+static int rif_batch_end (vat_main_t *vam)
+{
+    vl_api_control_ping_t *mp_ping;
+    int ret;
+
+    __plugin_msg_base = memclnt_msg_id_base;
+
+    PING (NULL, mp_ping);
+    S (mp_ping);
+
+    /* Reads replies until the control ping reply is received */
+    ret = vl_socket_client_read (5);
+
+    vam->async_mode = 0;
+    rif_batch = NULL;
+    rif_batch_len = 0;
+
+    if (ret < 0) return ret;
+
+    return vam->async_errors ? -1 : 0;
+}
+
+int create_sub_interfaces (vpp_rif_config_t *rifs, uint32_t count)
+{
+    vat_main_t *vam = &vat_main;
+    vl_api_create_subif_t *mp;
+    char tmpbuf[64];
+    u32 i, idx;
+    int ret;
+
+    rif_batch_begin(vam, rifs, count);
+
+    __plugin_msg_base = interface_msg_id_base;
+
+    for (i = 0; i < count; i++)
+    {
+	idx = get_swif_idx(vam, rifs[i].hwif_name);
+
+	rifs[i].retval = 0;
+	rifs[i].sw_if_index = idx;
+
+	if (idx == (u32) -1) {
+	    SAIVPP_ERROR("Unable to get sw_index for %s\n", rifs[i].hwif_name);
+	    rifs[i].retval = -EINVAL;
+	    continue;
+	}
+	if (rifs[i].vlan_id == 0) continue;
+
+	M (CREATE_SUBIF, mp);
+	mp->context = htonl(i);
+	mp->sw_if_index = htonl(idx);
+	mp->sub_id = htonl(rifs[i].vlan_id);
+	mp->outer_vlan_id = htons(rifs[i].vlan_id);
+	mp->sub_if_flags = htonl(SUB_IF_API_FLAG_EXACT_MATCH | SUB_IF_API_FLAG_ONE_TAG);
+	S (mp);
+    }
+
+    ret = rif_batch_end(vam);
+
+    /* New sub interfaces are known by the index in the reply, no dump needed */
+    for (i = 0; i < count; i++)
+    {
+	if (rifs[i].vlan_id == 0 || rifs[i].sw_if_index == (u32) -1) continue;
+
+	snprintf(tmpbuf, sizeof(tmpbuf), "%s.%u", rifs[i].hwif_name, rifs[i].vlan_id);
+
+	if (rifs[i].retval == 0) {
+	    set_swif_idx(vam, tmpbuf, rifs[i].sw_if_index);
+	    continue;
+	}
+
+	/* Sub interface left over in VPP, configure the existing one */
+	idx = get_swif_idx(vam, tmpbuf);
+	if (idx != (u32) -1) {
+	    rifs[i].retval = 0;
+	}
+	rifs[i].sw_if_index = idx;
+    }
+
+    return ret;
+}
+
+int configure_router_interfaces (vpp_rif_config_t *rifs, uint32_t count)
+{
+    vat_main_t *vam = &vat_main;
+    vl_api_sw_interface_set_table_t *mp_table;
+    vl_api_sw_interface_set_mtu_t *mp_mtu;
+    vl_api_sw_interface_set_flags_t *mp_flags;
+    u32 i;
+
+    rif_batch_begin(vam, rifs, count);
+
+    __plugin_msg_base = interface_msg_id_base;
+
+    for (i = 0; i < count; i++)
+    {
+	vpp_rif_config_t *rif = &rifs[i];
+
+	if (rif->retval != 0 || rif->sw_if_index == (u32) -1) continue;
+
+	if (rif->vrf_id) {
+	    /* ipv4 only, the ipv6 table is bound with the first ipv6 address */
+	    M (SW_INTERFACE_SET_TABLE, mp_table);
+	    mp_table->context = htonl(i);
+	    mp_table->sw_if_index = htonl(rif->sw_if_index);
+	    mp_table->vrf_id = htonl(rif->vrf_id);
+	    mp_table->is_ipv6 = false;
+	    S (mp_table);
+	}
+	if (rif->mtu) {
+	    M (SW_INTERFACE_SET_MTU, mp_mtu);
+	    mp_mtu->context = htonl(i);
+	    mp_mtu->sw_if_index = htonl(rif->sw_if_index);
+	    mp_mtu->mtu[MTU_PROTO_API_IP4] = htonl(rif->mtu);
+	    mp_mtu->mtu[MTU_PROTO_API_IP6] = htonl(rif->mtu);
+	    S (mp_mtu);
+	}
+	if (rif->admin_up >= 0) {
+	    M (SW_INTERFACE_SET_FLAGS, mp_flags);
+	    mp_flags->context = htonl(i);
+	    mp_flags->sw_if_index = htonl(rif->sw_if_index);
+	    mp_flags->flags = htonl ((rif->admin_up) ? IF_STATUS_API_FLAG_ADMIN_UP : 0);
+	    S (mp_flags);
+	}
+    }
+
+    return rif_batch_end(vam);
+}
+
 static int __ip_vrf_add_del (vat_main_t *vam, u32 vrf_id, const char *vrf_name, bool is_ipv6, bool is_add)
 {
     vl_api_ip_table_add_del_t *mp;
@@ -970,9 +1857,58 @@ int ip_route_add_del (vpp_ip_route_t *prefix, bool is_add)
     mp->is_add = is_add;
     mp->is_multipath = prefix->is_multipath;
 
+    route_stats_index = ~0;
+
+    S (mp);
+
+    W (ret);
+
+    prefix->stats_index = route_stats_index;
+
+    return ret;
+}
+
+/*
+ * Fills stats_index of the exact FIB entry of the prefix in its table
+ */
+int ip_route_lookup (vpp_ip_route_t *prefix)
+{
+    vat_main_t *vam = &vat_main;
+    vpp_ip_addr_t *addr;
+    vl_api_address_t *api_addr;
+    vl_api_ip_route_lookup_t *mp;
+    int ret;
+
+    __plugin_msg_base = ip_msg_id_base;
+
+    M (IP_ROUTE_LOOKUP, mp);
+
+    api_addr = &mp->prefix.address;
+    addr = &prefix->prefix_addr;
+
+    if (addr->sa_family == AF_INET) {
+	struct sockaddr_in *ip4 = &addr->addr.ip4;
+	api_addr->af = ADDRESS_IP4;
+	memcpy(api_addr->un.ip4, &ip4->sin_addr.s_addr, sizeof(api_addr->un.ip4));
+    } else if (addr->sa_family == AF_INET6) {
+	struct sockaddr_in6 *ip6 =  &addr->addr.ip6;
+	api_addr->af = ADDRESS_IP6;
+	memcpy(api_addr->un.ip6, &ip6->sin6_addr.s6_addr, sizeof(api_addr->un.ip6));
+    } else {
+	return -EINVAL;
+    }
+    mp->prefix.len = prefix->prefix_len;
+    mp->table_id = htonl(prefix->vrf_id);
+    mp->exact = 1;
+
+    route_stats_index = ~0;
+
     S (mp);
 
     W (ret);
+
+    prefix->stats_index = route_stats_index;
+
     return ret;
 }
 
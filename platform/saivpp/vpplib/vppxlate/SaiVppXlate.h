@@ -48,16 +48,62 @@ extern "C" {
 	unsigned int prefix_len;
         uint32_t vrf_id;
         bool is_multipath;
+        uint32_t stats_index;   /* filled by ip_route_add_del and ip_route_lookup, index in /net/route/to */
         unsigned int nexthop_cnt;
         vpp_ip_nexthop_t nexthop[0];
     } vpp_ip_route_t;
 
+    typedef struct vpp_hw_interface_ {
+        char hwif_name[64];
+        uint32_t sw_if_index;
+        uint32_t link_speed; /* kbps */
+        uint32_t link_mtu;
+        uint8_t l2_address[6];
+        uint32_t num_rx_queues;
+        uint32_t num_tx_queues;
+    } vpp_hw_interface_t;
+
+    typedef struct vpp_rif_config_ {
+        const char *hwif_name;  /* parent hardware interface */
+        uint16_t vlan_id;       /* sub interface id and outer vlan, 0 for the parent itself */
+        uint32_t vrf_id;        /* 0 keeps the default table, else ipv4 table */
+        uint32_t mtu;           /* 0 keeps the current mtu */
+        int admin_up;           /* -1 keeps the current admin state */
+        uint32_t sw_if_index;   /* filled by create_sub_interfaces */
+        int retval;             /* per interface status of the batch */
+    } vpp_rif_config_t;
+
+    /*
+     * A VPP punt of an UDP port, or of an IP protocol when port is 0.
+     */
+    typedef struct vpp_punt_ {
+        bool is_ipv6;
+        uint8_t protocol;
+        uint16_t port;
+    } vpp_punt_t;
+
+    /* Header of the packets on a VPP punt socket, both directions */
+    typedef struct __attribute__ ((packed)) vpp_punt_desc_ {
+        uint32_t sw_if_index;   /* rx interface when punted, tx or lookup interface when injected */
+        uint32_t action;        /* VPP_PUNT_ACTION_* of an injected packet */
+    } vpp_punt_desc_t;
+
+#define VPP_PUNT_ACTION_L2          0   /* transmit the frame on sw_if_index */
+#define VPP_PUNT_ACTION_IP4_ROUTED  1   /* ip4-lookup of the IP packet */
+#define VPP_PUNT_ACTION_IP6_ROUTED  2   /* ip6-lookup of the IP packet */
+
+    extern int vpp_client_select(const char *api_socket, const char *stats_socket);
     extern int init_vpp_client();
     extern int refresh_interfaces_list();
+    extern int hw_interfaces_dump(vpp_hw_interface_t *hwifs, uint32_t max_hwifs, uint32_t *num_hwifs);
     extern int configure_lcp_interface(const char *hwif_name, const char *hostif_name);
+    extern int lcp_host_tap_set_offload(const char *hostif_name, bool gso, bool csum_offload);
+    extern int get_sw_if_index(const char *hwif_name, uint32_t *sw_if_index);
     extern int create_sub_interface(const char *hwif_name, uint32_t sub_id, uint16_t vlan_id);
     extern int delete_sub_interface(const char *hwif_name, uint32_t sub_id);
     extern int set_interface_vrf(const char *hwif_name, uint32_t sub_id, uint32_t vrf_id, bool is_ipv6);
+    extern int create_sub_interfaces(vpp_rif_config_t *rifs, uint32_t count);
+    extern int configure_router_interfaces(vpp_rif_config_t *rifs, uint32_t count);
     extern int interface_ip_address_add_del(const char *hw_ifname, vpp_ip_route_t *prefix, bool is_add);
     extern int interface_set_state (const char *hwif_name, bool is_up);
     extern int hw_interface_set_mtu(const char *hwif_name, uint32_t mtu);
@@ -71,6 +117,11 @@ extern "C" {
     extern int ip6_nbr_add_del(const char *hwif_name, struct sockaddr_in6 *addr,
 			       bool is_static, uint8_t *mac, bool is_add);
     extern int ip_route_add_del(vpp_ip_route_t *prefix, bool is_add);
+    extern int ip_route_lookup(vpp_ip_route_t *prefix);
+
+    extern int punt_socket_register(const vpp_punt_t *punt, const char *client_path,
+                                    char *server_path, size_t server_path_len);
+    extern int punt_socket_deregister(const vpp_punt_t *punt);
 
 #ifdef __cplusplus
 }
@@ -92,6 +92,7 @@ cp $SONIC_SAIREDIS/saisdkdump/Makefile.am ./src/sonic-sairedis/saisdkdump/Makefi
 cp $SONIC_SAIREDIS/tests/Makefile.am ./src/sonic-sairedis/tests/Makefile.am
 cp $SONIC_SAIREDIS/unittest/Makefile.am ./src/sonic-sairedis/unittest/Makefile.am
 cp $SONIC_SAIREDIS/unittest/vslib/Makefile.am ./src/sonic-sairedis/unittest/vslib/Makefile.am
+cp $SONIC_SAIREDIS/unittest/vslib/TestMACsecFilter.cpp ./src/sonic-sairedis/unittest/vslib/TestMACsecFilter.cpp
 cp $SONIC_SAIREDIS/pyext/py3/Makefile.am ./src/sonic-sairedis/pyext/py3/Makefile.am
 
 # Linking error with saivpp. Disable mock_tests for swss for now. Fix it later